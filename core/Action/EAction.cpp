@@ -1,4 +1,5 @@
 #include "..\eactions.h"
+#include "..\enodes.h"
 #include "..\Win\winbase.h"
 
 e2d::EAction::EAction() :
@@ -8,8 +9,8 @@ e2d::EAction::EAction() :
 	m_pTarget(nullptr),
 	m_pParentScene(nullptr)
 {
-	// Ĭ϶ 15ms һ
-	setInterval(15);
+	// ʱΪ 0 ʱȫֵĶ
+	m_nAnimationInterval.QuadPart = 0;
 }
 
 e2d::EAction::~EAction()
@@ -34,7 +35,7 @@ void e2d::EAction::start()
 void e2d::EAction::resume()
 {
 	m_bRunning = true;
-	m_tLast = GetNow();
+	m_tLast.QuadPart = _getNow();
 }
 
 void e2d::EAction::pause()
@@ -82,7 +83,7 @@ void e2d::EAction::_init()
 {
 	m_bInit = true;
 	// ¼ǰʱ
-	m_tLast = GetNow();
+	m_tLast.QuadPart = _getNow();
 }
 
 void e2d::EAction::_update()
@@ -97,10 +98,15 @@ void e2d::EAction::_reset()
 {
 	m_bInit = false;
 	m_bEnding = false;
-	m_tLast = GetNow();
+	m_tLast.QuadPart = _getNow();
 }
 
 void e2d::EAction::_resetTime()
 {
-	m_tLast = GetNow();
+	m_tLast.QuadPart = _getNow();
+}
+
+LONGLONG e2d::EAction::_getNow()
+{
+	return m_pTarget ? m_pTarget->_getLocalTime() : GetNow().QuadPart;
 }
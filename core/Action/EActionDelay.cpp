@@ -20,7 +20,7 @@ void e2d::EActionDelay::_update()
 {
 	EAction::_update();
 	// жʱǷ㹻
-	if (IsIntervalFull(m_tLast, m_nAnimationInterval))
+	if (IsIntervalFull(_getNow(), m_tLast, m_nAnimationInterval))
 	{
 		this->stop();
 	}
@@ -17,7 +17,6 @@ void e2d::EActionGradual::_init()
 {
 	EAction::_init();
 }
-#include <iostream>
 bool e2d::EActionGradual::_isDelayEnough()
 {
 	// жʱǷ㹻
@@ -27,12 +26,14 @@ bool e2d::EActionGradual::_isDelayEnough()
 		return true;
 	}
 
-	if (IsIntervalFull(m_tLast, m_nAnimationInterval))
+	// δʱʱʹȫֵĶ
+	const LARGE_INTEGER & nInterval = m_nAnimationInterval.QuadPart ? m_nAnimationInterval : GetAnimationStep();
+
+	if (IsIntervalFull(_getNow(), m_tLast, nInterval))
 	{
 		// ¼¼ʱ
-		m_tLast.QuadPart += m_nAnimationInterval.QuadPart;
-		m_fDuration += static_cast<float>(ToMilliseconds(m_nAnimationInterval.QuadPart));
-		std::cout << ToMilliseconds(m_nAnimationInterval.QuadPart) << std::endl;
+		m_tLast.QuadPart += nInterval.QuadPart;
+		m_fDuration += ToMillisecondsFloat(nInterval.QuadPart);
 		// 㶯
 		m_fRateOfProgress = m_fDuration / m_fTotalDuration;
 		return true;
@@ -39,7 +39,8 @@ void e2d::EAnimation::_update()
 	}
 
 	// жʱǷ㹻
-	while (IsIntervalFull(m_tLast, m_nAnimationInterval))
+	LONGLONG nNow = _getNow();
+	while (IsIntervalFull(nNow, m_tLast, m_nAnimationInterval))
 	{
 		// ¼¼ʱ
 		m_tLast.QuadPart += m_nAnimationInterval.QuadPart;
@@ -4,6 +4,10 @@
 #include "..\enodes.h"
 #include "..\etransitions.h"
 #include "..\etools.h"
+#include "..\Win\WinFrameClock.h"
+#include "..\Win\RenderFrame.h"
+#include "..\Win\Renderer.h"
+#include "..\Tool\InputLog.h"
 #include <stack>
 #include <imm.h>
 #pragma comment (lib ,"imm32.lib")
@@ -17,6 +21,59 @@ static e2d::EApp * s_pInstance = nullptr;
 static std::stack<e2d::EScene*> s_SceneStack;
 // Ϸʼʱ
 static LARGE_INTEGER s_tStart;
+// ȴʱ
+static LONGLONG s_nIdleTime = 0;
+// ƻʱûͼ߳ʱɻͼ߳ۼ
+static volatile LONGLONG s_nRenderTime = 0;
+// ѻƵ֡ûͼ߳ʱɻͼ߳ۼ
+static volatile LONG s_nRenderedFrames = 0;
+// Ƶ֡
+static UINT32 s_nSkippedFrames = 0;
+// ֡ʿ
+static WinFrameClock s_FrameClock;
+static FramePacer s_FramePacer(&s_FrameClock);
+// ͼ߳
+static HANDLE s_hRenderThread = NULL;
+// ֪ͨͼ߳µ֡Ҫ˳
+static HANDLE s_hFrameEvent = NULL;
+// ͼ߳ǷҪ˳
+static volatile LONG s_bRenderThreadExit = 0;
+// ͼ̷߳ȾĿ궪ʧȴ߳ؽ
+static volatile LONG s_bDeviceLost = 0;
+// ͼ̻߳ʧ
+static volatile LONG s_bRenderFailed = 0;
+// ȾĿıţÿؽһ
+static volatile LONG s_nDeviceId = 0;
+// ȴͼ̵߳ȾĿСλʾҪ
+static volatile LONG s_nPendingSize = 0;
+// ̺߳ͻͼ߳̽֡
+static e2d::ERenderFrameQueue s_RenderFrames;
+// ¼
+static InputLog s_InputLog;
+// Ƿڼ¼
+static bool s_bRecording = false;
+// Ƿط
+static bool s_bReplaying = false;
+// طʱ֡߼ʱƽ
+static LONGLONG s_nReplayDelta = 0;
+// һ֡߼½ʱʱ䣬¼ʱ䶼
+static LARGE_INTEGER s_tLastFrame;
+// ַ֡Ϣ
+static std::vector<e2d::EInputEvent> s_vFrameEvents;
+// ͽһ֡ϢʱʹõĻ
+static std::vector<InputLog::Event> s_vLogEvents;
+
+
+// ¼еʱ任ΪǰʱƵµʱ
+static LONGLONG ToLocalTicks(LONGLONG nTicks)
+{
+	LONGLONG nFreq = s_InputLog.getFrequency();
+	if (nFreq == GetFreq().QuadPart)
+	{
+		return nTicks;
+	}
+	return static_cast<LONGLONG>(double(nTicks) * GetFreq().QuadPart / nFreq);
+}
 
 
 e2d::EApp::EApp()
@@ -29,6 +86,15 @@ e2d::EApp::EApp()
 	, m_pTransition(nullptr)
 	, m_pCurrentScene(nullptr)
 	, m_pNextScene(nullptr)
+	, m_bDirtyRectEnable(false)
+	, m_bDirtyRectVisiable(false)
+	, m_bFullRedrawNeeded(true)
+	, m_bRenderOnDemand(false)
+	, m_bRenderThread(false)
+	, m_nUpdateStep(0)
+	, m_nAccumulator(0)
+	, m_tLastStep()
+	, m_tLastUpdate()
 {
 	CoInitialize(NULL);
 
@@ -37,6 +103,7 @@ e2d::EApp::EApp()
 	QueryPerformanceFrequency(&tFreq);
 	// Ĭ֡Ϊ 60
 	m_nAnimationInterval.QuadPart = static_cast<LONGLONG>(1.0 / 60 * tFreq.QuadPart);
+	s_FramePacer.setInterval(m_nAnimationInterval.QuadPart);
 }
 
 e2d::EApp::~EApp()
@@ -182,62 +249,126 @@ int e2d::EApp::run()
 		SetWindowPos(GetHWnd(), HWND_TOPMOST, 0, 0, 0, 0, SWP_NOMOVE | SWP_NOSIZE);
 	}
 
-	// ʱ
-	LONG nWait = 0L;
-	// ʱ
-	LONGLONG nInterval;
-	// һ֡ʱ
-	LARGE_INTEGER tLast;
-	// ʱƵ
-	LARGE_INTEGER tFreq;
+	// ʼʱ
+	LARGE_INTEGER tWait;
+	// ʱ
+	LARGE_INTEGER tWake;
 
 	// ޸ʱ侫
 	timeBeginPeriod(1);
-	// ȡʱƵ
-	QueryPerformanceFrequency(&tFreq);
 	// ˢµǰʱ
 	QueryPerformanceCounter(&GetNow());
 	// ¼ʼʱ
 	s_tStart = GetNow();
-	tLast = GetNow();
+	// ӵǰʱ俪ʼ֡߼
+	s_FramePacer.reset();
+	pApp->m_tLastStep = GetNow();
+	pApp->m_tLastUpdate = GetNow();
+	pApp->m_nAccumulator = 0;
 	// Ϣ
 	MSG msg;
 
 	while (!pApp->m_bEnd)
 	{
+		// ֹͣͼ߳
+		bool bRenderThread = pApp->m_bRenderThread && !IsSoftwareRenderer();
+		if (bRenderThread != (s_hRenderThread != NULL))
+		{
+			if (bRenderThread)
+				pApp->_startRenderThread();
+			else
+				pApp->_stopRenderThread();
+		}
+
 		// Ϣ
+		bool bHasMessage = false;
 		while (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE))
 		{
 			TranslateMessage(&msg);
 			DispatchMessage(&msg);
+			bHasMessage = true;
 		}
 
-		// ˢµǰʱ
-		QueryPerformanceCounter(&GetNow());
-		// ʱ
-		nInterval = GetNow().QuadPart - tLast.QuadPart;
-		// жϼʱǷ㹻
-		if (nInterval >= pApp->m_nAnimationInterval.QuadPart)
-		{
-			// ¼ǰʱ
-			tLast.QuadPart += pApp->m_nAnimationInterval.QuadPart;
-			// Ϸ
-			pApp->_update();
+		// ˢµǰʱ䣬̶»طʱǰʱֻ߼ƽ
+		if (pApp->m_nUpdateStep == 0 && !s_bReplaying)
+		{
+			QueryPerformanceCounter(&GetNow());
+		}
+		// жǷһ֡ʱ
+		if (s_FramePacer.getRemaining() == 0)
+		{
+			UINT nUpdates = s_FramePacer.beginFrame();
+			// ÿ֡ǰͳһַյϢ
+			pApp->_dispatchMessages(pApp->m_nUpdateStep > 0);
+			if (pApp->m_nUpdateStep > 0)
+			{
+				// ̶Ϸ
+				pApp->_updateFixedStep();
+			}
+			else
+			{
+				// ʱ޶θϷݣطʱÿֻ֡һ
+				if (s_bReplaying)
+				{
+					nUpdates = 1;
+				}
+				for (UINT i = 0; i < nUpdates; i++)
+				{
+					pApp->_update();
+				}
+			}
+			pApp->_endFrame();
 			// ˢϷ
 			pApp->_render();
 		}
 		else
 		{
-			// ʱ
-			nWait = static_cast<LONG>(ToMilliseconds(pApp->m_nAnimationInterval.QuadPart - nInterval) - 1LL);
-			// ̣߳ͷ CPU ռ
-			if (nWait > 1L)
+			// մϢܸı˻棬ȵһ֡ƺٹ
+			if (pApp->m_bRenderOnDemand && !bHasMessage && !s_bRecording && !s_bReplaying)
 			{
-				Sleep(nWait);
+				// һ֮֡ǰûҪµʱֱյϢʱ
+				LONGLONG nDelay = pApp->_getNextUpdateDelay();
+				if (nDelay < 0 || nDelay > s_FramePacer.getRemaining())
+				{
+					// ǰһ߼µ״̬ٲֵ
+					if (pApp->m_nUpdateStep > 0 && pApp->m_pCurrentScene)
+					{
+						ENode::_saveTransforms(pApp->m_pCurrentScene->getRoot());
+						pApp->_render();
+					}
+
+					DWORD dwTimeout = nDelay < 0 ? INFINITE : static_cast<DWORD>(ToMilliseconds(nDelay) + 1LL);
+					QueryPerformanceCounter(&tWait);
+					MsgWaitForMultipleObjectsEx(0, NULL, dwTimeout, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+					QueryPerformanceCounter(&tWake);
+					s_nIdleTime += tWake.QuadPart - tWait.QuadPart;
+
+					if (pApp->m_nUpdateStep > 0)
+					{
+						// ڼûҪµݣֱƽ߼ʱ
+						GetNow().QuadPart += tWake.QuadPart - pApp->m_tLastStep.QuadPart;
+						pApp->m_tLastStep = tWake;
+					}
+					else
+					{
+						GetNow() = tWake;
+					}
+					// Ѻһ֡ʱ֡ʱͳ
+					s_FramePacer.reset();
+					continue;
+				}
 			}
+
+			// ȴһ֡ͷ CPU ռ
+			QueryPerformanceCounter(&tWait);
+			s_FramePacer.wait();
+			QueryPerformanceCounter(&tWake);
+			s_nIdleTime += tWake.QuadPart - tWait.QuadPart;
 		}
 	}
 
+	// ֹͣͼ߳
+	pApp->_stopRenderThread();
 	// رտ̨
 	EApp::showConsole(false);
 	// ʱ侫
@@ -246,6 +377,65 @@ int e2d::EApp::run()
 	return 0;
 }
 
+void e2d::EApp::initHeadless(UINT32 width, UINT32 height)
+{
+	EApp::getInstance();
+	// ûдڣܴ Direct2D ĴȾĿ
+	SetSoftwareRenderer(true);
+	GetRenderer()->resize(width, height);
+}
+
+e2d::EHeadlessStats e2d::EApp::runHeadless(UINT32 frames, float dt /* = 0 */, bool render /* = false */)
+{
+	EApp * pApp = EApp::getInstance();
+	EHeadlessStats stats;
+
+	// ÿ֡ʱǰļʱ
+	LONGLONG nStep = static_cast<LONGLONG>(dt * GetFreq().QuadPart);
+	if (nStep <= 0)
+	{
+		nStep = pApp->m_nUpdateStep > 0 ? pApp->m_nUpdateStep : pApp->m_nAnimationInterval.QuadPart;
+	}
+
+	// ʱӴӵǰʱ״ʱʵʱ俪ʼ
+	if (GetNow().QuadPart == 0)
+	{
+		QueryPerformanceCounter(&GetNow());
+		s_tStart = GetNow();
+	}
+	pApp->m_tLastUpdate = GetNow();
+	// ÿֻ֡һ߼ֱӻµ״̬
+	ENode::_setInterpolation(1.0f);
+	render = render && IsSoftwareRenderer();
+	pApp->m_bEnd = false;
+
+	LARGE_INTEGER tBegin, tEnd;
+	QueryPerformanceCounter(&tBegin);
+
+	while (stats.m_nFrames < frames && !pApp->m_bEnd)
+	{
+		GetNow().QuadPart += nStep;
+		pApp->_dispatchMessages(false);
+		pApp->_update();
+		pApp->_endFrame();
+		if (render)
+		{
+			pApp->_render();
+		}
+		stats.m_nFrames++;
+	}
+
+	QueryPerformanceCounter(&tEnd);
+
+	stats.m_fSimulatedTime = static_cast<float>(double(nStep) * stats.m_nFrames / GetFreq().QuadPart);
+	stats.m_fWallTime = static_cast<float>(double(tEnd.QuadPart - tBegin.QuadPart) / GetFreq().QuadPart);
+	if (stats.m_fWallTime > 0)
+	{
+		stats.m_fFramesPerSecond = stats.m_nFrames / stats.m_fWallTime;
+	}
+	return stats;
+}
+
 void e2d::EApp::pause()
 {
 	EApp::getInstance()->m_bManualPaused = true;
@@ -336,6 +526,10 @@ bool e2d::EApp::onCloseWindow()
 
 void e2d::EApp::_update()
 {
+	// ϴθ¾ʱ䣬Ϸͣڼʱ䱻
+	LONGLONG nDelta = max(GetNow().QuadPart - m_tLastUpdate.QuadPart, 0);
+	m_tLastUpdate = GetNow();
+
 	if (isPaused())
 	{
 		return;
@@ -367,38 +561,128 @@ void e2d::EApp::_update()
 	// Եǰǿ
 	ASSERT(m_pCurrentScene != nullptr, "Current scene NULL pointer exception.");
 
+	m_pCurrentScene->_advanceTime(nDelta);	// ƽʱ
 	EObjectManager::__flush();		// ˢڴ
 	ETimerManager::TimerProc();		// ʱִг
 	EActionManager::ActionProc();	// ִг
 }
 
-void e2d::EApp::_render()
+bool e2d::EApp::_render()
 {
 	HRESULT hr = S_OK;
+	// Ƿֻػ淢仯
+	bool bPartial = false;
+
+	if (s_hRenderThread)
+	{
+		if (s_bRenderFailed)
+		{
+			MessageBox(GetHWnd(), L"Game rendering failed!", L"Error", MB_OK);
+			this->quit();
+			return false;
+		}
+		_handleDeviceLost();
+	}
+
+	if ((m_bDirtyRectEnable || m_bRenderOnDemand) && m_pCurrentScene && !m_pTransition)
+	{
+		// 㻭з仯
+		m_pCurrentScene->_updateDirtyRects();
+		// һ֡ʾػ
+		for (auto iter = m_vDirtyRectOverlay.begin(); iter != m_vDirtyRectOverlay.end(); iter++)
+		{
+			m_pCurrentScene->_addDirtyRect(*iter);
+		}
+		m_vDirtyRectOverlay.clear();
+
+		// ûб仯ʱл
+		if (!m_bFullRedrawNeeded && m_pCurrentScene->m_vDirtyRects.empty())
+		{
+			s_nSkippedFrames++;
+			return false;
+		}
+		// ͼ߳̿м֡ÿ֡ػ
+		bPartial = m_bDirtyRectEnable && !m_bFullRedrawNeeded && !m_pCurrentScene->m_bGeometryVisiable && !s_hRenderThread;
+	}
+
+	if (s_hRenderThread)
+	{
+		_submitFrame();
+		return true;
+	}
+
+	// ¼ƿʼʱ
+	LARGE_INTEGER tBegin;
+	QueryPerformanceCounter(&tBegin);
 
 	// ʼͼ
-	GetRenderTarget()->BeginDraw();
-	// ʹñɫĻ
-	GetRenderTarget()->Clear(D2D1::ColorF(m_ClearColor));
-	// Ƶǰ
-	if (m_pCurrentScene)
+	GetRenderer()->beginDraw();
+
+	if (bPartial)
 	{
-		m_pCurrentScene->_render();
+		auto & rects = m_pCurrentScene->m_vDirtyRects;
+		for (auto iter = rects.begin(); iter != rects.end(); iter++)
+		{
+			// ֻػڻͼⱣһ֡Ļ
+			GetRenderer()->pushClip(*iter);
+			GetRenderer()->clear(m_ClearColor);
+			m_pCurrentScene->_render(&(*iter));
+			GetRenderer()->popClip();
+		}
+
+		// ʾػ
+		if (m_bDirtyRectVisiable)
+		{
+			for (auto iter = rects.begin(); iter != rects.end(); iter++)
+			{
+				GetRenderer()->fillRect(*iter, D2D1::ColorF::Red, 0.2f);
+				GetRenderer()->drawRect(
+					D2D1::RectF(iter->left + 0.5f, iter->top + 0.5f, iter->right - 0.5f, iter->bottom - 0.5f),
+					D2D1::ColorF::Red,
+					0.8f
+				);
+			}
+			m_vDirtyRectOverlay = rects;
+		}
 	}
-	// лʱͬʱ
-	if (m_pTransition && m_pNextScene)
+	else
 	{
-		m_pNextScene->_render();
+		// ʹñɫĻ
+		GetRenderer()->clear(m_ClearColor);
+		// Ƶǰ
+		if (m_pCurrentScene)
+		{
+			m_pCurrentScene->_render();
+		}
+		// лʱͬʱ
+		if (m_pTransition && m_pNextScene)
+		{
+			m_pNextScene->_render();
+		}
 	}
 	// ֹͼ
-	hr = GetRenderTarget()->EndDraw();
+	hr = GetRenderer()->endDraw();
+
+	if (m_pCurrentScene)
+	{
+		m_pCurrentScene->m_vDirtyRects.clear();
+	}
+	m_bFullRedrawNeeded = false;
+
+	// ͳƻƺʱ
+	LARGE_INTEGER tEnd;
+	QueryPerformanceCounter(&tEnd);
+	InterlockedExchangeAdd64(&s_nRenderTime, tEnd.QuadPart - tBegin.QuadPart);
+	InterlockedIncrement(&s_nRenderedFrames);
 
 	if (hr == D2DERR_RECREATE_TARGET)
 	{
 		//  Direct3D 豸ִйʧǰ豸Դ
 		// һεʱؽԴ
 		hr = S_OK;
+		ETexture::_discardBitmaps();
 		SafeReleaseInterface(&GetRenderTarget());
+		m_bFullRedrawNeeded = true;
 	}
 
 	if (FAILED(hr))
@@ -407,6 +691,7 @@ void e2d::EApp::_render()
 		MessageBox(GetHWnd(), L"Game rendering failed!", L"Error", MB_OK);
 		this->quit();
 	}
+	return true;
 }
 
 void e2d::EApp::setWindowSize(UINT32 width, UINT32 height)
@@ -442,17 +727,18 @@ e2d::EString e2d::EApp::getTitle()
 
 float e2d::EApp::getWidth()
 {
-	return GetRenderTarget()->GetSize().width;
+	return GetRenderer()->getSize().width;
 }
 
 float e2d::EApp::getHeight()
 {
-	return GetRenderTarget()->GetSize().height;
+	return GetRenderer()->getSize().height;
 }
 
 e2d::ESize e2d::EApp::getSize()
 {
-	return ESize(GetRenderTarget()->GetSize().width, GetRenderTarget()->GetSize().height);
+	D2D1_SIZE_F size = GetRenderer()->getSize();
+	return ESize(size.width, size.height);
 }
 
 void e2d::EApp::enterScene(EScene * scene, ETransition * transition /* = nullptr */, bool saveCurrentScene /* = true */)
@@ -525,6 +811,278 @@ void e2d::EApp::setFPS(UINT32 fps)
 	LARGE_INTEGER tFreq;
 	QueryPerformanceFrequency(&tFreq);
 	EApp::getInstance()->m_nAnimationInterval.QuadPart = static_cast<LONGLONG>(1.0 / fps * tFreq.QuadPart);
+	s_FramePacer.setInterval(EApp::getInstance()->m_nAnimationInterval.QuadPart);
+}
+
+void e2d::EApp::setDirtyRectEnable(bool enable)
+{
+	if (getInstance()->m_bDirtyRectEnable != enable)
+	{
+		getInstance()->m_bDirtyRectEnable = enable;
+		getInstance()->m_bFullRedrawNeeded = true;
+		getInstance()->m_vDirtyRectOverlay.clear();
+	}
+}
+
+bool e2d::EApp::isDirtyRectEnable()
+{
+	return getInstance()->m_bDirtyRectEnable;
+}
+
+void e2d::EApp::setDirtyRectVisiable(bool visiable)
+{
+	getInstance()->m_bDirtyRectVisiable = visiable;
+}
+
+void e2d::EApp::setRenderOnDemand(bool enable)
+{
+	getInstance()->m_bRenderOnDemand = enable;
+	getInstance()->m_bFullRedrawNeeded = true;
+}
+
+bool e2d::EApp::isRenderOnDemand()
+{
+	return getInstance()->m_bRenderOnDemand;
+}
+
+LONGLONG e2d::EApp::getIdleDuration()
+{
+	return ToMilliseconds(s_nIdleTime);
+}
+
+LONGLONG e2d::EApp::getRenderDuration()
+{
+	// 32 λ 64 λĶȡԭӵ
+	return ToMilliseconds(InterlockedCompareExchange64(&s_nRenderTime, 0, 0));
+}
+
+UINT32 e2d::EApp::getRenderedFrames()
+{
+	return static_cast<UINT32>(InterlockedCompareExchange(&s_nRenderedFrames, 0, 0));
+}
+
+UINT32 e2d::EApp::getSkippedFrames()
+{
+	return s_nSkippedFrames;
+}
+
+void e2d::EApp::setRenderThreadEnable(bool enable)
+{
+	// ͼ̹߳߳ Direct2D ԴҪʹö̵߳ Direct2D 
+	if (enable && !SetFactoryMultiThreaded(true))
+	{
+		WARN_IF(true, "EApp::setRenderThreadEnable(true) must be called before EApp::init!");
+		return;
+	}
+	// ͼ߳һ֡ʼǰֹͣ
+	getInstance()->m_bRenderThread = enable;
+}
+
+bool e2d::EApp::isRenderThreadEnable()
+{
+	return getInstance()->m_bRenderThread;
+}
+
+void e2d::EApp::setRenderMode(RENDER_MODE mode)
+{
+	if ((mode == RENDER_SOFTWARE) == IsSoftwareRenderer())
+		return;
+
+	// ͼ߳һ֡ʼǰֹͣ
+	SetSoftwareRenderer(mode == RENDER_SOFTWARE);
+	getInstance()->m_bFullRedrawNeeded = true;
+}
+
+e2d::EApp::RENDER_MODE e2d::EApp::getRenderMode()
+{
+	return IsSoftwareRenderer() ? RENDER_SOFTWARE : RENDER_DIRECT2D;
+}
+
+bool e2d::EApp::getFramePixels(std::vector<UINT32> & pixels, UINT32 & width, UINT32 & height)
+{
+	ESoftwareRenderer * pRenderer = GetSoftwareRenderer();
+	if (!pRenderer)
+		return false;
+
+	const SoftRaster & raster = pRenderer->getRaster();
+	width = raster.getWidth();
+	height = raster.getHeight();
+	pixels.assign(raster.getPixels(), raster.getPixels() + size_t(width) * height);
+	return true;
+}
+
+size_t e2d::EApp::compareFramePixels(const std::vector<UINT32> & reference, UINT32 tolerance /* = 0 */)
+{
+	ESoftwareRenderer * pRenderer = GetSoftwareRenderer();
+	if (!pRenderer)
+		return reference.size();
+
+	const SoftRaster & raster = pRenderer->getRaster();
+	size_t count = size_t(raster.getWidth()) * raster.getHeight();
+	if (count != reference.size() || count == 0)
+		return max(count, reference.size());
+
+	return SoftRaster::compare(raster.getPixels(), &reference[0], count, tolerance);
+}
+
+void e2d::EApp::setUpdateRate(UINT32 rate)
+{
+	EApp * pApp = getInstance();
+	if (rate == 0)
+	{
+		pApp->m_nUpdateStep = 0;
+		SetInterval(GetAnimationStep(), 15LL);
+		ENode::_setInterpolation(1);
+	}
+	else
+	{
+		rate = min(rate, 1000);
+		pApp->m_nUpdateStep = GetFreq().QuadPart / rate;
+		pApp->m_nAccumulator = 0;
+		QueryPerformanceCounter(&pApp->m_tLastStep);
+		// ͳлÿθƽһ
+		GetAnimationStep().QuadPart = pApp->m_nUpdateStep;
+	}
+}
+
+UINT32 e2d::EApp::getUpdateRate()
+{
+	LONGLONG nStep = getInstance()->m_nUpdateStep;
+	return nStep ? static_cast<UINT32>(GetFreq().QuadPart / nStep) : 0;
+}
+
+void e2d::EApp::setFrameWaitMode(FRAME_WAIT mode)
+{
+	s_FramePacer.setWaitMode(mode == WAITABLE_TIMER ? FramePacer::WAIT_TIMER : FramePacer::WAIT_SLEEP_SPIN);
+}
+
+void e2d::EApp::setFrameCatchUpLimit(UINT32 frames)
+{
+	s_FramePacer.setCatchUpLimit(frames);
+}
+
+e2d::EFrameStats e2d::EApp::getFrameStats()
+{
+	FramePacer::Stats stats;
+	s_FramePacer.getStats(stats);
+
+	EFrameStats result;
+	result.m_nFrames = stats.frames;
+	result.m_fAverage = static_cast<float>(stats.average);
+	result.m_fMin = static_cast<float>(stats.minimum);
+	result.m_fMax = static_cast<float>(stats.maximum);
+	result.m_fJitter = static_cast<float>(stats.jitter);
+	return result;
+}
+
+float e2d::EApp::getFrameTimePercentile(float percent)
+{
+	return static_cast<float>(s_FramePacer.getPercentile(percent));
+}
+
+std::vector<UINT32> e2d::EApp::getFrameTimeHistogram()
+{
+	const unsigned int * histogram = s_FramePacer.getHistogram();
+	return std::vector<UINT32>(histogram, histogram + FramePacer::BUCKET_COUNT);
+}
+
+void e2d::EApp::clearFrameStats()
+{
+	s_FramePacer.clearStats();
+}
+
+void e2d::EApp::startRecording()
+{
+	EApp::stopReplay();
+
+	s_InputLog.reset(GetFreq().QuadPart);
+	s_vFrameEvents.clear();
+	s_tLastFrame = GetNow();
+	s_bRecording = true;
+}
+
+bool e2d::EApp::stopRecording(const EString & fileName)
+{
+	if (!s_bRecording)
+		return false;
+
+	s_bRecording = false;
+
+	const std::vector<unsigned char> & data = s_InputLog.getData();
+	HANDLE hFile = ::CreateFileW(fileName, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+	{
+		WARN_IF(true, "Save input recording failed!");
+		return false;
+	}
+
+	DWORD written = 0;
+	bool succeeded = ::WriteFile(hFile, &data[0], static_cast<DWORD>(data.size()), &written, NULL) && written == data.size();
+	::CloseHandle(hFile);
+	WARN_IF(!succeeded, "Save input recording failed!");
+	return succeeded;
+}
+
+bool e2d::EApp::isRecording()
+{
+	return s_bRecording;
+}
+
+bool e2d::EApp::startReplay(const EString & fileName)
+{
+	EApp * pApp = EApp::getInstance();
+	s_bRecording = false;
+	s_bReplaying = false;
+
+	HANDLE hFile = ::CreateFileW(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+	{
+		WARN_IF(true, "Open input recording failed!");
+		return false;
+	}
+
+	std::vector<unsigned char> data;
+	LARGE_INTEGER fileSize;
+	bool succeeded = ::GetFileSizeEx(hFile, &fileSize) && fileSize.QuadPart > 0 && fileSize.QuadPart <= MAXDWORD;
+	if (succeeded)
+	{
+		DWORD read = 0;
+		data.resize(static_cast<size_t>(fileSize.QuadPart));
+		succeeded = ::ReadFile(hFile, &data[0], static_cast<DWORD>(data.size()), &read, NULL) && read == data.size();
+	}
+	::CloseHandle(hFile);
+
+	if (!succeeded || !s_InputLog.load(&data[0], data.size()))
+	{
+		WARN_IF(true, "Invalid input recording!");
+		return false;
+	}
+
+	// طŴӵǰ߼ʱ俪ʼ̶ʱδĵʱ
+	s_tLastFrame = GetNow();
+	pApp->m_nAccumulator = 0;
+	s_bReplaying = true;
+	return true;
+}
+
+void e2d::EApp::stopReplay()
+{
+	if (!s_bReplaying)
+		return;
+
+	s_bReplaying = false;
+	s_InputLog.reset(GetFreq().QuadPart);
+
+	// ߼ʱʵʱ䲻ָͬǰüʱ
+	EApp * pApp = EApp::getInstance();
+	pApp->_updateTime();
+	pApp->m_tLastUpdate = GetNow();
+	QueryPerformanceCounter(&pApp->m_tLastStep);
+}
+
+bool e2d::EApp::isReplaying()
+{
+	return s_bReplaying;
 }
 
 e2d::EScene * e2d::EApp::getCurrentScene()
@@ -547,6 +1105,7 @@ e2d::EString e2d::EApp::getAppName()
 void e2d::EApp::setBkColor(UINT32 color)
 {
 	getInstance()->m_ClearColor = color;
+	getInstance()->m_bFullRedrawNeeded = true;
 }
 
 void e2d::EApp::setKeyboardLayoutEnable(bool value)
@@ -582,7 +1141,7 @@ e2d::EWindowStyle e2d::EApp::getWindowStyle()
 
 LONGLONG e2d::EApp::getTotalDurationFromStart()
 {
-	return (s_tStart.QuadPart - GetNow().QuadPart) * 1000LL / GetFreq().QuadPart;
+	return (GetNow().QuadPart - s_tStart.QuadPart) * 1000LL / GetFreq().QuadPart;
 }
 
 void e2d::EApp::hideWindow()
@@ -621,17 +1180,296 @@ void e2d::EApp::_enterNextScene()
 
 	m_pCurrentScene = m_pNextScene;		// л
 	m_pNextScene = nullptr;				// һÿ
+	m_bFullRedrawNeeded = true;			// ػ
+}
+
+LONGLONG e2d::EApp::_getNextUpdateDelay()
+{
+	// ͣʱֻӦϢ
+	if (isPaused())
+	{
+		return -1;
+	}
+	// лִжʱҪ֡
+	if (m_pTransition || m_pNextScene || EActionManager::_hasRunningActions())
+	{
+		return 0;
+	}
+	return ETimerManager::_getNextTimerDelay();
+}
+
+void e2d::EApp::_dispatchMessages(bool bFixedStep)
+{
+	if (s_bReplaying)
+	{
+		// ʵյϢɼ¼б֡Ϣ
+		EMsgManager::_clearMessages();
+
+		LONGLONG nDelta;
+		if (s_InputLog.readFrame(nDelta, s_vLogEvents))
+		{
+			for (auto iter = s_vLogEvents.begin(); iter != s_vLogEvents.end(); iter++)
+			{
+				EInputEvent event;
+				event.m_nMsg = iter->message;
+				event.m_wParam = static_cast<WPARAM>(iter->wParam);
+				event.m_lParam = static_cast<LPARAM>(iter->lParam);
+				event.m_nTime = s_tLastFrame.QuadPart + ToLocalTicks(iter->time);
+				event.m_nCount = iter->count;
+				EMsgManager::_postMessage(event);
+			}
+
+			s_nReplayDelta = ToLocalTicks(nDelta);
+			if (!bFixedStep)
+			{
+				GetNow().QuadPart = s_tLastFrame.QuadPart + s_nReplayDelta;
+			}
+		}
+		else
+		{
+			// ¼ȫط
+			EApp::stopReplay();
+		}
+	}
+	else if (s_bRecording)
+	{
+		EMsgManager::_getMessages(s_vFrameEvents);
+	}
+
+	// ִглʱҲҪ°״̬лڼ̧İһֱڰ״̬
+	EMsgManager::_updateKeyStates();
+
+	// ִглʱΰϢ
+	if (m_pTransition || m_pNextScene)
+	{
+		EMsgManager::_clearMessages();
+	}
+	else
+	{
+		EMsgManager::_dispatchMessages();
+	}
+}
+
+void e2d::EApp::_endFrame()
+{
+	if (s_bRecording)
+	{
+		s_vLogEvents.clear();
+		for (auto iter = s_vFrameEvents.begin(); iter != s_vFrameEvents.end(); iter++)
+		{
+			InputLog::Event event;
+			event.message = iter->m_nMsg;
+			event.wParam = iter->m_wParam;
+			event.lParam = iter->m_lParam;
+			event.time = iter->m_nTime - s_tLastFrame.QuadPart;
+			event.count = iter->m_nCount;
+			s_vLogEvents.push_back(event);
+		}
+		s_vFrameEvents.clear();
+
+		s_InputLog.addFrame(
+			GetNow().QuadPart - s_tLastFrame.QuadPart,
+			s_vLogEvents.empty() ? nullptr : &s_vLogEvents[0],
+			s_vLogEvents.size()
+		);
+	}
+	s_tLastFrame = GetNow();
+}
+
+void e2d::EApp::_updateFixedStep()
+{
+	LARGE_INTEGER tNow;
+	QueryPerformanceCounter(&tNow);
+	// ۼƾϴθ¾ʱ䣬طʱ¼ƽۼ
+	m_nAccumulator += s_bReplaying ? s_nReplayDelta : tNow.QuadPart - m_tLastStep.QuadPart;
+	m_tLastStep = tNow;
+
+	// ÿ֡ĸ´ʱʱ䣬Խ׷Խ
+	LONGLONG nMaxSteps = (s_FramePacer.getInterval() / m_nUpdateStep + 1) * (s_FramePacer.getCatchUpLimit() + 1);
+	if (m_nAccumulator > nMaxSteps * m_nUpdateStep)
+	{
+		m_nAccumulator = nMaxSteps * m_nUpdateStep;
+	}
+
+	LONGLONG nSteps = m_nAccumulator / m_nUpdateStep;
+	for (LONGLONG i = 0; i < nSteps; i++)
+	{
+		// һθǰڵı任ʱθµ״ֵ̬֮
+		if (i == nSteps - 1 && m_pCurrentScene)
+		{
+			ENode::_saveTransforms(m_pCurrentScene->getRoot());
+		}
+		GetNow().QuadPart += m_nUpdateStep;
+		_update();
+	}
+	m_nAccumulator -= nSteps * m_nUpdateStep;
+
+	// ʣʱֵ
+	ENode::_setInterpolation(static_cast<float>(m_nAccumulator) / m_nUpdateStep);
 }
 
 void e2d::EApp::_updateTime()
 {
-	// ˢµǰʱ
-	QueryPerformanceCounter(&GetNow());
+	// ˢµǰʱ䣬̶ʱǰʱֻ߼ƽ
+	if (m_nUpdateStep == 0)
+	{
+		QueryPerformanceCounter(&GetNow());
+	}
 	// öͶʱ
 	EActionManager::_resetAllActions();
 	ETimerManager::_resetAllTimers();
 }
 
+void e2d::EApp::_startRenderThread()
+{
+	if (s_hRenderThread)
+		return;
+
+	s_bRenderThreadExit = 0;
+	s_bRenderFailed = 0;
+	s_hFrameEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+	if (s_hFrameEvent)
+	{
+		s_hRenderThread = CreateThread(NULL, 0, EApp::_renderThreadProc, NULL, 0, NULL);
+	}
+
+	if (!s_hRenderThread)
+	{
+		WARN_IF(true, "Create render thread failed!");
+		if (s_hFrameEvent)
+		{
+			CloseHandle(s_hFrameEvent);
+			s_hFrameEvent = NULL;
+		}
+		// ߳л
+		m_bRenderThread = false;
+		return;
+	}
+	m_bFullRedrawNeeded = true;
+}
+
+void e2d::EApp::_stopRenderThread()
+{
+	if (!s_hRenderThread)
+		return;
+
+	InterlockedExchange(&s_bRenderThreadExit, 1);
+	SetEvent(s_hFrameEvent);
+	// ͼ߳ʾʱ򴰿ڷϢȴʱ账ЩϢ
+	MSG msg;
+	while (MsgWaitForMultipleObjects(1, &s_hRenderThread, FALSE, INFINITE, QS_SENDMESSAGE) == WAIT_OBJECT_0 + 1)
+	{
+		PeekMessage(&msg, NULL, 0, 0, PM_NOREMOVE);
+	}
+	CloseHandle(s_hRenderThread);
+	CloseHandle(s_hFrameEvent);
+	s_hRenderThread = NULL;
+	s_hFrameEvent = NULL;
+
+	// ͷŻδƵ֡ĽڵԴ
+	s_RenderFrames.clear();
+	_handleDeviceLost();
+
+	// ͼ̻߳δȾĿС
+	LONG nSize = InterlockedExchange(&s_nPendingSize, 0);
+	if (nSize)
+	{
+		GetRenderTarget()->Resize(D2D1::SizeU((nSize >> 16) & 0x7FFF, nSize & 0xFFFF));
+	}
+	m_bFullRedrawNeeded = true;
+}
+
+void e2d::EApp::_submitFrame()
+{
+	ERenderFrame * pFrame = s_RenderFrames.getWriteFrame();
+	pFrame->m_nClearColor = m_ClearColor;
+	pFrame->m_nDevice = s_nDeviceId;
+
+	// ¼ǰ
+	if (m_pCurrentScene)
+	{
+		m_pCurrentScene->_snapshot(*pFrame);
+		m_pCurrentScene->m_vDirtyRects.clear();
+	}
+	// лʱͬʱ¼
+	if (m_pTransition && m_pNextScene)
+	{
+		m_pNextScene->_snapshot(*pFrame);
+	}
+	m_bFullRedrawNeeded = false;
+
+	// һύ֡δʱΪ
+	if (!s_RenderFrames.publish())
+	{
+		s_nSkippedFrames++;
+	}
+	SetEvent(s_hFrameEvent);
+}
+
+void e2d::EApp::_handleDeviceLost()
+{
+	if (!s_bDeviceLost)
+		return;
+
+	// ͼ̷߳ȾĿ궪ʧʹﶪ豸Դؽ
+	ETexture::_discardBitmaps();
+	SafeReleaseInterface(&GetSolidColorBrush());
+	SafeReleaseInterface(&GetRenderTarget());
+	GetRenderTarget();
+	// ֮ǰ¼֡õλͼھɵȾĿ
+	InterlockedIncrement(&s_nDeviceId);
+	InterlockedExchange(&s_bDeviceLost, 0);
+	m_bFullRedrawNeeded = true;
+}
+
+DWORD WINAPI e2d::EApp::_renderThreadProc(LPVOID lpParam)
+{
+	while (WaitForSingleObject(s_hFrameEvent, INFINITE) == WAIT_OBJECT_0 && !s_bRenderThreadExit)
+	{
+		// ȾĿ궪ʧʧܺ󣬵ȴ̴߳
+		if (s_bDeviceLost || s_bRenderFailed)
+			continue;
+
+		// ֻµ֡
+		ERenderFrame * pFrame = s_RenderFrames.acquire();
+		if (!pFrame || pFrame->m_nDevice != s_nDeviceId)
+			continue;
+
+		// ֮֡ȾĿС
+		LONG nSize = InterlockedExchange(&s_nPendingSize, 0);
+		if (nSize)
+		{
+			GetRenderTarget()->Resize(D2D1::SizeU((nSize >> 16) & 0x7FFF, nSize & 0xFFFF));
+		}
+
+		LARGE_INTEGER tBegin;
+		QueryPerformanceCounter(&tBegin);
+
+		GetRenderTarget()->BeginDraw();
+		GetRenderTarget()->Clear(D2D1::ColorF(pFrame->m_nClearColor));
+		for (size_t i = 0; i < pFrame->getCount(); i++)
+		{
+			ENode::_renderItem(pFrame->getItem(i));
+		}
+		HRESULT hr = GetRenderTarget()->EndDraw();
+
+		LARGE_INTEGER tEnd;
+		QueryPerformanceCounter(&tEnd);
+		InterlockedExchangeAdd64(&s_nRenderTime, tEnd.QuadPart - tBegin.QuadPart);
+		InterlockedIncrement(&s_nRenderedFrames);
+
+		if (hr == D2DERR_RECREATE_TARGET)
+		{
+			InterlockedExchange(&s_bDeviceLost, 1);
+		}
+		else if (FAILED(hr))
+		{
+			InterlockedExchange(&s_bRenderFailed, 1);
+		}
+	}
+	return 0;
+}
+
 LRESULT e2d::EApp::WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 {
 	if (s_pInstance == nullptr)
@@ -657,11 +1495,8 @@ LRESULT e2d::EApp::WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam
 		case WM_MOUSEMOVE:
 		case WM_MOUSEWHEEL:
 		{
-			// ִглʱΰϢ
-			if (!s_pInstance->m_pTransition && !s_pInstance->m_pNextScene)
-			{
-				EMsgManager::MouseProc(message, wParam, lParam);
-			}
+			// ִглʱϢڷַʱ
+			EMsgManager::_postMessage(message, wParam, lParam);
 		}
 		result = 0;
 		break;
@@ -670,11 +1505,8 @@ LRESULT e2d::EApp::WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam
 		case WM_KEYDOWN:
 		case WM_KEYUP:
 		{
-			// ִглʱΰϢ
-			if (!s_pInstance->m_pTransition && !s_pInstance->m_pNextScene)
-			{
-				EMsgManager::KeyboardProc(message, wParam, lParam);
-			}
+			// ִглʱֻ°״ַ̬
+			EMsgManager::_postMessage(message, wParam, lParam);
 		}
 		result = 0;
 		break;
@@ -687,7 +1519,16 @@ LRESULT e2d::EApp::WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam
 			// յһ WM_SIZE ϢȾ
 			// ĿʵܻʧܣԺпܵ
 			// Ϊһε EndDraw ʱ
-			GetRenderTarget()->Resize(D2D1::SizeU(width, height));
+			if (s_hRenderThread)
+			{
+				// ͼ֮߳֡ȾĿС
+				InterlockedExchange(&s_nPendingSize, LONG(0x80000000 | (min(width, 0x7FFF) << 16) | height));
+			}
+			else
+			{
+				GetRenderer()->resize(width, height);
+			}
+			s_pInstance->m_bFullRedrawNeeded = true;
 		}
 		break;
 
@@ -703,6 +1544,7 @@ LRESULT e2d::EApp::WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam
 		// ػ洰
 		case WM_PAINT:
 		{
+			s_pInstance->m_bFullRedrawNeeded = true;
 			s_pInstance->_render();
 			ValidateRect(hWnd, NULL);
 		}
@@ -716,6 +1558,9 @@ LRESULT e2d::EApp::WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam
 
 			if (LOWORD(wParam) == WA_INACTIVE)
 			{
+				// ʧȥղ̧ϢϢба̧
+				EMsgManager::_postMessage(WM_KILLFOCUS, 0, 0);
+
 				if (pCurrentScene &&
 					pCurrentScene->onInactive() &&
 					s_pInstance->onInactive())
@@ -4,8 +4,31 @@
 #include "..\etools.h"
 #include "..\eactions.h"
 #include "..\Win\winbase.h"
+#include "..\Win\RenderFrame.h"
+#include "..\Win\Renderer.h"
 #include <algorithm>
 
+// εʱϲΪһ
+static const size_t MAX_DIRTY_RECTS = 8;
+
+
+// жǷཻ
+static bool IsRectIntersect(const D2D1_RECT_F & r1, const D2D1_RECT_F & r2)
+{
+	return r1.left < r2.right && r2.left < r1.right && r1.top < r2.bottom && r2.top < r1.bottom;
+}
+
+// εС
+static D2D1_RECT_F UnionRect(const D2D1_RECT_F & r1, const D2D1_RECT_F & r2)
+{
+	return D2D1::RectF(
+		min(r1.left, r2.left),
+		min(r1.top, r2.top),
+		max(r1.right, r2.right),
+		max(r1.bottom, r2.bottom)
+	);
+}
+
 e2d::EScene::EScene()
 	: m_bWillSave(true)
 	, m_bSortNeeded(false)
@@ -15,6 +38,7 @@ e2d::EScene::EScene()
 	m_pRoot->retain();
 	m_pRoot->_onEnter();
 	m_pRoot->_setParentScene(this);
+	m_pRoot->_attachTime();
 	m_pRoot->setPivot(0, 0);
 	m_pRoot->_setSize(EApp::getWidth(), EApp::getHeight());
 }
@@ -47,20 +71,77 @@ bool e2d::EScene::onCloseWindow()
 	return true;
 }
 
-void e2d::EScene::_render()
+void e2d::EScene::_render(const D2D1_RECT_F * clip /* = nullptr */)
 {
 	// ʸڵ
+	ENode::_setRenderClip(clip);
 	m_pRoot->_update();
+	ENode::_setRenderClip(nullptr);
 
 	if (m_bGeometryVisiable)
 	{
 		// ָת
-		GetRenderTarget()->SetTransform(D2D1::Matrix3x2F::Identity());
+		GetRenderer()->setTransform(D2D1::Matrix3x2F::Identity());
 		// мͼ
 		m_pRoot->_drawGeometry();
 	}
 }
 
+void e2d::EScene::_addDirtyRect(const D2D1_RECT_F & rect)
+{
+	if (!EApp::isDirtyRectEnable() && !EApp::isRenderOnDemand())
+		return;
+
+	// չأΪݵıԵռ
+	D2D1_RECT_F dirty = D2D1::RectF(
+		floor(rect.left) - 1,
+		floor(rect.top) - 1,
+		ceil(rect.right) + 1,
+		ceil(rect.bottom) + 1
+	);
+
+	// ཻϲ
+	for (size_t i = 0; i < m_vDirtyRects.size();)
+	{
+		if (IsRectIntersect(m_vDirtyRects[i], dirty))
+		{
+			dirty = UnionRect(m_vDirtyRects[i], dirty);
+			m_vDirtyRects.erase(m_vDirtyRects.begin() + i);
+			i = 0;
+		}
+		else
+		{
+			i++;
+		}
+	}
+
+	// ʱüƵĿػһ
+	if (m_vDirtyRects.size() >= MAX_DIRTY_RECTS)
+	{
+		for (auto iter = m_vDirtyRects.begin(); iter != m_vDirtyRects.end(); iter++)
+		{
+			dirty = UnionRect(*iter, dirty);
+		}
+		m_vDirtyRects.clear();
+	}
+	m_vDirtyRects.push_back(dirty);
+}
+
+void e2d::EScene::_updateDirtyRects()
+{
+	m_pRoot->_updateDirtyRect(true);
+}
+
+void e2d::EScene::_snapshot(ERenderFrame & frame)
+{
+	m_pRoot->_snapshot(frame);
+
+	if (m_bGeometryVisiable)
+	{
+		m_pRoot->_snapshotGeometry(frame);
+	}
+}
+
 void e2d::EScene::add(ENode * child, int order /* = 0 */)
 {
 	m_pRoot->addChild(child, order);
@@ -108,5 +189,40 @@ void e2d::EScene::runAction(EAction * action)
 
 void e2d::EScene::setGeometryVisiable(bool visiable)
 {
+	// رռͼεȾʱѻƵͼ
+	if (m_bGeometryVisiable && !visiable)
+	{
+		_addDirtyRect(D2D1::RectF(0, 0, EApp::getWidth(), EApp::getHeight()));
+	}
 	m_bGeometryVisiable = visiable;
 }
+
+void e2d::EScene::setTimeScale(float scale)
+{
+	m_Clock.setTimeScale(scale);
+}
+
+float e2d::EScene::getTimeScale() const
+{
+	return m_Clock.getTimeScale();
+}
+
+void e2d::EScene::setTimePaused(bool paused)
+{
+	m_Clock.setPaused(paused);
+}
+
+bool e2d::EScene::isTimePaused() const
+{
+	return m_Clock.isPaused();
+}
+
+LONGLONG e2d::EScene::getTime() const
+{
+	return ToMilliseconds(m_Clock.getTime());
+}
+
+void e2d::EScene::_advanceTime(LONGLONG delta)
+{
+	m_Clock.advance(delta);
+}
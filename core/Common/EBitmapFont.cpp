@@ -0,0 +1,352 @@
+#include "..\enodes.h"
+#include "..\Win\winbase.h"
+#include "..\Tool\PackStorage.h"
+#include <algorithm>
+#include <cmath>
+
+
+// ʱɵͼҳС
+static const int PAGE_SIZE = 512;
+// ĿհףбȳȵĲֱõ
+static const int GLYPH_PADDING = 2;
+
+
+// ȡļȫݣȴԴжȡ
+static bool ReadWholeFile(const e2d::EString & fileName, std::vector<char> & data)
+{
+	PackFileData file;
+	if (ReadPackFile(fileName, file))
+	{
+		const char * begin = static_cast<const char *>(file.data);
+		data.assign(begin, begin + file.size);
+		return true;
+	}
+
+	HANDLE hFile = ::CreateFileW(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+	bool succeeded = ::GetFileSizeEx(hFile, &fileSize) && fileSize.QuadPart > 0 && fileSize.QuadPart <= MAXDWORD;
+	if (succeeded)
+	{
+		DWORD read = 0;
+		data.resize(static_cast<size_t>(fileSize.QuadPart));
+		succeeded = ::ReadFile(hFile, &data[0], static_cast<DWORD>(data.size()), &read, NULL) && read == data.size();
+	}
+	::CloseHandle(hFile);
+	return succeeded;
+}
+
+// ȡļڵĿ¼ĩβķָ
+static e2d::EString GetDirectory(const e2d::EString & fileName)
+{
+	int slash = max(fileName.findLastOf(L'\\'), fileName.findLastOf(L'/'));
+	return slash >= 0 ? fileName.sub(0, slash + 1) : e2d::EString();
+}
+
+// ַתΪ UTF-16 wchar_t 
+static UINT32 ToUtf16(unsigned int code, wchar_t * text)
+{
+	if (code >= 0x10000)
+	{
+		code -= 0x10000;
+		text[0] = static_cast<wchar_t>(0xD800 + (code >> 10));
+		text[1] = static_cast<wchar_t>(0xDC00 + (code & 0x3FF));
+		return 2;
+	}
+	text[0] = static_cast<wchar_t>(code);
+	return 1;
+}
+
+
+e2d::EBitmapFont::EBitmapFont(const EString & fntFileName)
+	: m_pFont(nullptr)
+{
+	WARN_IF(!_loadFromFile(fntFileName), "Load EBitmapFont from file failed!");
+}
+
+e2d::EBitmapFont::EBitmapFont(EFont * font, const EString & characters)
+	: m_pFont(font)
+{
+	ASSERT(font != nullptr, "EBitmapFont NULL pointer exception!");
+
+	m_pFont->retain();
+	m_Atlas.setPageSize(PAGE_SIZE, PAGE_SIZE);
+	this->prepare(characters);
+}
+
+e2d::EBitmapFont::~EBitmapFont()
+{
+	for (auto iter = m_vPages.begin(); iter != m_vPages.end(); iter++)
+	{
+		SafeRelease(&(*iter));
+	}
+	SafeRelease(&m_pFont);
+}
+
+float e2d::EBitmapFont::getLineHeight() const
+{
+	return m_Atlas.getLineHeight();
+}
+
+int e2d::EBitmapFont::getPageCount() const
+{
+	return m_Atlas.getPageCount();
+}
+
+void e2d::EBitmapFont::prepare(const EString & characters)
+{
+	if (!m_pFont || characters.isEmpty())
+		return;
+
+	// ҳûɵַ
+	std::vector<unsigned int> codes;
+	const wchar_t * text = characters;
+	size_t length = size_t(characters.length());
+	for (size_t i = 0; i < length;)
+	{
+		unsigned int code;
+		i += GlyphAtlas::decode(text + i, length - i, code);
+
+		if (code != L'\n' &&
+			!m_Atlas.findGlyph(code) &&
+			std::find(codes.begin(), codes.end(), code) == codes.end())
+		{
+			codes.push_back(code);
+		}
+	}
+
+	if (!codes.empty())
+	{
+		_rasterize(codes);
+	}
+}
+
+bool e2d::EBitmapFont::_loadFromFile(const EString & fntFileName)
+{
+	std::vector<char> data;
+	if (fntFileName.isEmpty() || !ReadWholeFile(fntFileName, data))
+		return false;
+
+	std::vector<std::string> pages;
+	if (!m_Atlas.parseBMFont(&data[0], data.size(), pages))
+		return false;
+
+	EString directory = GetDirectory(fntFileName);
+	for (auto iter = pages.begin(); iter != pages.end(); iter++)
+	{
+		ETexture * texture = new ETexture(directory + EString::fromUtf8(*iter));
+		texture->retain();
+		m_vPages.push_back(texture);
+	}
+	return true;
+}
+
+void e2d::EBitmapFont::_rasterize(const std::vector<unsigned int> & codes)
+{
+	IDWriteTextFormat * pFormat = m_pFont->_getTextFormat();
+
+	// βͼ
+	struct NewGlyph
+	{
+		unsigned int		code;
+		GlyphAtlas::Glyph	glyph;
+	};
+	std::vector<NewGlyph> glyphs;
+	std::vector<bool> dirtyPages(m_Atlas.getPageCount());
+
+	for (auto iter = codes.begin(); iter != codes.end(); iter++)
+	{
+		wchar_t text[2];
+		UINT32 length = ToUtf16(*iter, text);
+
+		IDWriteTextLayout * pLayout = nullptr;
+		HRESULT hr = GetDirectWriteFactory()->CreateTextLayout(text, length, pFormat, 0, 0, &pLayout);
+
+		DWRITE_TEXT_METRICS metrics;
+		if (SUCCEEDED(hr))
+		{
+			pLayout->SetWordWrapping(DWRITE_WORD_WRAPPING_NO_WRAP);
+			hr = pLayout->GetMetrics(&metrics);
+		}
+		SafeReleaseInterface(&pLayout);
+
+		if (FAILED(hr))
+			continue;
+
+		if (m_Atlas.getLineHeight() < metrics.height)
+		{
+			m_Atlas.setLineHeight(metrics.height);
+		}
+
+		NewGlyph item;
+		item.code = *iter;
+		item.glyph.x = 0;
+		item.glyph.y = 0;
+		item.glyph.width = 0;
+		item.glyph.height = 0;
+		item.glyph.xoffset = -float(GLYPH_PADDING);
+		item.glyph.yoffset = 0;
+		item.glyph.xadvance = metrics.widthIncludingTrailingWhitespace;
+		item.glyph.page = 0;
+
+		// հַֻвȣռͼ
+		if (!iswspace(static_cast<wint_t>(*iter)))
+		{
+			int width = static_cast<int>(ceil(metrics.widthIncludingTrailingWhitespace)) + GLYPH_PADDING * 2;
+			int height = static_cast<int>(ceil(metrics.height));
+			if (m_Atlas.allocate(width, height, item.glyph.x, item.glyph.y, item.glyph.page))
+			{
+				item.glyph.width = width;
+				item.glyph.height = height;
+				if (dirtyPages.size() <= size_t(item.glyph.page))
+					dirtyPages.resize(item.glyph.page + 1);
+				dirtyPages[item.glyph.page] = true;
+			}
+		}
+		glyphs.push_back(item);
+	}
+
+	if (m_vPagePixels.size() < dirtyPages.size())
+	{
+		m_vPagePixels.resize(dirtyPages.size());
+	}
+
+	// ҳλƵ WIC λͼϣٸƵͼҳ
+	for (size_t page = 0; page < dirtyPages.size(); page++)
+	{
+		if (!dirtyPages[page])
+			continue;
+
+		std::vector<UINT32> & pixels = m_vPagePixels[page];
+		if (pixels.empty())
+		{
+			pixels.resize(PAGE_SIZE * PAGE_SIZE, 0);
+		}
+
+		IWICBitmap * pWicBitmap = nullptr;
+		ID2D1RenderTarget * pTarget = nullptr;
+		ID2D1SolidColorBrush * pBrush = nullptr;
+		std::vector<UINT32> drawn;
+
+		HRESULT hr = GetImagingFactory()->CreateBitmap(
+			PAGE_SIZE,
+			PAGE_SIZE,
+			GUID_WICPixelFormat32bppPBGRA,
+			WICBitmapCacheOnLoad,
+			&pWicBitmap
+		);
+
+		if (SUCCEEDED(hr))
+		{
+			hr = GetFactory()->CreateWicBitmapRenderTarget(
+				pWicBitmap,
+				D2D1::RenderTargetProperties(
+					D2D1_RENDER_TARGET_TYPE_SOFTWARE,
+					D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED),
+					96.f,
+					96.f
+				),
+				&pTarget
+			);
+		}
+
+		if (SUCCEEDED(hr))
+		{
+			hr = pTarget->CreateSolidColorBrush(D2D1::ColorF(m_pFont->getColor()), &pBrush);
+		}
+
+		if (SUCCEEDED(hr))
+		{
+			// ͸ϲʹ ClearType
+			pTarget->SetTextAntialiasMode(D2D1_TEXT_ANTIALIAS_MODE_GRAYSCALE);
+			pTarget->BeginDraw();
+			pTarget->Clear(D2D1::ColorF(0, 0));
+			for (auto iter = glyphs.begin(); iter != glyphs.end(); iter++)
+			{
+				const GlyphAtlas::Glyph & glyph = iter->glyph;
+				if (glyph.width > 0 && size_t(glyph.page) == page)
+				{
+					wchar_t text[2];
+					UINT32 length = ToUtf16(iter->code, text);
+					pTarget->DrawTextW(
+						text,
+						length,
+						pFormat,
+						D2D1::RectF(
+							float(glyph.x + GLYPH_PADDING),
+							float(glyph.y),
+							float(glyph.x + glyph.width),
+							float(glyph.y + glyph.height)
+						),
+						pBrush
+					);
+				}
+			}
+			hr = pTarget->EndDraw();
+		}
+
+		if (SUCCEEDED(hr))
+		{
+			drawn.resize(PAGE_SIZE * PAGE_SIZE);
+			hr = pWicBitmap->CopyPixels(
+				NULL,
+				PAGE_SIZE * 4,
+				PAGE_SIZE * PAGE_SIZE * 4,
+				reinterpret_cast<BYTE*>(&drawn[0])
+			);
+		}
+
+		SafeReleaseInterface(&pBrush);
+		SafeReleaseInterface(&pTarget);
+		SafeReleaseInterface(&pWicBitmap);
+
+		if (FAILED(hr))
+		{
+			WARN_IF(true, "EBitmapFont rasterize glyphs failed!");
+			continue;
+		}
+
+		// ֻε֮ǰɵβӰ
+		for (auto iter = glyphs.begin(); iter != glyphs.end(); iter++)
+		{
+			const GlyphAtlas::Glyph & glyph = iter->glyph;
+			if (glyph.width > 0 && size_t(glyph.page) == page)
+			{
+				for (int y = glyph.y; y < glyph.y + glyph.height; y++)
+				{
+					memcpy(
+						&pixels[size_t(y) * PAGE_SIZE + glyph.x],
+						&drawn[size_t(y) * PAGE_SIZE + glyph.x],
+						size_t(glyph.width) * 4
+					);
+				}
+			}
+		}
+
+		// ϴͼҳ
+		if (m_vPages.size() <= page)
+		{
+			m_vPages.resize(page + 1, nullptr);
+		}
+		if (!m_vPages[page])
+		{
+			m_vPages[page] = new ETexture();
+			m_vPages[page]->retain();
+		}
+		m_vPages[page]->loadFromMemory(&pixels[0], PAGE_SIZE, PAGE_SIZE);
+	}
+
+	for (auto iter = glyphs.begin(); iter != glyphs.end(); iter++)
+	{
+		m_Atlas.addGlyph(iter->code, iter->glyph);
+	}
+}
+
+e2d::ETexture * e2d::EBitmapFont::_getPage(int page) const
+{
+	if (page < 0 || size_t(page) >= m_vPages.size())
+		return nullptr;
+	return m_vPages[page];
+}
@@ -1,5 +1,367 @@
 #include "..\enodes.h"
 #include "..\Win\winbase.h"
+#include "..\Tool\PackStorage.h"
+#include <map>
+
+
+// ԴеļֱӶȡԴڴӳ
+class PackFontFileStream :
+	public IDWriteFontFileStream
+{
+public:
+	PackFontFileStream() : m_nRefCount(1) {}
+
+	HRESULT STDMETHODCALLTYPE QueryInterface(REFIID iid, void ** ppvObject)
+	{
+		if (iid == __uuidof(IUnknown) || iid == __uuidof(IDWriteFontFileStream))
+		{
+			*ppvObject = this;
+			AddRef();
+			return S_OK;
+		}
+		*ppvObject = nullptr;
+		return E_NOINTERFACE;
+	}
+
+	ULONG STDMETHODCALLTYPE AddRef()
+	{
+		return InterlockedIncrement(&m_nRefCount);
+	}
+
+	ULONG STDMETHODCALLTYPE Release()
+	{
+		ULONG nRefCount = InterlockedDecrement(&m_nRefCount);
+		if (nRefCount == 0)
+		{
+			delete this;
+		}
+		return nRefCount;
+	}
+
+	HRESULT STDMETHODCALLTYPE ReadFileFragment(
+		void const ** fragmentStart,
+		UINT64 fileOffset,
+		UINT64 fragmentSize,
+		void ** fragmentContext)
+	{
+		*fragmentContext = nullptr;
+		if (fileOffset > m_File.size || fragmentSize > m_File.size - fileOffset)
+		{
+			*fragmentStart = nullptr;
+			return E_FAIL;
+		}
+		*fragmentStart = static_cast<const BYTE *>(m_File.data) + fileOffset;
+		return S_OK;
+	}
+
+	void STDMETHODCALLTYPE ReleaseFileFragment(void * fragmentContext)
+	{
+	}
+
+	HRESULT STDMETHODCALLTYPE GetFileSize(UINT64 * fileSize)
+	{
+		*fileSize = m_File.size;
+		return S_OK;
+	}
+
+	HRESULT STDMETHODCALLTYPE GetLastWriteTime(UINT64 * lastWriteTime)
+	{
+		*lastWriteTime = 0;
+		return E_NOTIMPL;
+	}
+
+public:
+	PackFileData m_File;
+
+private:
+	LONG m_nRefCount;
+};
+
+// ԴļļļΪԴеļ
+class PackFontFileLoader :
+	public IDWriteFontFileLoader
+{
+public:
+	HRESULT STDMETHODCALLTYPE QueryInterface(REFIID iid, void ** ppvObject)
+	{
+		if (iid == __uuidof(IUnknown) || iid == __uuidof(IDWriteFontFileLoader))
+		{
+			*ppvObject = this;
+			return S_OK;
+		}
+		*ppvObject = nullptr;
+		return E_NOINTERFACE;
+	}
+
+	// ̬󣬲Ҫü
+	ULONG STDMETHODCALLTYPE AddRef() { return 1; }
+	ULONG STDMETHODCALLTYPE Release() { return 1; }
+
+	HRESULT STDMETHODCALLTYPE CreateStreamFromKey(
+		void const * fontFileReferenceKey,
+		UINT32 fontFileReferenceKeySize,
+		IDWriteFontFileStream ** fontFileStream)
+	{
+		*fontFileStream = nullptr;
+
+		e2d::EString fileName(std::wstring(
+			static_cast<const wchar_t *>(fontFileReferenceKey),
+			fontFileReferenceKeySize / sizeof(wchar_t)
+		));
+
+		PackFontFileStream * pStream = new PackFontFileStream();
+		if (!ReadPackFile(fileName, pStream->m_File))
+		{
+			pStream->Release();
+			return E_FAIL;
+		}
+
+		*fontFileStream = pStream;
+		return S_OK;
+	}
+};
+
+static PackFontFileLoader s_PackFontFileLoader;
+
+// Դļö
+class PackFontFileEnumerator :
+	public IDWriteFontFileEnumerator
+{
+public:
+	PackFontFileEnumerator()
+		: m_nRefCount(1)
+		, m_nIndex(0)
+		, m_pCurrentFile(nullptr)
+	{
+		GetPackFiles(L".ttf", m_vFileNames);
+		GetPackFiles(L".otf", m_vFileNames);
+		GetPackFiles(L".ttc", m_vFileNames);
+	}
+
+	~PackFontFileEnumerator()
+	{
+		SafeReleaseInterface(&m_pCurrentFile);
+	}
+
+	HRESULT STDMETHODCALLTYPE QueryInterface(REFIID iid, void ** ppvObject)
+	{
+		if (iid == __uuidof(IUnknown) || iid == __uuidof(IDWriteFontFileEnumerator))
+		{
+			*ppvObject = this;
+			AddRef();
+			return S_OK;
+		}
+		*ppvObject = nullptr;
+		return E_NOINTERFACE;
+	}
+
+	ULONG STDMETHODCALLTYPE AddRef()
+	{
+		return InterlockedIncrement(&m_nRefCount);
+	}
+
+	ULONG STDMETHODCALLTYPE Release()
+	{
+		ULONG nRefCount = InterlockedDecrement(&m_nRefCount);
+		if (nRefCount == 0)
+		{
+			delete this;
+		}
+		return nRefCount;
+	}
+
+	HRESULT STDMETHODCALLTYPE MoveNext(BOOL * hasCurrentFile)
+	{
+		SafeReleaseInterface(&m_pCurrentFile);
+		*hasCurrentFile = FALSE;
+
+		if (m_nIndex < m_vFileNames.size())
+		{
+			const e2d::EString & fileName = m_vFileNames[m_nIndex++];
+			HRESULT hr = GetDirectWriteFactory()->CreateCustomFontFileReference(
+				(const wchar_t *)fileName,
+				static_cast<UINT32>(fileName.length() * sizeof(wchar_t)),
+				&s_PackFontFileLoader,
+				&m_pCurrentFile
+			);
+
+			if (FAILED(hr))
+				return hr;
+
+			*hasCurrentFile = TRUE;
+		}
+		return S_OK;
+	}
+
+	HRESULT STDMETHODCALLTYPE GetCurrentFontFile(IDWriteFontFile ** fontFile)
+	{
+		*fontFile = m_pCurrentFile;
+		if (!m_pCurrentFile)
+			return E_FAIL;
+
+		m_pCurrentFile->AddRef();
+		return S_OK;
+	}
+
+private:
+	LONG m_nRefCount;
+	size_t m_nIndex;
+	std::vector<e2d::EString> m_vFileNames;
+	IDWriteFontFile * m_pCurrentFile;
+};
+
+// Դ弯ϼ
+class PackFontCollectionLoader :
+	public IDWriteFontCollectionLoader
+{
+public:
+	HRESULT STDMETHODCALLTYPE QueryInterface(REFIID iid, void ** ppvObject)
+	{
+		if (iid == __uuidof(IUnknown) || iid == __uuidof(IDWriteFontCollectionLoader))
+		{
+			*ppvObject = this;
+			return S_OK;
+		}
+		*ppvObject = nullptr;
+		return E_NOINTERFACE;
+	}
+
+	// ̬󣬲Ҫü
+	ULONG STDMETHODCALLTYPE AddRef() { return 1; }
+	ULONG STDMETHODCALLTYPE Release() { return 1; }
+
+	HRESULT STDMETHODCALLTYPE CreateEnumeratorFromKey(
+		IDWriteFactory * factory,
+		void const * collectionKey,
+		UINT32 collectionKeySize,
+		IDWriteFontFileEnumerator ** fontFileEnumerator)
+	{
+		*fontFileEnumerator = new PackFontFileEnumerator();
+		return S_OK;
+	}
+};
+
+static PackFontCollectionLoader s_PackFontCollectionLoader;
+// Դе弯
+static IDWriteFontCollection * s_pPackFontCollection = nullptr;
+// 弯϶ӦԴ״̬
+static UINT s_nPackFontGeneration = 0;
+
+// ȡѹԴе弯ϣԴûʱؿ
+static IDWriteFontCollection * GetPackFontCollection()
+{
+	if (s_nPackFontGeneration == GetPackGeneration())
+		return s_pPackFontCollection;
+
+	SafeReleaseInterface(&s_pPackFontCollection);
+	s_nPackFontGeneration = GetPackGeneration();
+
+	std::vector<e2d::EString> fileNames;
+	GetPackFiles(L".ttf", fileNames);
+	GetPackFiles(L".otf", fileNames);
+	GetPackFiles(L".ttc", fileNames);
+	if (fileNames.empty())
+		return nullptr;
+
+	static bool s_bRegistered = false;
+	if (!s_bRegistered)
+	{
+		GetDirectWriteFactory()->RegisterFontFileLoader(&s_PackFontFileLoader);
+		GetDirectWriteFactory()->RegisterFontCollectionLoader(&s_PackFontCollectionLoader);
+		s_bRegistered = true;
+	}
+
+	// DirectWrite 弯ϣʹù״̬İ汾Ϊ
+	UINT key = s_nPackFontGeneration;
+	HRESULT hr = GetDirectWriteFactory()->CreateCustomFontCollection(
+		&s_PackFontCollectionLoader,
+		&key,
+		sizeof(key),
+		&s_pPackFontCollection
+	);
+
+	WARN_IF(FAILED(hr), "Create font collection from pack failed!");
+	return s_pPackFontCollection;
+}
+
+
+// ָʽļƲִСд
+struct TextFormatKey
+{
+	std::wstring	family;
+	float			size;
+	UINT32			weight;
+	bool			italic;
+
+	bool operator<(const TextFormatKey & other) const
+	{
+		if (size != other.size)
+			return size < other.size;
+		if (weight != other.weight)
+			return weight < other.weight;
+		if (italic != other.italic)
+			return italic < other.italic;
+		return family < other.family;
+	}
+};
+
+// ͬ EFont ͬһָʽʽ޸
+static std::map<TextFormatKey, IDWriteTextFormat*> s_mTextFormats;
+// ָʽӦԴ״̬
+static UINT s_nTextFormatGeneration = 0;
+
+// ȡָʽü
+static IDWriteTextFormat * GetTextFormat(const e2d::EString & family, float size, UINT32 weight, bool italic)
+{
+	// ״̬ıͬԲͬ弯
+	if (s_nTextFormatGeneration != GetPackGeneration())
+	{
+		e2d::EFont::clearCache();
+		s_nTextFormatGeneration = GetPackGeneration();
+	}
+
+	TextFormatKey key;
+	key.family = (const wchar_t *)family.lower();
+	key.size = size;
+	key.weight = weight;
+	key.italic = italic;
+
+	auto iter = s_mTextFormats.find(key);
+	if (iter != s_mTextFormats.end())
+	{
+		return iter->second;
+	}
+
+	// Դдڸʱʹ
+	IDWriteFontCollection * pCollection = GetPackFontCollection();
+	if (pCollection)
+	{
+		UINT32 index;
+		BOOL exists = FALSE;
+		if (FAILED(pCollection->FindFamilyName(family, &index, &exists)) || !exists)
+		{
+			pCollection = nullptr;
+		}
+	}
+
+	IDWriteTextFormat * pTextFormat = nullptr;
+	HRESULT hr = GetDirectWriteFactory()->CreateTextFormat(
+		family,
+		pCollection,
+		DWRITE_FONT_WEIGHT(weight),
+		italic ? DWRITE_FONT_STYLE_ITALIC : DWRITE_FONT_STYLE_NORMAL,
+		DWRITE_FONT_STRETCH_NORMAL,
+		size,
+		L"en-us",
+		&pTextFormat
+	);
+
+	ASSERT(SUCCEEDED(hr), "Create IDWriteTextFormat Failed!");
+
+	s_mTextFormats.insert(std::make_pair(key, pTextFormat));
+	return pTextFormat;
+}
+
 
 e2d::EFont::EFont()
 	: m_pTextFormat(nullptr)
@@ -8,6 +370,7 @@ e2d::EFont::EFont()
 	, m_FontWeight(EFontWeight::REGULAR)
 	, m_bItalic(false)
 	, m_bRecreateNeeded(true)
+	, m_nPackGeneration(0)
 {
 }
 
@@ -18,6 +381,7 @@ e2d::EFont::EFont(EString fontFamily, float fontSize /* = 22 */, UINT32 color /*
 	, m_FontWeight(EFontWeight::REGULAR)
 	, m_bItalic(false)
 	, m_bRecreateNeeded(true)
+	, m_nPackGeneration(0)
 {
 	this->setFamily(fontFamily);
 	this->setSize(fontSize);
@@ -80,27 +444,31 @@ void e2d::EFont::setItalic(bool value)
 	m_bRecreateNeeded = true;
 }
 
+void e2d::EFont::clearCache()
+{
+	// ʹõָʽ EFont ãᱻͷ
+	for (auto iter = s_mTextFormats.begin(); iter != s_mTextFormats.end(); iter++)
+	{
+		SafeReleaseInterface(&iter->second);
+	}
+	s_mTextFormats.clear();
+}
+
 void e2d::EFont::_initTextFormat()
 {
 	SafeReleaseInterface(&m_pTextFormat);
 
-	HRESULT hr = GetDirectWriteFactory()->CreateTextFormat(
-		m_sFontFamily,
-		NULL,
-		DWRITE_FONT_WEIGHT(m_FontWeight),
-		m_bItalic ? DWRITE_FONT_STYLE_ITALIC : DWRITE_FONT_STYLE_NORMAL,
-		DWRITE_FONT_STRETCH_NORMAL,
-		m_fFontSize,
-		L"en-us",
-		&m_pTextFormat
-	);
-
-	ASSERT(SUCCEEDED(hr), "Create IDWriteTextFormat Failed!");
+	m_pTextFormat = GetTextFormat(m_sFontFamily, m_fFontSize, m_FontWeight, m_bItalic);
+	if (m_pTextFormat)
+	{
+		m_pTextFormat->AddRef();
+	}
+	m_nPackGeneration = GetPackGeneration();
 }
 
 IDWriteTextFormat * e2d::EFont::_getTextFormat()
 {
-	if (m_bRecreateNeeded)
+	if (m_bRecreateNeeded || m_nPackGeneration != GetPackGeneration())
 	{
 		_initTextFormat();
 		m_bRecreateNeeded = false;
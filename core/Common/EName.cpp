@@ -0,0 +1,92 @@
+#include "..\ecommon.h"
+#include <unordered_map>
+#include <cwchar>
+
+// Ʊеһ
+struct e2d::EName::Entry
+{
+	EString			string;
+	unsigned int	hash;
+};
+
+// ƱɢֵΪɢֵͬʱٱȽַ
+static std::unordered_multimap<unsigned int, e2d::EName::Entry*> & GetNameTable()
+{
+	static std::unordered_multimap<unsigned int, e2d::EName::Entry*> s_mNames;
+	return s_mNames;
+}
+
+// Ʊвַ
+static const e2d::EName::Entry * FindEntry(const e2d::EString & str, unsigned int hash)
+{
+	auto range = GetNameTable().equal_range(hash);
+	for (auto iter = range.first; iter != range.second; iter++)
+	{
+		const e2d::EString & entry = iter->second->string;
+		if (entry.length() == str.length() && wcscmp(entry, str) == 0)
+		{
+			return iter->second;
+		}
+	}
+	return nullptr;
+}
+
+
+e2d::EName::EName()
+	: m_pEntry(nullptr)
+{
+}
+
+e2d::EName::EName(const EString & str)
+	: m_pEntry(nullptr)
+{
+	if (str.isEmpty())
+		return;
+
+	unsigned int hash = str.hash();
+	m_pEntry = FindEntry(str, hash);
+	if (!m_pEntry)
+	{
+		Entry * pEntry = new Entry;
+		pEntry->string = str;
+		pEntry->hash = hash;
+		GetNameTable().insert(std::make_pair(hash, pEntry));
+		m_pEntry = pEntry;
+	}
+}
+
+e2d::EName e2d::EName::find(const EString & str)
+{
+	EName name;
+	if (!str.isEmpty())
+	{
+		name.m_pEntry = FindEntry(str, str.hash());
+	}
+	return name;
+}
+
+bool e2d::EName::isEmpty() const
+{
+	return m_pEntry == nullptr;
+}
+
+unsigned int e2d::EName::hash() const
+{
+	return m_pEntry ? m_pEntry->hash : 0;
+}
+
+const e2d::EString & e2d::EName::toString() const
+{
+	static const EString s_sEmpty;
+	return m_pEntry ? m_pEntry->string : s_sEmpty;
+}
+
+bool e2d::EName::operator==(const EName & name) const
+{
+	return m_pEntry == name.m_pEntry;
+}
+
+bool e2d::EName::operator!=(const EName & name) const
+{
+	return m_pEntry != name.m_pEntry;
+}
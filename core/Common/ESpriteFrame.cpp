@@ -39,6 +39,26 @@ e2d::ESpriteFrame::ESpriteFrame(LPCTSTR resourceName, LPCTSTR resourceType)
 	_setTexture(new ETexture(resourceName, resourceType));
 }
 
+e2d::ESpriteFrame::ESpriteFrame(ETexture * texture, int frameIndex)
+	: m_fSourceClipX(0)
+	, m_fSourceClipY(0)
+	, m_fSourceClipWidth(0)
+	, m_fSourceClipHeight(0)
+	, m_pTexture(nullptr)
+{
+	_setTexture(texture);
+
+	float x, y, width, height;
+	if (texture && texture->_getFrame(frameIndex, x, y, width, height))
+	{
+		_clipTexture(x, y, width, height);
+	}
+	else
+	{
+		WARN_IF(true, "ESpriteFrame frame index out of range!");
+	}
+}
+
 e2d::ESpriteFrame::ESpriteFrame(ETexture * texture, float x, float y, float width, float height)
 	: m_fSourceClipX(0)
 	, m_fSourceClipY(0)
@@ -1,75 +1,133 @@
 #include "..\ecommon.h"
+#include "..\Tool\Utf8.h"
+#include "..\Tool\NumberFormat.h"
 #include <iomanip>
+#include <cmath>
+#include <cstring>
+#include <cwchar>
 using namespace e2d;
 
 
+// Ӹʽ֣ width ʱ
+static void AppendNumber(EString & str, const wchar_t * text, int count, int width, wchar_t fill)
+{
+	bool negative = count > 0 && text[0] == L'-';
+	// nan  inf  0
+	if (fill == L'0' && count > 0 && (text[count - 1] < L'0' || text[count - 1] > L'9'))
+		fill = L' ';
+
+	int padding = max(width - count, 0);
+	str.reserve(str.length() + count + padding);
+
+	//  0 ʱǰ棬ַʱŽ
+	if (negative && fill == L'0')
+	{
+		str.append(text, 1);
+		text++;
+		count--;
+	}
+	for (int i = 0; i < padding; i++)
+	{
+		str.append(&fill, 1);
+	}
+	str.append(text, count);
+}
+
+
 EString::EString()
+	: _string(_local)
+	, _size(0)
+	, _capacity(LOCAL_CAPACITY)
 {
-	_size = 0;
-	_string = new wchar_t[1];
-	_string[0] = 0;
+	_local[0] = 0;
 }
 
 e2d::EString::EString(const wchar_t ch)
+	: _string(_local)
+	, _size(1)
+	, _capacity(LOCAL_CAPACITY)
 {
-	_size = 1;
-	_string = new wchar_t[2];
-	_string[0] = ch;
-	_string[1] = 0;
+	_local[0] = ch;
+	_local[1] = 0;
 }
 
 EString::EString(const wchar_t *str)
+	: _string(_local)
+	, _size(0)
+	, _capacity(LOCAL_CAPACITY)
 {
+	_local[0] = 0;
 	if (str)
 	{
-		_size = wcslen(str);
-		_string = new wchar_t[_size + 1];
-		wcscpy_s(_string, _size + 1, str);
-	}
-	else
-	{
-		this->EString::EString();
+		_assign(str, static_cast<int>(wcslen(str)));
 	}
 }
 
-EString::EString(EString && str)
+EString::EString(EString && str) E2D_NOEXCEPT
+	: _string(_local)
+	, _size(0)
+	, _capacity(LOCAL_CAPACITY)
 {
-	_size = str._size;
-	_string = str._string;
-	str._string = nullptr;
+	_local[0] = 0;
+	_moveFrom(str);
 }
 
 EString::EString(const EString &str)
+	: _string(_local)
+	, _size(0)
+	, _capacity(LOCAL_CAPACITY)
 {
-	if (str._size)
-	{
-		_size = str._size;
-		_string = new wchar_t[_size + 1];
-		wcscpy_s(_string, _size + 1, str._string);
-	}
-	else
-	{
-		this->EString::EString();
-	}
+	_local[0] = 0;
+	_assign(str._string, str._size);
 }
 
 e2d::EString::EString(const std::wstring &str)
+	: _string(_local)
+	, _size(0)
+	, _capacity(LOCAL_CAPACITY)
 {
-	if (!str.empty())
+	_local[0] = 0;
+	_assign(str.c_str(), static_cast<int>(str.length()));
+}
+
+e2d::EString::EString(const wchar_t * str, int count)
+	: _string(_local)
+	, _size(0)
+	, _capacity(LOCAL_CAPACITY)
+{
+	_local[0] = 0;
+	if (str && count > 0)
 	{
-		_size = static_cast<int>(str.length());
-		_string = new wchar_t[_size + 1];
-		wcscpy_s(_string, _size + 1, str.c_str());
+		_assign(str, count);
 	}
-	else
+}
+
+e2d::EString::EString(const char * utf8)
+	: _string(_local)
+	, _size(0)
+	, _capacity(LOCAL_CAPACITY)
+{
+	_local[0] = 0;
+	if (utf8)
 	{
-		this->EString::EString();
+		_appendUtf8(utf8, static_cast<int>(strlen(utf8)));
 	}
 }
 
+e2d::EString::EString(std::nullptr_t)
+	: _string(_local)
+	, _size(0)
+	, _capacity(LOCAL_CAPACITY)
+{
+	_local[0] = 0;
+}
+
 EString::~EString()
 {
-	delete[] _string;
+	if (!_isLocal())
+	{
+		delete[] _string;
+	}
 }
 
 EString &EString::operator=(const wchar_t *str)
@@ -79,54 +137,119 @@ EString &EString::operator=(const wchar_t *str)
 
 	if (str)
 	{
-		delete[] _string;
-		_size = wcslen(str);
-		_string = new wchar_t[_size + 1];
-		wcscpy_s(_string, _size + 1, str);
+		_assign(str, static_cast<int>(wcslen(str)));
 	}
 	else
 	{
-		_string = nullptr;
-		_size = 0;
+		clear();
 	}
 	return *this;
 }
 
 EString &EString::operator=(const EString &str)
 {
-	if (_string == str._string)
-		return *this;
+	if (this != &str)
+	{
+		_assign(str._string, str._size);
+	}
+	return *this;
+}
+
+EString & e2d::EString::operator=(const std::wstring &str)
+{
+	_assign(str.c_str(), static_cast<int>(str.length()));
+	return *this;
+}
 
-	if (str._size)
+EString & e2d::EString::operator=(EString && str) E2D_NOEXCEPT
+{
+	if (this != &str)
 	{
-		delete[] _string;
-		_size = str._size;
-		_string = new wchar_t[_size + 1];
-		wcscpy_s(_string, _size + 1, str._string);
+		_moveFrom(str);
 	}
-	else
+	return *this;
+}
+
+EString & e2d::EString::operator=(const char * utf8)
+{
+	clear();
+	if (utf8)
 	{
-		_string = nullptr;
-		_size = 0;
+		_appendUtf8(utf8, static_cast<int>(strlen(utf8)));
 	}
 	return *this;
 }
 
-EString & e2d::EString::operator=(const std::wstring &str)
+EString & e2d::EString::operator=(std::nullptr_t)
+{
+	clear();
+	return *this;
+}
+
+void e2d::EString::reserve(int capacity)
 {
-	if (!str.empty())
+	if (capacity > _capacity)
+	{
+		_grow(capacity);
+	}
+}
+
+void e2d::EString::clear()
+{
+	_size = 0;
+	_string[0] = 0;
+}
+
+void e2d::EString::_grow(int capacity)
+{
+	// 䣬ַƴʱ볤ȵĶ
+	int newCapacity = max(capacity, _capacity * 2);
+	wchar_t * newString = new wchar_t[newCapacity + 1];
+	wmemcpy(newString, _string, _size + 1);
+
+	if (!_isLocal())
 	{
 		delete[] _string;
-		_size = static_cast<int>(str.length());
-		_string = new wchar_t[_size + 1];
-		wcscpy_s(_string, _size + 1, str.c_str());
 	}
-	else
+	_string = newString;
+	_capacity = newCapacity;
+}
+
+void e2d::EString::_assign(const wchar_t * str, int count)
+{
+	// str ָݣʱռ㹻·
+	if (count > _capacity)
 	{
-		_string = nullptr;
 		_size = 0;
+		_grow(count);
 	}
-	return *this;
+	wmemmove(_string, str, count);
+	_string[count] = 0;
+	_size = count;
+}
+
+void e2d::EString::_moveFrom(EString & str) E2D_NOEXCEPT
+{
+	if (str._isLocal())
+	{
+		// ַֻܸ
+		_assign(str._string, str._size);
+	}
+	else
+	{
+		if (!_isLocal())
+		{
+			delete[] _string;
+		}
+		_string = str._string;
+		_size = str._size;
+		_capacity = str._capacity;
+
+		str._string = str._local;
+		str._capacity = LOCAL_CAPACITY;
+	}
+	str._size = 0;
+	str._string[0] = 0;
 }
 
 bool EString::operator==(const wchar_t *str)
@@ -144,6 +267,11 @@ bool e2d::EString::operator==(const std::wstring &str)
 	return (str.compare(_string) == 0);
 }
 
+bool e2d::EString::operator==(const char *utf8)
+{
+	return (*this == fromUtf8(utf8));
+}
+
 bool e2d::EString::operator!=(const wchar_t *str)
 {
 	return (wcscmp(str, _string) != 0);
@@ -159,6 +287,11 @@ bool e2d::EString::operator!=(const std::wstring &str)
 	return (str.compare(_string) != 0);
 }
 
+bool e2d::EString::operator!=(const char *utf8)
+{
+	return (*this != fromUtf8(utf8));
+}
+
 wchar_t &EString::operator[](int index)
 {
 	ASSERT(index >= 0 && index < _size, "EString subscript out of range");
@@ -167,91 +300,82 @@ wchar_t &EString::operator[](int index)
 
 EString EString::operator+(const wchar_t *str)
 {
-	EString str_temp(*this);
+	int count = str ? static_cast<int>(wcslen(str)) : 0;
 
-	str_temp += str;
-	return std::move(str_temp);
+	EString str_temp;
+	str_temp.reserve(_size + count);
+	str_temp.append(_string, _size);
+	str_temp.append(str, count);
+	return str_temp;
 }
 
 EString EString::operator+(const wchar_t x)
 {
-	EString str_temp(*this);
-
-	str_temp += x;
-	return std::move(str_temp);
+	EString str_temp;
+	str_temp.reserve(_size + 1);
+	str_temp.append(_string, _size);
+	str_temp.append(&x, 1);
+	return str_temp;
 }
 
 EString EString::operator+(const EString &str)
 {
-	EString str_temp(*this);
-
-	str_temp += str;
-	return std::move(str_temp);
+	EString str_temp;
+	str_temp.reserve(_size + str._size);
+	str_temp.append(_string, _size);
+	str_temp.append(str._string, str._size);
+	return str_temp;
 }
 
 EString e2d::EString::operator+(const std::wstring &str)
 {
-	EString str_temp(*this);
+	EString str_temp;
+	str_temp.reserve(_size + static_cast<int>(str.length()));
+	str_temp.append(_string, _size);
+	str_temp.append(str.c_str(), static_cast<int>(str.length()));
+	return str_temp;
+}
 
-	str_temp += str;
-	return std::move(str_temp);
+EString e2d::EString::operator+(const char *utf8)
+{
+	EString str_temp(*this);
+	str_temp += utf8;
+	return str_temp;
 }
 
 EString &EString::operator+=(const wchar_t x)
 {
-	wchar_t *str_temp = new wchar_t[_size + 2];
-	if (_string) wcscpy_s(str_temp, _size + 2, _string);
-	str_temp[_size] = x;
-	str_temp[_size + 1] = 0;
-
-	delete[] _string;
-	_string = str_temp;
-	_size++;
-	return *this;
+	return append(&x, 1);
 }
 
 EString &EString::operator+=(const wchar_t *str)
 {
 	if (!str) return *this;
 
-	int d_size = wcslen(str);
-	if (d_size == 0) return *this;
-
-	wchar_t *str_temp = new wchar_t[_size + d_size + 1];
-	if (_string) wcscpy_s(str_temp, _size + d_size + 1, _string);
-	wcscpy_s(str_temp + _size, d_size + 1, str);
-
-	delete[] _string;
-	_string = str_temp;
-	_size += d_size;
-	return *this;
+	return append(str, static_cast<int>(wcslen(str)));
 }
 
 EString &EString::operator+=(const EString &str)
 {
-	if (str._size == 0) return *this;
-
-	wchar_t *str_temp = new wchar_t[_size + str._size + 1];
-	if (_string) wcscpy_s(str_temp, _size + str._size + 1, _string);
-	wcscpy_s(str_temp + _size, str._size + 1, str._string);
-
-	delete[] _string;
-	_string = str_temp;
-	_size += str._size;
-	return *this;
+	return append(str._string, str._size);
 }
 
 EString & e2d::EString::operator+=(const std::wstring &str)
 {
-	if (str.length() == 0) return *this;
+	return append(str.c_str(), static_cast<int>(str.length()));
+}
 
-	wchar_t *str_temp = new wchar_t[_size + str.length() + 1];
-	if (_string) wcscpy_s(str_temp, _size + str.length() + 1, _string);
-	wcscpy_s(str_temp + _size, str.length() + 1, str.c_str());
+EString & e2d::EString::operator+=(int value)
+{
+	return appendInt(value);
+}
 
-	delete[] _string;
-	_string = str_temp;
-	_size += static_cast<int>(str.length());
+EString & e2d::EString::operator+=(const char *utf8)
+{
+	if (utf8)
+	{
+		_appendUtf8(utf8, static_cast<int>(strlen(utf8)));
+	}
 	return *this;
 }
 
@@ -301,32 +425,56 @@ unsigned int e2d::EString::hash() const
 
 EString e2d::operator+(const wchar_t ch, const EString &str)
 {
-	return std::move((EString(ch) + str));
+	EString str_temp;
+	str_temp.reserve(1 + str._size);
+	str_temp.append(&ch, 1);
+	str_temp.append(str._string, str._size);
+	return str_temp;
 }
 
 EString e2d::operator+(const wchar_t *str1, const EString &str2)
 {
-	return std::move((EString(str1) + str2));
+	int count = str1 ? static_cast<int>(wcslen(str1)) : 0;
+
+	EString str_temp;
+	str_temp.reserve(count + str2._size);
+	str_temp.append(str1, count);
+	str_temp.append(str2._string, str2._size);
+	return str_temp;
 }
 
 EString e2d::operator+(const EString &str1, const EString &str2)
 {
-	return std::move((EString(str1) + str2));
+	EString str_temp;
+	str_temp.reserve(str1._size + str2._size);
+	str_temp.append(str1._string, str1._size);
+	str_temp.append(str2._string, str2._size);
+	return str_temp;
 }
 
 EString e2d::operator+(const std::wstring &str1, const EString &str2)
 {
-	return std::move((EString(str1) + str2));
+	EString str_temp;
+	str_temp.reserve(static_cast<int>(str1.length()) + str2._size);
+	str_temp.append(str1.c_str(), static_cast<int>(str1.length()));
+	str_temp.append(str2._string, str2._size);
+	return str_temp;
+}
+
+EString e2d::operator+(const char *utf8, const EString &str)
+{
+	EString str_temp(utf8);
+	str_temp += str;
+	return str_temp;
 }
 
 std::wistream & e2d::operator>>(std::wistream &cin, EString &str)
 {
 	const int limit_string_size = 4096;
 
-	str._string = new wchar_t[limit_string_size];
-
-	cin >> std::setw(limit_string_size) >> str._string;
-	str._size = wcslen(str._string);
+	std::wstring input;
+	cin >> std::setw(limit_string_size) >> input;
+	str = input;
 	return cin;
 }
 
@@ -339,7 +487,7 @@ EString e2d::EString::upper() const
 		if (str._string[i] >= L'a' && str._string[i] <= L'z')
 			str._string[i] -= (L'a' - L'A');
 
-	return std::move(str);
+	return str;
 }
 
 EString e2d::EString::lower() const
@@ -349,27 +497,20 @@ EString e2d::EString::lower() const
 	for (int i = 0; i < str._size; i++)
 		str._string[i] = towlower(str._string[i]);
 
-	return std::move(str);
+	return str;
 }
 
 EString e2d::EString::sub(int offset, int count) const
 {
 	if (_size == 0 || offset >= _size)
-		return std::move(EString());
+		return EString();
 
 	offset = offset >= 0 ? offset : 0;
 
 	if (count < 0 || (offset + count) > _size)
 		count = _size - offset;
 
-	EString str_temp;
-	str_temp._string = new wchar_t[count + 1];
-
-	for (int i = 0; i < count; i++)
-		str_temp._string[i] = (_string + offset)[i];
-	str_temp._string[count] = 0;
-
-	return std::move(str_temp);
+	return EString(_string + offset, count);
 }
 
 int e2d::EString::findFirstOf(const wchar_t ch) const
@@ -406,3 +547,84 @@ EString & e2d::EString::append(const EString & str)
 {
 	return (*this) += str;
 }
+
+EString & e2d::EString::append(const wchar_t * str, int count)
+{
+	if (!str || count <= 0)
+		return *this;
+
+	if (_size + count > _capacity)
+	{
+		// str ָݣռǰȼƫ
+		bool inside = str >= _string && str < _string + _size;
+		size_t offset = inside ? size_t(str - _string) : 0;
+		_grow(_size + count);
+		if (inside)
+			str = _string + offset;
+	}
+	wmemcpy(_string + _size, str, count);
+	_size += count;
+	_string[_size] = 0;
+	return *this;
+}
+
+EString & e2d::EString::appendInt(long long value, int width, wchar_t fill)
+{
+	wchar_t buffer[NumberFormat::INT_BUFFER_SIZE];
+	size_t count = NumberFormat::formatInt(value, buffer);
+	AppendNumber(*this, buffer, static_cast<int>(count), width, fill);
+	return *this;
+}
+
+EString & e2d::EString::appendFloat(double value, int precision, int width, wchar_t fill)
+{
+	WARN_IF(precision < 0 || precision > NumberFormat::MAX_PRECISION, "EString::appendFloat precision out of range!");
+
+	wchar_t buffer[NumberFormat::FLOAT_BUFFER_SIZE];
+	size_t count = NumberFormat::formatFloat(value, precision, buffer);
+	AppendNumber(*this, buffer, static_cast<int>(count), width, fill);
+	return *this;
+}
+
+EString e2d::EString::parse(int value)
+{
+	EString str;
+	str.appendInt(value);
+	return str;
+}
+
+void e2d::EString::_appendUtf8(const char * utf8, int length)
+{
+	// ÿֽһ wchar_t
+	reserve(_size + length);
+	_size += static_cast<int>(Utf8::decode(utf8, size_t(length), _string + _size));
+	_string[_size] = 0;
+}
+
+std::string e2d::EString::toUtf8() const
+{
+	std::string result(Utf8::maxEncodedSize(size_t(_size)), '\0');
+	if (_size > 0)
+	{
+		result.resize(Utf8::encode(_string, size_t(_size), &result[0]));
+	}
+	return result;
+}
+
+EString e2d::EString::fromUtf8(const char * str, int length)
+{
+	EString result;
+	if (!str)
+		return result;
+
+	if (length < 0)
+		length = static_cast<int>(strlen(str));
+
+	result._appendUtf8(str, length);
+	return result;
+}
+
+EString e2d::EString::fromUtf8(const std::string & str)
+{
+	return fromUtf8(str.c_str(), static_cast<int>(str.length()));
+}
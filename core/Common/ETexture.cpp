@@ -1,139 +1,271 @@
 #include "..\enodes.h"
 #include "..\Win\winbase.h"
-#include <map>
+#include "..\Win\Renderer.h"
+#include "..\Tool\TextureFile.h"
+#include "..\Tool\PackStorage.h"
+#include <unordered_map>
+#include <list>
+#include <vector>
 
 
-struct ResKey
+// Դƣ ID ֱӱ棬ַƱ渱¼أ
+struct ResName
 {
-	ResKey() { resNameHash = 0; resTypeHash = 0; }
+	ResName() : id(nullptr) {}
 
-	bool operator < (ResKey const& key) const
+	ResName(LPCTSTR name) : id(nullptr)
 	{
-		if (resNameHash > key.resNameHash)
-			return true;
-		else if (resNameHash == key.resNameHash)
-			return resTypeHash > key.resTypeHash;
+		if (IS_INTRESOURCE(name))
+			id = name;
 		else
-			return false;
+			str = name;
 	}
 
-	size_t resNameHash;
-	size_t resTypeHash;
-};
-
-static std::map<size_t, ID2D1Bitmap*> s_mBitmapsFromFile;
-static std::map<ResKey, ID2D1Bitmap*> s_mBitmapsFromResource;
+	LPCTSTR get() const { return id ? id : (LPCTSTR)str; }
 
+	LPCTSTR id;
+	e2d::EString str;
+};
 
-e2d::ETexture::ETexture()
-	: m_pBitmap(nullptr)
+// 
+struct e2d::ETextureEntry
 {
-}
+	ID2D1Bitmap *	bitmap;		/* λͼ̭豸ʧʱΪ */
+	std::vector<UINT32> pixels;	/* ʹõأԤ alpha  BGRAδʱΪ */
+	UINT32			pixelWidth;
+	UINT32			pixelHeight;
+	size_t			bytes;		/* λͼظռõڴ */
+	int				users;		/* ø */
+	float			width;		/* λͼ */
+	float			height;		/* λͼ߶ */
+	bool			fromResource;
+	bool			fromPack;
+	bool			fromMemory;
+	size_t			keyHash;	/* Ĺϣֵ */
+	EString			key;		/* 淶Ļ */
+	EString			fileName;	/* ļ· */
+	ResName			resName;
+	ResName			resType;
+	std::vector<TextureFile::Frame> frames;	/* Ԥļе֡ */
+	std::vector<UINT32> source;	/* ڴ洴ʱأ¼ */
+	UINT32			sourceWidth;
+	UINT32			sourceHeight;
+	std::list<ETextureEntry*>::iterator lru;
+};
 
-e2d::ETexture::ETexture(const EString & fileName)
+// Թ淶ĻĹϣֵΪɢҵĿ뻺޹أкȶļ
+static std::unordered_multimap<size_t, e2d::ETextureEntry*> s_mEntries;
+// ʱеĻͷΪδƵ
+static std::list<e2d::ETextureEntry*> s_lLRU;
+// ڴޣΪ 0 ʱ
+static size_t s_nCacheBudget = 0;
+// 浱ǰռõڴ
+static size_t s_nCacheMemory = 0;
+static size_t s_nCacheHits = 0;
+static size_t s_nCacheMisses = 0;
+static size_t s_nCacheEvictions = 0;
+
+
+// Ŀ꣬λͼֻʹ֮һ
+struct BitmapTarget
 {
-	this->loadFromFile(fileName);
-}
+	ID2D1Bitmap **			ppBitmap;
+	std::vector<UINT32> *	pPixels;
+	UINT32					width;
+	UINT32					height;
+};
 
-e2d::ETexture::ETexture(LPCTSTR resourceName, LPCTSTR resourceType)
-{
-	this->loadFromResource(resourceName, resourceType);
-}
 
-e2d::ETexture::~ETexture()
+//  WIC λͼԴתΪ Direct2D λͼ
+static HRESULT CreateBitmapFromDecoder(IWICBitmapDecoder * pDecoder, BitmapTarget & target)
 {
-}
+	HRESULT hr = S_OK;
 
-void e2d::ETexture::loadFromFile(const EString & fileName)
-{
-	WARN_IF(fileName.isEmpty(), "ETexture cannot load bitmap from NULL file name.");
+	IWICBitmapFrameDecode *pSource = nullptr;
+	IWICFormatConverter *pConverter = nullptr;
 
-	if (fileName.isEmpty())
-		return;
+	// ʼ
+	hr = pDecoder->GetFrame(0, &pSource);
 
-	if (!e2d::ETexture::preload(fileName))
+	if (SUCCEEDED(hr))
 	{
-		WARN_IF(true, "Load ETexture from file failed!");
-		return;
+		// ͼƬʽת
+		// (DXGI_FORMAT_B8G8R8A8_UNORM + D2D1_ALPHA_MODE_PREMULTIPLIED).
+		hr = GetImagingFactory()->CreateFormatConverter(&pConverter);
+	}
+	if (SUCCEEDED(hr))
+	{
+		// ͼƬʽת 32bbpPBGRA
+		hr = pConverter->Initialize(
+			pSource,
+			GUID_WICPixelFormat32bppPBGRA,
+			WICBitmapDitherTypeNone,
+			NULL,
+			0.f,
+			WICBitmapPaletteTypeMedianCut
+		);
+	}
+	if (SUCCEEDED(hr))
+	{
+		hr = pConverter->GetSize(&target.width, &target.height);
+	}
+	if (SUCCEEDED(hr))
+	{
+		if (target.pPixels)
+		{
+			// أ
+			UINT64 size = UINT64(target.width) * target.height * 4;
+			hr = (size > 0 && size <= MAXUINT) ? S_OK : E_FAIL;
+			if (SUCCEEDED(hr))
+			{
+				target.pPixels->resize(size_t(target.width) * target.height);
+				hr = pConverter->CopyPixels(
+					NULL,
+					target.width * 4,
+					static_cast<UINT>(size),
+					reinterpret_cast<BYTE*>(&(*target.pPixels)[0])
+				);
+			}
+		}
+		else
+		{
+			//  WIC λͼһ Direct2D λͼ
+			hr = GetRenderTarget()->CreateBitmapFromWicBitmap(
+				pConverter,
+				NULL,
+				target.ppBitmap
+			);
+		}
 	}
 
-	m_pBitmap = s_mBitmapsFromFile.at(fileName.hash());
+	// ͷԴ
+	SafeReleaseInterface(&pSource);
+	SafeReleaseInterface(&pConverter);
+
+	return hr;
 }
 
-void e2d::ETexture::loadFromResource(LPCTSTR resourceName, LPCTSTR resourceType)
+// ԤļݴλͼδѹֱӴ pFile ϴ
+static HRESULT CreateBitmapFromTextureFile(
+	const void * pFile,
+	size_t fileSize,
+	BitmapTarget & target,
+	std::vector<TextureFile::Frame> & frames
+)
 {
-	WARN_IF(!resourceName || !resourceType, "ETexture cannot load bitmap from NULL resource.");
+	TextureFile::View view;
+	if (!TextureFile::parse(pFile, fileSize, view))
+		return E_FAIL;
 
-	if (!resourceName || !resourceType)
-		return;
-
-	if (!e2d::ETexture::preload(resourceName, resourceType))
+	const void * pPixels = view.data;
+	std::vector<unsigned char> pixels;
+	if (TextureFile::isCompressed(view))
 	{
-		WARN_IF(true, "Load ETexture from resource failed!");
-		return;
+		pixels.resize(TextureFile::getPixelSize(view));
+		if (!TextureFile::decode(view, &pixels[0], pixels.size()))
+			return E_FAIL;
+		pPixels = &pixels[0];
 	}
 
-	ResKey key;
-	std::hash<LPCTSTR> h;
-	key.resNameHash = h(resourceName);
-	key.resTypeHash = h(resourceType);
-
-	m_pBitmap = s_mBitmapsFromResource.at(key);
-}
+	target.width = view.header.width;
+	target.height = view.header.height;
 
-float e2d::ETexture::getSourceWidth() const
-{
-	if (m_pBitmap)
+	HRESULT hr = S_OK;
+	if (target.pPixels)
 	{
-		return m_pBitmap->GetSize().width;
+		// иأȥβ
+		target.pPixels->resize(size_t(target.width) * target.height);
+		for (UINT32 y = 0; y < target.height; y++)
+		{
+			memcpy(
+				&(*target.pPixels)[size_t(y) * target.width],
+				static_cast<const unsigned char *>(pPixels) + size_t(y) * view.header.stride,
+				size_t(target.width) * 4
+			);
+		}
 	}
 	else
 	{
-		return 0;
+		hr = GetRenderTarget()->CreateBitmap(
+			D2D1::SizeU(view.header.width, view.header.height),
+			pPixels,
+			view.header.stride,
+			D2D1::BitmapProperties(
+				D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED)
+			),
+			target.ppBitmap
+		);
 	}
-}
 
-float e2d::ETexture::getSourceHeight() const
-{
-	if (m_pBitmap)
-	{
-		return m_pBitmap->GetSize().height;
-	}
-	else
+	if (SUCCEEDED(hr))
 	{
-		return 0;
+		frames.swap(view.frames);
 	}
+	return hr;
 }
 
-e2d::ESize e2d::ETexture::getSourceSize() const
+// жļǷΪԤļ.e2dt
+static bool IsTextureFileName(const e2d::EString & fileName)
 {
-	if (m_pBitmap)
+	int dot = fileName.findLastOf(L'.');
+	return dot >= 0 && fileName.sub(dot).lower() == L".e2dt";
+}
+
+// ͨڴӳԤļ
+static HRESULT LoadBitmapFromTextureFile(
+	LPCTSTR fileName,
+	BitmapTarget & target,
+	std::vector<TextureFile::Frame> & frames
+)
+{
+	HANDLE hFile = ::CreateFileW(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return HRESULT_FROM_WIN32(::GetLastError());
+
+	HANDLE hMapping = nullptr;
+	void * pView = nullptr;
+	LARGE_INTEGER fileSize;
+
+	HRESULT hr = ::GetFileSizeEx(hFile, &fileSize) ? S_OK : E_FAIL;
+
+	if (SUCCEEDED(hr))
 	{
-		return ESize(getSourceWidth(), getSourceHeight());
+		hr = (fileSize.QuadPart > 0 && static_cast<ULONGLONG>(fileSize.QuadPart) <= SIZE_MAX) ? S_OK : E_FAIL;
 	}
-	else
+
+	if (SUCCEEDED(hr))
 	{
-		return ESize();
+		hMapping = ::CreateFileMappingW(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+		hr = hMapping ? S_OK : E_FAIL;
 	}
-}
 
-bool e2d::ETexture::preload(const EString & fileName)
-{
-	if (s_mBitmapsFromFile.find(fileName.hash()) != s_mBitmapsFromFile.end())
+	if (SUCCEEDED(hr))
 	{
-		return true;
+		pView = ::MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+		hr = pView ? S_OK : E_FAIL;
 	}
 
-	HRESULT hr = S_OK;
+	if (SUCCEEDED(hr))
+	{
+		hr = CreateBitmapFromTextureFile(pView, static_cast<size_t>(fileSize.QuadPart), target, frames);
+	}
+
+	if (pView)
+		::UnmapViewOfFile(pView);
+	if (hMapping)
+		::CloseHandle(hMapping);
+	::CloseHandle(hFile);
 
+	return hr;
+}
+
+// ӱļλͼ
+static HRESULT LoadBitmapFromFile(LPCTSTR fileName, BitmapTarget & target)
+{
 	IWICBitmapDecoder *pDecoder = nullptr;
-	IWICBitmapFrameDecode *pSource = nullptr;
-	IWICStream *pStream = nullptr;
-	IWICFormatConverter *pConverter = nullptr;
-	ID2D1Bitmap *pBitmap = nullptr;
 
 	// 
-	hr = GetImagingFactory()->CreateDecoderFromFilename(
+	HRESULT hr = GetImagingFactory()->CreateDecoderFromFilename(
 		fileName,
 		NULL,
 		GENERIC_READ,
@@ -143,78 +275,81 @@ bool e2d::ETexture::preload(const EString & fileName)
 
 	if (SUCCEEDED(hr))
 	{
-		// ʼ
-		hr = pDecoder->GetFrame(0, &pSource);
+		hr = CreateBitmapFromDecoder(pDecoder, target);
+	}
+
+	SafeReleaseInterface(&pDecoder);
+	return hr;
+}
+
+// ڴеͼƬļλͼԤļֱϴ
+static HRESULT LoadBitmapFromMemory(
+	const void * pImageFile,
+	size_t imageFileSize,
+	BitmapTarget & target,
+	std::vector<TextureFile::Frame> & frames
+)
+{
+	if (TextureFile::isTextureFile(pImageFile, imageFileSize))
+	{
+		return CreateBitmapFromTextureFile(pImageFile, imageFileSize, target, frames);
 	}
 
+	HRESULT hr = S_OK;
+
+	IWICBitmapDecoder *pDecoder = nullptr;
+	IWICStream *pStream = nullptr;
+
+	hr = (pImageFile && imageFileSize && imageFileSize <= MAXDWORD) ? S_OK : E_FAIL;
+
 	if (SUCCEEDED(hr))
 	{
-		// ͼƬʽת
-		// (DXGI_FORMAT_B8G8R8A8_UNORM + D2D1_ALPHA_MODE_PREMULTIPLIED).
-		hr = GetImagingFactory()->CreateFormatConverter(&pConverter);
+		//  WIC 
+		hr = GetImagingFactory()->CreateStream(&pStream);
 	}
+
 	if (SUCCEEDED(hr))
 	{
-		// ͼƬʽת 32bbpPBGRA
-		hr = pConverter->Initialize(
-			pSource,
-			GUID_WICPixelFormat32bppPBGRA,
-			WICBitmapDitherTypeNone,
-			NULL,
-			0.f,
-			WICBitmapPaletteTypeMedianCut
+		// ʼ
+		hr = pStream->InitializeFromMemory(
+			reinterpret_cast<BYTE*>(const_cast<void*>(pImageFile)),
+			static_cast<DWORD>(imageFileSize)
 		);
 	}
+
 	if (SUCCEEDED(hr))
 	{
-		//  WIC λͼһ Direct2D λͼ
-		hr = GetRenderTarget()->CreateBitmapFromWicBitmap(
-			pConverter,
+		// Ľ
+		hr = GetImagingFactory()->CreateDecoderFromStream(
+			pStream,
 			NULL,
-			&pBitmap
+			WICDecodeMetadataCacheOnLoad,
+			&pDecoder
 		);
 	}
+
 	if (SUCCEEDED(hr))
 	{
-		// ͼƬָͼƬ Hash 
-		s_mBitmapsFromFile.insert(
-			std::map<size_t, ID2D1Bitmap*>::value_type(
-				fileName.hash(),
-				pBitmap)
-		);
+		hr = CreateBitmapFromDecoder(pDecoder, target);
 	}
 
 	// ͷԴ
 	SafeReleaseInterface(&pDecoder);
-	SafeReleaseInterface(&pSource);
 	SafeReleaseInterface(&pStream);
-	SafeReleaseInterface(&pConverter);
 
-	return SUCCEEDED(hr);
+	return hr;
 }
 
-bool e2d::ETexture::preload(LPCTSTR resourceName, LPCTSTR resourceType)
+// ӳԴλͼ
+static HRESULT LoadBitmapFromResource(
+	LPCTSTR resourceName,
+	LPCTSTR resourceType,
+	BitmapTarget & target,
+	std::vector<TextureFile::Frame> & frames
+)
 {
-	std::hash<LPCTSTR> h;
-
-	ResKey key;
-	key.resNameHash = h(resourceName);
-	key.resTypeHash = h(resourceType);
-
-	if (s_mBitmapsFromResource.find(key) != s_mBitmapsFromResource.end())
-	{
-		return true;
-	}
-
 	HRESULT hr = S_OK;
 
-	IWICBitmapDecoder *pDecoder = nullptr;
-	IWICBitmapFrameDecode *pSource = nullptr;
-	IWICStream *pStream = nullptr;
-	IWICFormatConverter *pConverter = nullptr;
-	IWICBitmapScaler *pScaler = nullptr;
-	ID2D1Bitmap *pBitmap = nullptr;
-
 	HRSRC imageResHandle = nullptr;
 	HGLOBAL imageResDataHandle = nullptr;
 	void *pImageFile = nullptr;
@@ -250,106 +385,624 @@ bool e2d::ETexture::preload(LPCTSTR resourceName, LPCTSTR resourceType)
 
 	if (SUCCEEDED(hr))
 	{
-		//  WIC 
-		hr = GetImagingFactory()->CreateStream(&pStream);
+		hr = LoadBitmapFromMemory(pImageFile, imageFileSize, target, frames);
 	}
 
-	if (SUCCEEDED(hr))
+	return hr;
+}
+
+// ѹصԴнλͼδѹļֱӶȡڴӳ
+static HRESULT LoadBitmapFromPack(
+	const e2d::EString & fileName,
+	BitmapTarget & target,
+	std::vector<TextureFile::Frame> & frames
+)
+{
+	PackFileData file;
+	if (!ReadPackFile(fileName, file))
+		return E_FAIL;
+
+	return LoadBitmapFromMemory(file.data, file.size, target, frames);
+}
+
+// ڴеشλͼ
+static HRESULT LoadBitmapFromPixels(
+	const std::vector<UINT32> & pixels,
+	UINT32 width,
+	UINT32 height,
+	BitmapTarget & target
+)
+{
+	if (pixels.empty())
+		return E_FAIL;
+
+	target.width = width;
+	target.height = height;
+
+	if (target.pPixels)
 	{
-		// ʼ
-		hr = pStream->InitializeFromMemory(
-			reinterpret_cast<BYTE*>(pImageFile),
-			imageFileSize
-		);
+		*target.pPixels = pixels;
+		return S_OK;
 	}
+	return GetRenderTarget()->CreateBitmap(
+		D2D1::SizeU(width, height),
+		&pixels[0],
+		width * 4,
+		D2D1::BitmapProperties(
+			D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED)
+		),
+		target.ppBitmap
+	);
+}
 
-	if (SUCCEEDED(hr))
+// Դ뵽Ŀ
+static HRESULT LoadEntry(e2d::ETextureEntry * entry, BitmapTarget & target)
+{
+	if (entry->fromMemory)
+		return LoadBitmapFromPixels(entry->source, entry->sourceWidth, entry->sourceHeight, target);
+	else if (entry->fromResource)
+		return LoadBitmapFromResource(entry->resName.get(), entry->resType.get(), target, entry->frames);
+	else if (entry->fromPack)
+		return LoadBitmapFromPack(entry->fileName, target, entry->frames);
+	else if (IsTextureFileName(entry->fileName))
+		return LoadBitmapFromTextureFile(entry->fileName, target, entry->frames);
+	else
+		return LoadBitmapFromFile(entry->fileName, target);
+}
+
+// ¼ĴСռõڴ
+static void AddEntryMemory(e2d::ETextureEntry * entry, UINT32 width, UINT32 height)
+{
+	entry->pixelWidth = width;
+	entry->pixelHeight = height;
+	entry->bytes = size_t(width) * size_t(height) * 4;
+	s_nCacheMemory += entry->bytes;
+}
+
+// Ϊλͼ
+static bool LoadEntryBitmap(e2d::ETextureEntry * entry)
+{
+	BitmapTarget target = { &entry->bitmap, nullptr, 0, 0 };
+	if (FAILED(LoadEntry(entry, target)))
 	{
-		// Ľ
-		hr = GetImagingFactory()->CreateDecoderFromStream(
-			pStream,
-			NULL,
-			WICDecodeMetadataCacheOnLoad,
-			&pDecoder
-		);
+		entry->bitmap = nullptr;
+		return false;
 	}
 
-	if (SUCCEEDED(hr))
+	D2D1_SIZE_U size = entry->bitmap->GetPixelSize();
+	entry->width = entry->bitmap->GetSize().width;
+	entry->height = entry->bitmap->GetSize().height;
+	AddEntryMemory(entry, size.width, size.height);
+	return true;
+}
+
+// Ϊʹõ
+static bool LoadEntryPixels(e2d::ETextureEntry * entry)
+{
+	BitmapTarget target = { nullptr, &entry->pixels, 0, 0 };
+	if (FAILED(LoadEntry(entry, target)))
 	{
-		// ʼ
-		hr = pDecoder->GetFrame(0, &pSource);
+		std::vector<UINT32>().swap(entry->pixels);
+		return false;
 	}
 
-	if (SUCCEEDED(hr))
+	// ʱ 1 ؼΪ 1 DIP
+	entry->width = static_cast<float>(target.width);
+	entry->height = static_cast<float>(target.height);
+	AddEntryMemory(entry, target.width, target.height);
+	return true;
+}
+
+// ͷŻλͼ
+static void ReleaseEntryBitmap(e2d::ETextureEntry * entry)
+{
+	if (entry->bitmap)
 	{
-		// ͼƬʽת
-		// (DXGI_FORMAT_B8G8R8A8_UNORM + D2D1_ALPHA_MODE_PREMULTIPLIED).
-		hr = GetImagingFactory()->CreateFormatConverter(&pConverter);
+		SafeReleaseInterface(&entry->bitmap);
+		s_nCacheMemory -= entry->bytes;
 	}
+}
 
-	if (SUCCEEDED(hr))
+// ͷŻλͼ
+static void ReleaseEntry(e2d::ETextureEntry * entry)
+{
+	ReleaseEntryBitmap(entry);
+	if (!entry->pixels.empty())
 	{
-		// ͼƬʽת 32bppPBGRA
-		hr = pConverter->Initialize(
-			pSource,
-			GUID_WICPixelFormat32bppPBGRA,
-			WICBitmapDitherTypeNone,
-			NULL,
-			0.f,
-			WICBitmapPaletteTypeMedianCut
-		);
+		std::vector<UINT32>().swap(entry->pixels);
+		s_nCacheMemory -= entry->bytes;
 	}
+}
 
-	if (SUCCEEDED(hr))
+// ӻɾ
+static void EraseEntry(e2d::ETextureEntry * entry)
+{
+	auto range = s_mEntries.equal_range(entry->keyHash);
+	for (auto iter = range.first; iter != range.second; iter++)
 	{
-		//  WIC λͼһ Direct2D λͼ
-		hr = GetRenderTarget()->CreateBitmapFromWicBitmap(
-			pConverter,
-			NULL,
-			&pBitmap
-		);
+		if (iter->second == entry)
+		{
+			s_mEntries.erase(iter);
+			break;
+		}
 	}
+	s_lLRU.erase(entry->lru);
+	ReleaseEntry(entry);
+	delete entry;
+}
 
-	if (SUCCEEDED(hr))
+// ̭δδõĻֱڴռò
+static void TrimCache(e2d::ETextureEntry * keep = nullptr)
+{
+	if (s_nCacheBudget == 0)
+		return;
+
+	for (auto iter = s_lLRU.begin(); iter != s_lLRU.end() && s_nCacheMemory > s_nCacheBudget;)
 	{
-		std::hash<LPCTSTR> h;
+		auto entry = *(iter++);
+		if (entry->users == 0 && entry != keep)
+		{
+			EraseEntry(entry);
+			s_nCacheEvictions++;
+		}
+	}
+}
 
-		ResKey key;
-		key.resNameHash = h(resourceName);
-		key.resTypeHash = h(resourceType);
+// Ϊʹ
+static void TouchEntry(e2d::ETextureEntry * entry)
+{
+	s_lLRU.splice(s_lLRU.end(), s_lLRU, entry->lru);
+}
 
-		s_mBitmapsFromResource.insert(
-			std::map<ResKey, ID2D1Bitmap*>::value_type(
-				key,
-				pBitmap)
-		);
+// µĻλͼ
+static e2d::ETextureEntry * CreateEntry(e2d::ETextureEntry * entry)
+{
+	entry->bitmap = nullptr;
+	entry->pixelWidth = 0;
+	entry->pixelHeight = 0;
+	entry->bytes = 0;
+	entry->users = 0;
+	entry->width = 0;
+	entry->height = 0;
+
+	bool loaded = IsSoftwareRenderer() ? LoadEntryPixels(entry) : LoadEntryBitmap(entry);
+	if (!loaded)
+	{
+		delete entry;
+		return nullptr;
 	}
 
-	// ͷԴ
-	SafeReleaseInterface(&pDecoder);
-	SafeReleaseInterface(&pSource);
-	SafeReleaseInterface(&pStream);
-	SafeReleaseInterface(&pConverter);
-	SafeReleaseInterface(&pScaler);
+	entry->lru = s_lLRU.insert(s_lLRU.end(), entry);
+	return entry;
+}
 
-	return SUCCEEDED(hr);
+// 㻺Ĺϣֵ64 λ FNV-1a
+static size_t HashKey(const e2d::EString & key)
+{
+	unsigned long long hash = 14695981039346656037ULL;
+	for (int i = 0; i < key.length(); i++)
+	{
+		hash ^= (unsigned long long)((const wchar_t*)key)[i];
+		hash *= 1099511628211ULL;
+	}
+	return static_cast<size_t>(hash);
 }
 
-void e2d::ETexture::clearCache()
+// ȡļ··ļ '/' ָ淶
+static e2d::EString GetFullFilePath(const e2d::EString & fileName)
+{
+	DWORD length = ::GetFullPathNameW(fileName, 0, NULL, NULL);
+	if (length == 0)
+		return fileName;
+
+	std::vector<wchar_t> fullPath(length);
+	if (::GetFullPathNameW(fileName, length, &fullPath[0], NULL) == 0)
+		return fileName;
+
+	// չ 8.3 ʽĶļ
+	length = ::GetLongPathNameW(&fullPath[0], NULL, 0);
+	if (length != 0)
+	{
+		std::vector<wchar_t> longPath(length);
+		if (::GetLongPathNameW(&fullPath[0], &longPath[0], length) != 0)
+		{
+			fullPath.swap(longPath);
+		}
+	}
+
+	for (auto iter = fullPath.begin(); iter != fullPath.end(); iter++)
+	{
+		if (*iter == L'/')
+			*iter = L'\\';
+	}
+	return e2d::EString(&fullPath[0]);
+}
+
+// ȡԴļĹ淶ʽ PackFile Ĳҹһ
+static e2d::EString GetPackFileKey(const e2d::EString & fileName)
+{
+	std::wstring key = (const wchar_t *)fileName;
+	for (auto iter = key.begin(); iter != key.end(); iter++)
+	{
+		if (*iter == L'\\')
+			*iter = L'/';
+		else if (*iter >= L'A' && *iter <= L'Z')
+			*iter = *iter - L'A' + L'a';
+	}
+
+	size_t start = 0;
+	while (start < key.length())
+	{
+		if (key.compare(start, 2, L"./") == 0)
+			start += 2;
+		else if (key[start] == L'/')
+			start++;
+		else
+			break;
+	}
+	return e2d::EString(key.substr(start));
+}
+
+// ȡԴƵĹ淶ʽ ID  "#123" ʽַͬƲִСд
+static e2d::EString GetResourceKeyPart(LPCTSTR name)
+{
+	if (IS_INTRESOURCE(name))
+	{
+		return e2d::EString(L'#') + static_cast<unsigned int>(reinterpret_cast<ULONG_PTR>(name));
+	}
+	return e2d::EString(name).upper();
+}
+
+// һϣֵͬʱȶļ
+static e2d::ETextureEntry * FindEntry(const e2d::EString & key, size_t keyHash)
+{
+	auto range = s_mEntries.equal_range(keyHash);
+	for (auto iter = range.first; iter != range.second; iter++)
+	{
+		if (wcscmp(iter->second->key, key) == 0)
+		{
+			return iter->second;
+		}
+	}
+	return nullptr;
+}
+
+// һδʱµĻ
+static e2d::ETextureEntry * GetEntry(e2d::ETextureEntry * entry)
+{
+	entry->keyHash = HashKey(entry->key);
+
+	auto cached = FindEntry(entry->key, entry->keyHash);
+	if (cached)
+	{
+		s_nCacheHits++;
+		TouchEntry(cached);
+		delete entry;
+		return cached;
+	}
+
+	s_nCacheMisses++;
+
+	if (CreateEntry(entry) == nullptr)
+	{
+		return nullptr;
+	}
+
+	s_mEntries.insert(std::make_pair(entry->keyHash, entry));
+	TrimCache(entry);
+	return entry;
+}
+
+static e2d::ETextureEntry * GetEntry(const e2d::EString & fileName)
+{
+	auto entry = new e2d::ETextureEntry();
+	entry->fromResource = false;
+	entry->fromMemory = false;
+	entry->fromPack = e2d::EPackUtils::exists(fileName);
+	if (entry->fromPack)
+	{
+		// Դеļ ASCII ĸСд
+		entry->fileName = fileName;
+		entry->key = L"pack:" + GetPackFileKey(fileName);
+	}
+	else
+	{
+		entry->fileName = GetFullFilePath(fileName);
+		// ļϵͳִСд
+		entry->key = L"file:" + entry->fileName.lower();
+	}
+	return GetEntry(entry);
+}
+
+static e2d::ETextureEntry * GetEntry(LPCTSTR resourceName, LPCTSTR resourceType)
+{
+	auto entry = new e2d::ETextureEntry();
+	entry->fromResource = true;
+	entry->fromPack = false;
+	entry->fromMemory = false;
+	entry->resName = ResName(resourceName);
+	entry->resType = ResName(resourceType);
+	entry->key = L"res:" + GetResourceKeyPart(resourceType) + L':' + GetResourceKeyPart(resourceName);
+	return GetEntry(entry);
+}
+
+static e2d::ETextureEntry * GetEntry(const UINT32 * pixels, UINT32 width, UINT32 height)
+{
+	// ڴеزû
+	static UINT32 s_nMemoryId = 0;
+
+	auto entry = new e2d::ETextureEntry();
+	entry->fromResource = false;
+	entry->fromPack = false;
+	entry->fromMemory = true;
+	entry->source.assign(pixels, pixels + size_t(width) * height);
+	entry->sourceWidth = width;
+	entry->sourceHeight = height;
+	entry->key = e2d::EString(L"mem:") + (++s_nMemoryId);
+	return GetEntry(entry);
+}
+
+
+e2d::ETexture::ETexture()
+	: m_pEntry(nullptr)
+{
+}
+
+e2d::ETexture::ETexture(const EString & fileName)
+	: m_pEntry(nullptr)
+{
+	this->loadFromFile(fileName);
+}
+
+e2d::ETexture::ETexture(LPCTSTR resourceName, LPCTSTR resourceType)
+	: m_pEntry(nullptr)
+{
+	this->loadFromResource(resourceName, resourceType);
+}
+
+e2d::ETexture::ETexture(const UINT32 * pixels, UINT32 width, UINT32 height)
+	: m_pEntry(nullptr)
+{
+	this->loadFromMemory(pixels, width, height);
+}
+
+e2d::ETexture::~ETexture()
 {
-	for (auto child = s_mBitmapsFromFile.begin(); child != s_mBitmapsFromFile.end(); child++)
+	_setEntry(nullptr);
+}
+
+void e2d::ETexture::loadFromFile(const EString & fileName)
+{
+	WARN_IF(fileName.isEmpty(), "ETexture cannot load bitmap from NULL file name.");
+
+	if (fileName.isEmpty())
+		return;
+
+	auto entry = GetEntry(fileName);
+	if (!entry)
 	{
-		SafeReleaseInterface(&(*child).second);
+		WARN_IF(true, "Load ETexture from file failed!");
+		return;
 	}
-	for (auto child = s_mBitmapsFromFile.begin(); child != s_mBitmapsFromFile.end(); child++)
+
+	_setEntry(entry);
+}
+
+void e2d::ETexture::loadFromResource(LPCTSTR resourceName, LPCTSTR resourceType)
+{
+	WARN_IF(!resourceName || !resourceType, "ETexture cannot load bitmap from NULL resource.");
+
+	if (!resourceName || !resourceType)
+		return;
+
+	auto entry = GetEntry(resourceName, resourceType);
+	if (!entry)
 	{
-		SafeReleaseInterface(&(*child).second);
+		WARN_IF(true, "Load ETexture from resource failed!");
+		return;
 	}
-	s_mBitmapsFromFile.clear();
-	s_mBitmapsFromResource.clear();
+
+	_setEntry(entry);
+}
+
+void e2d::ETexture::loadFromMemory(const UINT32 * pixels, UINT32 width, UINT32 height)
+{
+	WARN_IF(!pixels || width == 0 || height == 0, "ETexture cannot load bitmap from empty pixels.");
+
+	if (!pixels || width == 0 || height == 0)
+		return;
+
+	auto entry = GetEntry(pixels, width, height);
+	if (!entry)
+	{
+		WARN_IF(true, "Load ETexture from memory failed!");
+		return;
+	}
+
+	_setEntry(entry);
+}
+
+float e2d::ETexture::getSourceWidth() const
+{
+	if (m_pEntry)
+	{
+		return m_pEntry->width;
+	}
+	else
+	{
+		return 0;
+	}
+}
+
+float e2d::ETexture::getSourceHeight() const
+{
+	if (m_pEntry)
+	{
+		return m_pEntry->height;
+	}
+	else
+	{
+		return 0;
+	}
+}
+
+e2d::ESize e2d::ETexture::getSourceSize() const
+{
+	if (m_pEntry)
+	{
+		return ESize(getSourceWidth(), getSourceHeight());
+	}
+	else
+	{
+		return ESize();
+	}
+}
+
+int e2d::ETexture::getFrameCount() const
+{
+	if (m_pEntry)
+	{
+		return static_cast<int>(m_pEntry->frames.size());
+	}
+	else
+	{
+		return 0;
+	}
+}
+
+bool e2d::ETexture::preload(const EString & fileName)
+{
+	return GetEntry(fileName) != nullptr;
+}
+
+bool e2d::ETexture::preload(LPCTSTR resourceName, LPCTSTR resourceType)
+{
+	return GetEntry(resourceName, resourceType) != nullptr;
+}
+
+void e2d::ETexture::clearCache()
+{
+	// ɾδõĻԱõֻͷλͼʱ¼
+	for (auto iter = s_lLRU.begin(); iter != s_lLRU.end();)
+	{
+		auto entry = *(iter++);
+		if (entry->users == 0)
+		{
+			EraseEntry(entry);
+		}
+		else
+		{
+			ReleaseEntry(entry);
+		}
+	}
+}
+
+void e2d::ETexture::setCacheBudget(size_t bytes)
+{
+	s_nCacheBudget = bytes;
+	TrimCache();
+}
+
+size_t e2d::ETexture::getCacheBudget()
+{
+	return s_nCacheBudget;
+}
+
+size_t e2d::ETexture::getCacheMemory()
+{
+	return s_nCacheMemory;
+}
+
+size_t e2d::ETexture::getCacheHits()
+{
+	return s_nCacheHits;
+}
+
+size_t e2d::ETexture::getCacheMisses()
+{
+	return s_nCacheMisses;
+}
+
+size_t e2d::ETexture::getCacheEvictions()
+{
+	return s_nCacheEvictions;
 }
 
 ID2D1Bitmap * e2d::ETexture::_getBitmap()
 {
-	return m_pBitmap;
+	if (!m_pEntry)
+		return nullptr;
+
+	if (!m_pEntry->bitmap)
+	{
+		// λͼѱͷţ¼
+		s_nCacheMisses++;
+		if (!LoadEntryBitmap(m_pEntry))
+			return nullptr;
+		TrimCache();
+	}
+
+	TouchEntry(m_pEntry);
+	return m_pEntry->bitmap;
+}
+
+bool e2d::ETexture::_getPixels(const UINT32 ** ppPixels, UINT32 & width, UINT32 & height)
+{
+	if (!m_pEntry)
+		return false;
+
+	if (m_pEntry->pixels.empty())
+	{
+		s_nCacheMisses++;
+		if (!LoadEntryPixels(m_pEntry))
+			return false;
+		TrimCache();
+	}
+
+	TouchEntry(m_pEntry);
+	*ppPixels = &m_pEntry->pixels[0];
+	width = m_pEntry->pixelWidth;
+	height = m_pEntry->pixelHeight;
+	return true;
+}
+
+void e2d::ETexture::_setEntry(ETextureEntry * entry)
+{
+	if (entry == m_pEntry)
+		return;
+
+	if (entry)
+	{
+		entry->users++;
+	}
+
+	if (m_pEntry)
+	{
+		m_pEntry->users--;
+		m_pEntry = nullptr;
+		TrimCache();
+	}
+
+	m_pEntry = entry;
+}
+
+void e2d::ETexture::_discardBitmaps()
+{
+	for (auto iter = s_lLRU.begin(); iter != s_lLRU.end(); iter++)
+	{
+		ReleaseEntryBitmap(*iter);
+	}
+}
+
+bool e2d::ETexture::_getFrame(int index, float & x, float & y, float & width, float & height) const
+{
+	if (!m_pEntry || index < 0 || index >= static_cast<int>(m_pEntry->frames.size()))
+		return false;
+
+	const TextureFile::Frame & frame = m_pEntry->frames[index];
+	x = static_cast<float>(frame.x);
+	y = static_cast<float>(frame.y);
+	width = static_cast<float>(frame.width);
+	height = static_cast<float>(frame.height);
+	return true;
 }
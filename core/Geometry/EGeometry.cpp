@@ -2,6 +2,7 @@
 #include "..\emanagers.h"
 #include "..\enodes.h"
 #include "..\Win\winbase.h"
+#include "..\Win\Renderer.h"
 
 e2d::EGeometry::EGeometry()
 	: m_nCategoryBitmask(0)
@@ -63,17 +64,8 @@ void e2d::EGeometry::_render()
 {
 	if (m_pTransformedGeometry)
 	{
-		// ˢ
-		GetRenderTarget()->CreateSolidColorBrush(
-			D2D1::ColorF(
-				m_nColor,
-				m_fOpacity),
-			&GetSolidColorBrush()
-		);
 		// Ƽ״
-		GetRenderTarget()->DrawGeometry(m_pTransformedGeometry, GetSolidColorBrush());
-		// ͷʱԴ
-		SafeReleaseInterface(&GetSolidColorBrush());
+		GetRenderer()->drawGeometry(m_pTransformedGeometry, m_nColor, m_fOpacity);
 	}
 }
 
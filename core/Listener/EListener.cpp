@@ -15,7 +15,7 @@ e2d::EListener::EListener(const EString & name)
 	, m_pParentNode(nullptr)
 	, m_bSwallow(false)
 {
-	m_sName = name;
+	m_Name = EName(name);
 }
 
 bool e2d::EListener::isRunning() const
@@ -33,9 +33,9 @@ void e2d::EListener::stop()
 	m_bRunning = false;
 }
 
-e2d::EString e2d::EListener::getName() const
+const e2d::EString & e2d::EListener::getName() const
 {
-	return m_sName;
+	return m_Name.toString();
 }
 
 e2d::ENode * e2d::EListener::getParentNode() const
@@ -45,7 +45,7 @@ e2d::ENode * e2d::EListener::getParentNode() const
 
 void e2d::EListener::setName(const EString & name)
 {
-	m_sName = name;
+	m_Name = EName(name);
 }
 
 void e2d::EListener::setSwallow(bool bSwallow)
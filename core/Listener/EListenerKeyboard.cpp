@@ -38,6 +38,24 @@ void e2d::EListenerKeyboard::setCallback(const KEY_LISTENER_CALLBACK & callback)
 	m_Callback = callback;
 }
 
+void e2d::EListenerKeyboard::setEventCallback(const KEY_EVENT_LISTENER_CALLBACK & callback)
+{
+	m_EventCallback = callback;
+}
+
+void e2d::EListenerKeyboard::setName(const EString & name)
+{
+	// Ѱ󶨵ļҪ
+	if (m_pParentNode)
+	{
+		EMsgManager::_renameListener(this, name);
+	}
+	else
+	{
+		m_Name = EName(name);
+	}
+}
+
 void e2d::EListenerKeyboard::bindWith(EScene * pParentScene)
 {
 	WARN_IF(m_pParentNode != nullptr, "A listener cannot bind with two object.");
@@ -3,24 +3,28 @@
 
 e2d::EListenerMouse::EListenerMouse()
 	: EListener()
+	, m_bHitTest(false)
 	, m_Callback(nullptr)
 {
 }
 
 e2d::EListenerMouse::EListenerMouse(const EString & name)
 	: EListener(name)
+	, m_bHitTest(false)
 	, m_Callback(nullptr)
 {
 }
 
 e2d::EListenerMouse::EListenerMouse(const MOUSE_LISTENER_CALLBACK & callback)
 	: EListener()
+	, m_bHitTest(false)
 	, m_Callback(callback)
 {
 }
 
 e2d::EListenerMouse::EListenerMouse(const EString & name, const MOUSE_LISTENER_CALLBACK & callback)
 	: EListener(name)
+	, m_bHitTest(false)
 	, m_Callback(callback)
 {
 }
@@ -38,6 +42,42 @@ void e2d::EListenerMouse::setCallback(const MOUSE_LISTENER_CALLBACK & callback)
 	m_Callback = callback;
 }
 
+void e2d::EListenerMouse::setEventCallback(const MOUSE_EVENT_LISTENER_CALLBACK & callback)
+{
+	m_EventCallback = callback;
+}
+
+void e2d::EListenerMouse::setHitTest(bool bHitTest)
+{
+	if (m_bHitTest != bHitTest)
+	{
+		m_bHitTest = bHitTest;
+		// Ѱ󶨵ļҪƶӦķַб
+		if (m_pParentNode)
+		{
+			EMsgManager::_updateRoute(this);
+		}
+	}
+}
+
+bool e2d::EListenerMouse::isHitTest() const
+{
+	return m_bHitTest;
+}
+
+void e2d::EListenerMouse::setName(const EString & name)
+{
+	// Ѱ󶨵ļҪ
+	if (m_pParentNode)
+	{
+		EMsgManager::_renameListener(this, name);
+	}
+	else
+	{
+		m_Name = EName(name);
+	}
+}
+
 void e2d::EListenerMouse::bindWith(EScene * pParentScene)
 {
 	WARN_IF(m_pParentNode != nullptr, "A listener cannot bind with two object.");
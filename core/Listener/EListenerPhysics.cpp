@@ -39,6 +39,19 @@ void e2d::EListenerPhysics::setCallback(const PHYSICS_LISTENER_CALLBACK & callba
 	m_Callback = callback;
 }
 
+void e2d::EListenerPhysics::setName(const EString & name)
+{
+	// Ѱ󶨵ļҪ
+	if (m_pParentNode)
+	{
+		EPhysicsManager::_renameListener(this, name);
+	}
+	else
+	{
+		m_Name = EName(name);
+	}
+}
+
 void e2d::EListenerPhysics::bindWith(EScene * pParentScene)
 {
 	WARN_IF(m_pParentNode != nullptr, "A listener cannot bind with two object.");
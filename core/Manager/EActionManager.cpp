@@ -128,6 +128,22 @@ void e2d::EActionManager::_resetAllActions()
 	}
 }
 
+bool e2d::EActionManager::_hasRunningActions()
+{
+	for (auto action = s_vActions.begin(); action != s_vActions.end(); action++)
+	{
+		// ѽĶҪִһԱƳ
+		if ((*action)->_isEnding())
+			return true;
+
+		if ((*action)->isRunning() &&
+			(*action)->getTarget() &&
+			(*action)->getTarget()->getParentScene() == EApp::getCurrentScene())
+			return true;
+	}
+	return false;
+}
+
 void e2d::EActionManager::ActionProc()
 {
 	if (s_vActions.empty())
@@ -2,45 +2,139 @@
 #include "..\elisteners.h"
 #include "..\enodes.h"
 #include "..\Win\winbase.h"
+#include "..\Tool\NameIndex.h"
+#include <algorithm>
+#include <unordered_map>
 
 
 // Ϣ
 std::vector<e2d::EListenerMouse*> s_vMouseListeners;
 // Ϣ
 std::vector<e2d::EListenerKeyboard*> s_vKeyboardListeners;
+// Ϣ
+static NameIndex<e2d::EName, e2d::EListenerMouse> s_MouseListenerNames;
+// İϢ
+static NameIndex<e2d::EName, e2d::EListenerKeyboard> s_KeyboardListenerNames;
+//  HitTest ϢϢ
+static std::vector<e2d::EListenerMouse*> s_vGlobalMouseListeners;
+//  HitTest Ϣڽڵ
+static std::unordered_multimap<e2d::ENode*, e2d::EListenerMouse*> s_mRoutedMouseListeners;
+// һϢַ HitTest 뿪ڵʱյһϢ
+static std::vector<e2d::EListenerMouse*> s_vHoveredListeners;
+// ڽڵϰ HitTest ̧ǰһֱϢ
+static std::vector<e2d::EListenerMouse*> s_vCapturedListeners;
+
+// Ϣе 2 
+static const size_t INPUT_QUEUE_SIZE = 1024;
+// ϢУλڹյϢÿ֡ǰͳһַ
+static e2d::EInputEvent s_InputQueue[INPUT_QUEUE_SIZE];
+// Ϣλ
+static size_t s_nQueueHead = 0;
+// еϢ
+static size_t s_nQueueCount = 0;
+// ǷϲƶϢ
+static bool s_bMouseMoveCoalesced = true;
+
+
+// бظ
+static void AddUnique(std::vector<e2d::EListenerMouse*> & listeners, e2d::EListenerMouse * listener)
+{
+	if (std::find(listeners.begin(), listeners.end(), listener) == listeners.end())
+	{
+		listeners.push_back(listener);
+	}
+}
+
+// бɾ
+static void Remove(std::vector<e2d::EListenerMouse*> & listeners, e2d::EListenerMouse * listener)
+{
+	listeners.erase(std::remove(listeners.begin(), listeners.end(), listener), listeners.end());
+}
 
 
-void e2d::EMsgManager::MouseProc(UINT message, WPARAM wParam, LPARAM lParam)
+void e2d::EMsgManager::MouseProc(const EInputEvent & event)
 {
 	// Ϣ
-	EMouseMsg::s_nMsg = message;
-	EMouseMsg::s_wParam = wParam;
-	EMouseMsg::s_lParam = lParam;
+	EMouseMsg::s_Event = event;
 
 	if (s_vMouseListeners.empty()) return;
 
-	// ִϢ
-	size_t i = s_vMouseListeners.size();
+	// ַ˳·ϲĽڵ㼰ڵϵļһϢλ·ĽߡʱĽߣ
+	// Ȼǲ HitTest ļ󶨵ִУ
+	// бϢ֮ظʹãÿϢڴ
+	static std::vector<EListenerMouse*> listeners;
+	static std::vector<ENode*> path;
+	listeners.clear();
+	size_t nHovered = 0;
 
-	do
+	EScene * pScene = EApp::getCurrentScene();
+	if (!s_mRoutedMouseListeners.empty() && pScene)
 	{
-		auto mlistener = s_vMouseListeners[--i];
+		path.clear();
+		pScene->getRoot()->_pick(event.getPos(), path);
+
+		for (auto node = path.begin(); node != path.end(); node++)
+		{
+			auto range = s_mRoutedMouseListeners.equal_range(*node);
+			for (auto iter = range.first; iter != range.second; iter++)
+			{
+				listeners.push_back(iter->second);
+			}
+		}
+		nHovered = listeners.size();
+
+		for (auto iter = s_vHoveredListeners.begin(); iter != s_vHoveredListeners.end(); iter++)
+		{
+			AddUnique(listeners, *iter);
+		}
+		for (auto iter = s_vCapturedListeners.begin(); iter != s_vCapturedListeners.end(); iter++)
+		{
+			AddUnique(listeners, *iter);
+		}
+	}
+
+	// ¼·ڵϵĽ
+	s_vHoveredListeners.assign(listeners.begin(), listeners.begin() + nHovered);
+	UINT message = event.m_nMsg;
+	bool bButtonDown = (message == EMouseMsg::LBUTTON_DOWN || message == EMouseMsg::RBUTTON_DOWN || message == EMouseMsg::MBUTTON_DOWN);
+	bool bButtonUp = (message == EMouseMsg::LBUTTON_UP || message == EMouseMsg::RBUTTON_UP || message == EMouseMsg::MBUTTON_UP);
+	if (bButtonDown)
+	{
+		for (size_t i = 0; i < nHovered; i++)
+		{
+			AddUnique(s_vCapturedListeners, listeners[i]);
+		}
+	}
+	else if (bButtonUp)
+	{
+		s_vCapturedListeners.clear();
+	}
+
+	listeners.insert(listeners.end(), s_vGlobalMouseListeners.rbegin(), s_vGlobalMouseListeners.rend());
+
+	// ִϢ
+	// صɾļٰ󶨽ڵ㣬_isReady  false֮ˢвŻͷ
+	for (auto iter = listeners.begin(); iter != listeners.end(); iter++)
+	{
+		auto mlistener = *iter;
 
 		if (mlistener->_isReady())
 		{
 			mlistener->_callOn();
+			if (mlistener->m_EventCallback)
+			{
+				mlistener->m_EventCallback(event);
+			}
 			if (mlistener->m_bSwallow)
 				break;
 		}
-	} while (i != 0);
+	}
 }
 
-void e2d::EMsgManager::KeyboardProc(UINT message, WPARAM wParam, LPARAM lParam)
+void e2d::EMsgManager::KeyboardProc(const EInputEvent & event)
 {
 	// 水Ϣ
-	EKeyboardMsg::s_nMsg = message;
-	EKeyboardMsg::s_wParam = wParam;
-	EKeyboardMsg::s_lParam = lParam;
+	EKeyboardMsg::s_Event = event;
 
 	if (s_vKeyboardListeners.empty()) return;
 
@@ -54,12 +148,119 @@ void e2d::EMsgManager::KeyboardProc(UINT message, WPARAM wParam, LPARAM lParam)
 		if (klistener->_isReady())
 		{
 			klistener->_callOn();
+			if (klistener->m_EventCallback)
+			{
+				klistener->m_EventCallback(event);
+			}
 			if (klistener->m_bSwallow)
 				break;
 		}
 	} while (i != 0);
 }
 
+void e2d::EMsgManager::setMouseMoveCoalesced(bool bCoalesced)
+{
+	s_bMouseMoveCoalesced = bCoalesced;
+}
+
+bool e2d::EMsgManager::isMouseMoveCoalesced()
+{
+	return s_bMouseMoveCoalesced;
+}
+
+void e2d::EMsgManager::_postMessage(UINT message, WPARAM wParam, LPARAM lParam)
+{
+	LARGE_INTEGER tNow;
+	QueryPerformanceCounter(&tNow);
+
+	// ĩβƶϢϲ״̬ıʱϲ֤º̧λ׼ȷ
+	if (s_bMouseMoveCoalesced && message == EMouseMsg::MOVE && s_nQueueCount > 0)
+	{
+		EInputEvent & last = s_InputQueue[(s_nQueueHead + s_nQueueCount - 1) & (INPUT_QUEUE_SIZE - 1)];
+		if (last.m_nMsg == message && last.m_wParam == wParam)
+		{
+			last.m_lParam = lParam;
+			last.m_nTime = tNow.QuadPart;
+			last.m_nCount++;
+			return;
+		}
+	}
+
+	EInputEvent event;
+	event.m_nMsg = message;
+	event.m_wParam = wParam;
+	event.m_lParam = lParam;
+	event.m_nTime = tNow.QuadPart;
+	event.m_nCount = 1;
+	EMsgManager::_postMessage(event);
+}
+
+void e2d::EMsgManager::_postMessage(const EInputEvent & event)
+{
+	// ʱϢ
+	if (s_nQueueCount == INPUT_QUEUE_SIZE)
+	{
+		WARN_IF(true, "Input queue is full, the oldest message is dropped!");
+		s_nQueueHead = (s_nQueueHead + 1) & (INPUT_QUEUE_SIZE - 1);
+		s_nQueueCount--;
+	}
+
+	s_InputQueue[(s_nQueueHead + s_nQueueCount) & (INPUT_QUEUE_SIZE - 1)] = event;
+	s_nQueueCount++;
+}
+
+void e2d::EMsgManager::_getMessages(std::vector<EInputEvent> & events)
+{
+	events.clear();
+	for (size_t i = 0; i < s_nQueueCount; i++)
+	{
+		events.push_back(s_InputQueue[(s_nQueueHead + i) & (INPUT_QUEUE_SIZE - 1)]);
+	}
+}
+
+void e2d::EMsgManager::_updateKeyStates()
+{
+	EKeyboardMsg::_beginFrame();
+
+	// ַǰһӦñ֡аϢصϷݸµõͬİ״̬
+	for (size_t i = 0; i < s_nQueueCount; i++)
+	{
+		const EInputEvent & event = s_InputQueue[(s_nQueueHead + i) & (INPUT_QUEUE_SIZE - 1)];
+		if (!event.isMouseMsg())
+		{
+			EKeyboardMsg::_updateKeyState(event);
+		}
+	}
+}
+
+void e2d::EMsgManager::_dispatchMessages()
+{
+	// ַֻʼʱڶеϢصвϢһ֡
+	for (size_t n = s_nQueueCount; n > 0 && s_nQueueCount > 0; n--)
+	{
+		// ȡϢصмϢϲ
+		EInputEvent event = s_InputQueue[s_nQueueHead];
+		s_nQueueHead = (s_nQueueHead + 1) & (INPUT_QUEUE_SIZE - 1);
+		s_nQueueCount--;
+
+		// WM_KILLFOCUS ֻڸ°״ַ̬
+		if (event.isMouseMsg())
+		{
+			EMsgManager::MouseProc(event);
+		}
+		else if (event.m_nMsg == EKeyboardMsg::KEY_DOWN || event.m_nMsg == EKeyboardMsg::KEY_UP)
+		{
+			EMsgManager::KeyboardProc(event);
+		}
+	}
+}
+
+void e2d::EMsgManager::_clearMessages()
+{
+	s_nQueueHead = 0;
+	s_nQueueCount = 0;
+}
+
 void e2d::EMsgManager::bindListener(e2d::EListenerMouse * listener, EScene * pParentScene)
 {
 	EMsgManager::bindListener(listener, pParentScene->getRoot());
@@ -86,6 +287,8 @@ void e2d::EMsgManager::bindListener(EListenerMouse * listener, ENode * pParentNo
 		listener->retain();
 		listener->m_pParentNode = pParentNode;
 		s_vMouseListeners.push_back(listener);
+		s_MouseListenerNames.add(listener->m_Name, listener);
+		EMsgManager::_updateRoute(listener);
 	}
 }
 
@@ -105,88 +308,80 @@ void e2d::EMsgManager::bindListener(EListenerKeyboard * listener, ENode * pParen
 		listener->retain();
 		listener->m_pParentNode = pParentNode;
 		s_vKeyboardListeners.push_back(listener);
+		s_KeyboardListenerNames.add(listener->m_Name, listener);
 	}
 }
 
 void e2d::EMsgManager::startMouseListeners(const EString & name)
 {
-	for (auto l = s_vMouseListeners.begin(); l != s_vMouseListeners.end(); l++)
+	static std::vector<EListenerMouse*> listeners;
+	EMsgManager::_findMouseListeners(name, listeners);
+	for (auto l = listeners.begin(); l != listeners.end(); l++)
 	{
-		if ((*l)->getName() == name)
-		{
-			(*l)->start();
-		}
+		(*l)->start();
 	}
 }
 
 void e2d::EMsgManager::stopMouseListeners(const EString & name)
 {
-	for (auto l = s_vMouseListeners.begin(); l != s_vMouseListeners.end(); l++)
+	static std::vector<EListenerMouse*> listeners;
+	EMsgManager::_findMouseListeners(name, listeners);
+	for (auto l = listeners.begin(); l != listeners.end(); l++)
 	{
-		if ((*l)->getName() == name)
-		{
-			(*l)->stop();
-		}
+		(*l)->stop();
 	}
 }
 
 void e2d::EMsgManager::delMouseListeners(const EString & name)
 {
 	// ɾϢ
-	std::vector<EListenerMouse*>::iterator mIter;
-	for (mIter = s_vMouseListeners.begin(); mIter != s_vMouseListeners.end();)
+	static std::vector<EListenerMouse*> listeners;
+	EMsgManager::_findMouseListeners(name, listeners);
+	for (auto l = listeners.begin(); l != listeners.end(); l++)
 	{
-		if ((*mIter)->getName() == name)
-		{
-			SafeRelease(&(*mIter));
-			mIter = s_vMouseListeners.erase(mIter);
-		}
-		else
-		{
-			mIter++;
-		}
+		EListenerMouse * listener = *l;
+		EMsgManager::_removeRoute(listener);
+		s_MouseListenerNames.remove(listener->m_Name, listener);
+		s_vMouseListeners.erase(std::find(s_vMouseListeners.begin(), s_vMouseListeners.end(), listener));
+		listener->m_pParentNode = nullptr;
+		SafeRelease(&listener);
 	}
 }
 
 void e2d::EMsgManager::startKeyboardListeners(const EString & name)
 {
 	// Ϣ
-	for (auto l = s_vKeyboardListeners.begin(); l != s_vKeyboardListeners.end(); l++)
+	static std::vector<EListenerKeyboard*> listeners;
+	EMsgManager::_findKeyboardListeners(name, listeners);
+	for (auto l = listeners.begin(); l != listeners.end(); l++)
 	{
-		if ((*l)->getName() == name)
-		{
-			(*l)->start();
-		}
+		(*l)->start();
 	}
 }
 
 void e2d::EMsgManager::stopKeyboardListeners(const EString & name)
 {
 	// ֹͣϢ
-	for (auto l = s_vKeyboardListeners.begin(); l != s_vKeyboardListeners.end(); l++)
+	static std::vector<EListenerKeyboard*> listeners;
+	EMsgManager::_findKeyboardListeners(name, listeners);
+	for (auto l = listeners.begin(); l != listeners.end(); l++)
 	{
-		if ((*l)->getName() == name)
-		{
-			(*l)->stop();
-		}
+		(*l)->stop();
 	}
 }
 
 void e2d::EMsgManager::delKeyboardListeners(const EString & name)
 {
 	// ɾϢ
-	std::vector<EListenerKeyboard*>::iterator kIter;
-	for (kIter = s_vKeyboardListeners.begin(); kIter != s_vKeyboardListeners.end();)
+	static std::vector<EListenerKeyboard*> listeners;
+	EMsgManager::_findKeyboardListeners(name, listeners);
+	for (auto l = listeners.begin(); l != listeners.end(); l++)
 	{
-		if ((*kIter)->getName() == name)
-		{
-			SafeRelease(&(*kIter));
-			kIter = s_vKeyboardListeners.erase(kIter);
-		}
-		else
-		{
-			kIter++;
-		}
+		EListenerKeyboard * listener = *l;
+		s_KeyboardListenerNames.remove(listener->m_Name, listener);
+		s_vKeyboardListeners.erase(std::find(s_vKeyboardListeners.begin(), s_vKeyboardListeners.end(), listener));
+		listener->m_pParentNode = nullptr;
+		SafeRelease(&listener);
 	}
 }
 
@@ -277,6 +472,9 @@ void e2d::EMsgManager::_clearAllMouseListenersBindedWith(ENode * pParentNode)
 		auto t = s_vMouseListeners[i];
 		if (t->getParentNode() == pParentNode)
 		{
+			EMsgManager::_removeRoute(t);
+			s_MouseListenerNames.remove(t->m_Name, t);
+			t->m_pParentNode = nullptr;
 			SafeRelease(&t);
 			s_vMouseListeners.erase(s_vMouseListeners.begin() + i);
 		}
@@ -294,6 +492,8 @@ void e2d::EMsgManager::_clearAllKeyboardListenersBindedWith(ENode * pParentNode)
 		auto t = s_vKeyboardListeners[i];
 		if (t->getParentNode() == pParentNode)
 		{
+			s_KeyboardListenerNames.remove(t->m_Name, t);
+			t->m_pParentNode = nullptr;
 			SafeRelease(&t);
 			s_vKeyboardListeners.erase(s_vKeyboardListeners.begin() + i);
 		}
@@ -304,10 +504,102 @@ void e2d::EMsgManager::_clearAllKeyboardListenersBindedWith(ENode * pParentNode)
 	}
 }
 
+void e2d::EMsgManager::_findMouseListeners(const EString & name, std::vector<EListenerMouse*> & listeners)
+{
+	// ƱвڵƲκμ
+	EName key = EName::find(name);
+	if (key.isEmpty() && !name.isEmpty())
+	{
+		listeners.clear();
+		return;
+	}
+	s_MouseListenerNames.find(key, listeners, [&](EListenerMouse * listener) { return listener->m_Name == key; });
+}
+
+void e2d::EMsgManager::_findKeyboardListeners(const EString & name, std::vector<EListenerKeyboard*> & listeners)
+{
+	// ƱвڵƲκμ
+	EName key = EName::find(name);
+	if (key.isEmpty() && !name.isEmpty())
+	{
+		listeners.clear();
+		return;
+	}
+	s_KeyboardListenerNames.find(key, listeners, [&](EListenerKeyboard * listener) { return listener->m_Name == key; });
+}
+
+void e2d::EMsgManager::_renameListener(EListenerMouse * listener, const EString & name)
+{
+	// ֻڹеļҪ
+	bool indexed = s_MouseListenerNames.remove(listener->m_Name, listener);
+	listener->m_Name = EName(name);
+	if (indexed)
+	{
+		s_MouseListenerNames.add(listener->m_Name, listener);
+	}
+}
+
+void e2d::EMsgManager::_renameListener(EListenerKeyboard * listener, const EString & name)
+{
+	// ֻڹеļҪ
+	bool indexed = s_KeyboardListenerNames.remove(listener->m_Name, listener);
+	listener->m_Name = EName(name);
+	if (indexed)
+	{
+		s_KeyboardListenerNames.add(listener->m_Name, listener);
+	}
+}
+
+void e2d::EMsgManager::_updateRoute(EListenerMouse * listener)
+{
+	EMsgManager::_removeRoute(listener);
+
+	if (listener->m_bHitTest)
+	{
+		s_mRoutedMouseListeners.insert(std::make_pair(listener->m_pParentNode, listener));
+	}
+	else
+	{
+		s_vGlobalMouseListeners.push_back(listener);
+	}
+}
+
+void e2d::EMsgManager::_removeRoute(EListenerMouse * listener)
+{
+	Remove(s_vGlobalMouseListeners, listener);
+	Remove(s_vHoveredListeners, listener);
+	Remove(s_vCapturedListeners, listener);
+
+	auto range = s_mRoutedMouseListeners.equal_range(listener->m_pParentNode);
+	for (auto iter = range.first; iter != range.second; iter++)
+	{
+		if (iter->second == listener)
+		{
+			s_mRoutedMouseListeners.erase(iter);
+			break;
+		}
+	}
+}
+
 void e2d::EMsgManager::_clearManager()
 {
+	for (auto l = s_vMouseListeners.begin(); l != s_vMouseListeners.end(); l++)
+	{
+		(*l)->m_pParentNode = nullptr;
+	}
+	for (auto l = s_vKeyboardListeners.begin(); l != s_vKeyboardListeners.end(); l++)
+	{
+		(*l)->m_pParentNode = nullptr;
+	}
 	s_vMouseListeners.clear();
 	s_vKeyboardListeners.clear();
+	s_MouseListenerNames.clear();
+	s_KeyboardListenerNames.clear();
+	s_vGlobalMouseListeners.clear();
+	s_mRoutedMouseListeners.clear();
+	s_vHoveredListeners.clear();
+	s_vCapturedListeners.clear();
+	EMsgManager::_clearMessages();
 }
 
 void e2d::EMsgManager::startAllMouseListeners()
@@ -2,11 +2,15 @@
 #include "..\enodes.h"
 #include "..\elisteners.h"
 #include "..\egeometry.h"
+#include "..\Tool\NameIndex.h"
+#include <algorithm>
 
 // 
 std::vector<e2d::EListenerPhysics*> s_vListeners;
 // ״
 std::vector<e2d::EGeometry*> s_vGeometries;
+// ļ
+static NameIndex<e2d::EName, e2d::EListenerPhysics> s_ListenerNames;
 
 
 void e2d::EPhysicsManager::PhysicsGeometryProc(EGeometry * pActiveGeometry)
@@ -85,6 +89,7 @@ void e2d::EPhysicsManager::bindListener(EListenerPhysics * listener, ENode * pPa
 		listener->start();
 		listener->m_pParentNode = pParentNode;
 		s_vListeners.push_back(listener);
+		s_ListenerNames.add(listener->m_Name, listener);
 	}
 }
 
@@ -115,40 +120,35 @@ void e2d::EPhysicsManager::_delGeometry(EGeometry * geometry)
 
 void e2d::EPhysicsManager::startListeners(const EString & name)
 {
-	for (auto listener = s_vListeners.begin(); listener != s_vListeners.end(); listener++)
+	static std::vector<EListenerPhysics*> listeners;
+	EPhysicsManager::_findListeners(name, listeners);
+	for (auto listener = listeners.begin(); listener != listeners.end(); listener++)
 	{
-		if ((*listener)->getName() == name)
-		{
-			(*listener)->start();
-		}
+		(*listener)->start();
 	}
 }
 
 void e2d::EPhysicsManager::stopListeners(const EString & name)
 {
-	for (auto listener = s_vListeners.begin(); listener != s_vListeners.end(); listener++)
+	static std::vector<EListenerPhysics*> listeners;
+	EPhysicsManager::_findListeners(name, listeners);
+	for (auto listener = listeners.begin(); listener != listeners.end(); listener++)
 	{
-		if ((*listener)->getName() == name)
-		{
-			(*listener)->stop();
-		}
+		(*listener)->stop();
 	}
 }
 
 void e2d::EPhysicsManager::delListeners(const EString & name)
 {
-	std::vector<EListenerPhysics*>::iterator iter;
-	for (iter = s_vListeners.begin(); iter != s_vListeners.end();)
+	static std::vector<EListenerPhysics*> listeners;
+	EPhysicsManager::_findListeners(name, listeners);
+	for (auto iter = listeners.begin(); iter != listeners.end(); iter++)
 	{
-		if ((*iter)->getName() == name)
-		{
-			SafeRelease(&(*iter));
-			iter = s_vListeners.erase(iter);
-		}
-		else
-		{
-			iter++;
-		}
+		EListenerPhysics * listener = *iter;
+		s_ListenerNames.remove(listener->m_Name, listener);
+		s_vListeners.erase(std::find(s_vListeners.begin(), s_vListeners.end(), listener));
+		listener->m_pParentNode = nullptr;
+		SafeRelease(&listener);
 	}
 }
 
@@ -204,7 +204,35 @@ void e2d::EPhysicsManager::stopAllListeners()
 
 void e2d::EPhysicsManager::_clearManager()
 {
+	for (auto iter = s_vListeners.begin(); iter != s_vListeners.end(); iter++)
+	{
+		(*iter)->m_pParentNode = nullptr;
+	}
 	s_vListeners.clear();
+	s_ListenerNames.clear();
+}
+
+void e2d::EPhysicsManager::_findListeners(const EString & name, std::vector<EListenerPhysics*> & listeners)
+{
+	// ƱвڵƲκμ
+	EName key = EName::find(name);
+	if (key.isEmpty() && !name.isEmpty())
+	{
+		listeners.clear();
+		return;
+	}
+	s_ListenerNames.find(key, listeners, [&](EListenerPhysics * listener) { return listener->m_Name == key; });
+}
+
+void e2d::EPhysicsManager::_renameListener(EListenerPhysics * listener, const EString & name)
+{
+	// ֻڹеļҪ
+	bool indexed = s_ListenerNames.remove(listener->m_Name, listener);
+	listener->m_Name = EName(name);
+	if (indexed)
+	{
+		s_ListenerNames.add(listener->m_Name, listener);
+	}
 }
 
 void e2d::EPhysicsManager::_clearAllListenersBindedWith(ENode * pParentNode)
@@ -214,6 +242,8 @@ void e2d::EPhysicsManager::_clearAllListenersBindedWith(ENode * pParentNode)
 		auto listener = s_vListeners[i];
 		if (listener->getParentNode() == pParentNode)
 		{
+			s_ListenerNames.remove(listener->m_Name, listener);
+			listener->m_pParentNode = nullptr;
 			SafeRelease(&listener);
 			s_vListeners.erase(s_vListeners.begin() + i);
 		}
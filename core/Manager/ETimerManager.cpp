@@ -2,8 +2,13 @@
 #include "..\etools.h"
 #include "..\enodes.h"
 #include "..\Win\winbase.h"
+#include "..\Tool\NameIndex.h"
+#include <algorithm>
+#include <cmath>
 
 static std::vector<e2d::ETimer*> s_vTimers;
+// Ķʱ
+static NameIndex<e2d::EName, e2d::ETimer> s_TimerNames;
 
 
 void e2d::ETimerManager::TimerProc()
@@ -38,49 +43,45 @@ void e2d::ETimerManager::bindTimer(ETimer * timer, ENode * pParentNode)
 			"The timer is already binded, it cannot bind again!"
 		);
 
-		timer->start();
 		timer->retain();
 		timer->m_pParentNode = pParentNode;
+		timer->start();
 		s_vTimers.push_back(timer);
+		s_TimerNames.add(timer->m_Name, timer);
 	}
 }
 
 void e2d::ETimerManager::startTimers(const EString & name)
 {
-	for (auto timer = s_vTimers.begin(); timer != s_vTimers.end(); timer++)
+	static std::vector<ETimer*> timers;
+	ETimerManager::_findTimers(name, timers);
+	for (auto timer = timers.begin(); timer != timers.end(); timer++)
 	{
-		if ((*timer)->getName() == name)
-		{
-			(*timer)->start();
-		}
+		(*timer)->start();
 	}
 }
 
 void e2d::ETimerManager::stopTimers(const EString & name)
 {
-	for (auto timer = s_vTimers.begin(); timer != s_vTimers.end(); timer++)
+	static std::vector<ETimer*> timers;
+	ETimerManager::_findTimers(name, timers);
+	for (auto timer = timers.begin(); timer != timers.end(); timer++)
 	{
-		if ((*timer)->getName() == name)
-		{
-			(*timer)->stop();
-		}
+		(*timer)->stop();
 	}
 }
 
 void e2d::ETimerManager::delTimers(const EString & name)
 {
-	std::vector<ETimer*>::iterator mIter;
-	for (mIter = s_vTimers.begin(); mIter != s_vTimers.end();)
+	static std::vector<ETimer*> timers;
+	ETimerManager::_findTimers(name, timers);
+	for (auto timer = timers.begin(); timer != timers.end(); timer++)
 	{
-		if ((*mIter)->getName() == name)
-		{
-			SafeRelease(&(*mIter));
-			mIter = s_vTimers.erase(mIter);
-		}
-		else
-		{
-			mIter++;
-		}
+		ETimer * t = *timer;
+		s_TimerNames.remove(t->m_Name, t);
+		s_vTimers.erase(std::find(s_vTimers.begin(), s_vTimers.end(), t));
+		t->m_pParentNode = nullptr;
+		SafeRelease(&t);
 	}
 }
 
@@ -131,6 +132,8 @@ void e2d::ETimerManager::_clearAllTimersBindedWith(ENode * pParentNode)
 		auto t = s_vTimers[i];
 		if (t->getParentNode() == pParentNode)
 		{
+			s_TimerNames.remove(t->m_Name, t);
+			t->m_pParentNode = nullptr;
 			SafeRelease(&t);
 			s_vTimers.erase(s_vTimers.begin() + i);
 		}
@@ -143,15 +146,75 @@ void e2d::ETimerManager::_clearAllTimersBindedWith(ENode * pParentNode)
 
 void e2d::ETimerManager::_clearManager()
 {
+	for (auto timer = s_vTimers.begin(); timer != s_vTimers.end(); timer++)
+	{
+		(*timer)->m_pParentNode = nullptr;
+	}
 	s_vTimers.clear();
+	s_TimerNames.clear();
+}
+
+void e2d::ETimerManager::_findTimers(const EString & name, std::vector<ETimer*> & timers)
+{
+	// ƱвڵƲκζʱ
+	EName key = EName::find(name);
+	if (key.isEmpty() && !name.isEmpty())
+	{
+		timers.clear();
+		return;
+	}
+	s_TimerNames.find(key, timers, [&](ETimer * timer) { return timer->m_Name == key; });
+}
+
+void e2d::ETimerManager::_renameTimer(ETimer * timer, const EString & name)
+{
+	// ֻڹеĶʱҪ
+	bool indexed = s_TimerNames.remove(timer->m_Name, timer);
+	timer->m_Name = EName(name);
+	if (indexed)
+	{
+		s_TimerNames.add(timer->m_Name, timer);
+	}
 }
 
 void e2d::ETimerManager::_resetAllTimers()
 {
 	for (auto timer = s_vTimers.begin(); timer != s_vTimers.end(); timer++)
 	{
-		(*timer)->m_tLast = GetNow();
+		(*timer)->m_tLast.QuadPart = (*timer)->_getNow();
+	}
+}
+
+LONGLONG e2d::ETimerManager::_getNextTimerDelay()
+{
+	LONGLONG nDelay = -1;
+
+	for (auto timer = s_vTimers.begin(); timer != s_vTimers.end(); timer++)
+	{
+		ETimer * t = (*timer);
+		if (!t->m_bRunning ||
+			!t->m_pParentNode ||
+			t->m_pParentNode->getParentScene() != EApp::getCurrentScene())
+			continue;
+
+		if ((t->m_bAtOnce && t->m_nRunTimes == 0) || t->m_nInterval.QuadPart == 0)
+			return 0;
+
+		LONGLONG nRemain = t->m_tLast.QuadPart + t->m_nInterval.QuadPart - t->_getNow();
+		if (nRemain <= 0)
+			return 0;
+
+		// ڵʱź󣬻Ϊʵʾʱ䣬ʱֹͣʱҪ
+		float scale = t->m_pParentNode->_getGlobalTimeScale();
+		if (scale <= 0)
+			continue;
+		if (scale != 1)
+			nRemain = static_cast<LONGLONG>(ceil(nRemain / double(scale)));
+
+		if (nDelay < 0 || nRemain < nDelay)
+			nDelay = nRemain;
 	}
+	return nDelay;
 }
 
 void e2d::ETimerManager::startAllTimers()
@@ -0,0 +1,21 @@
+#include "..\ecommon.h"
+
+bool e2d::EInputEvent::isMouseMsg() const
+{
+	return m_nMsg >= EMouseMsg::MOVE && m_nMsg <= EMouseMsg::WHEEL;
+}
+
+e2d::EPoint e2d::EInputEvent::getPos() const
+{
+	return EPoint(LOWORD(m_lParam), HIWORD(m_lParam));
+}
+
+int e2d::EInputEvent::getWheelDelta() const
+{
+	return GET_WHEEL_DELTA_WPARAM(m_wParam);
+}
+
+e2d::EKeyboardMsg::KEY e2d::EInputEvent::getKeyValue() const
+{
+	return EKeyboardMsg::KEY(m_wParam);
+}
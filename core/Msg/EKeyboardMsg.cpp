@@ -1,31 +1,46 @@
 #include "..\ecommon.h"
+#include <bitset>
 
-UINT e2d::EKeyboardMsg::s_nMsg = 0;
-WPARAM e2d::EKeyboardMsg::s_wParam = 0;
-LPARAM e2d::EKeyboardMsg::s_lParam = 0;
+// ״ֵ̬
+static const size_t KEY_COUNT = 256;
+
+e2d::EInputEvent e2d::EKeyboardMsg::s_Event;
+
+// ڰ״̬İ
+static std::bitset<KEY_COUNT> s_KeysDown;
+// ֡µİ
+static std::bitset<KEY_COUNT> s_KeysPressed;
+// ̧֡İ
+static std::bitset<KEY_COUNT> s_KeysReleased;
 
 e2d::EKeyboardMsg::KEYBOARD_MSG e2d::EKeyboardMsg::getMsg()
 {
-	return KEYBOARD_MSG(EKeyboardMsg::s_nMsg);
+	return KEYBOARD_MSG(EKeyboardMsg::s_Event.m_nMsg);
 }
 
 e2d::EKeyboardMsg::KEY e2d::EKeyboardMsg::getKeyValue()
 {
-	return KEY(EKeyboardMsg::s_wParam);
+	return KEY(EKeyboardMsg::s_Event.m_wParam);
 }
 
 DWORD e2d::EKeyboardMsg::getCount()
 {
-	return (((DWORD)EKeyboardMsg::s_lParam) & 0x0000FFFF);
+	return (((DWORD)EKeyboardMsg::s_Event.m_lParam) & 0x0000FFFF);
 }
 
 bool e2d::EKeyboardMsg::isKeyDown(KEY key)
 {
-	if (::GetAsyncKeyState((int)key) & 0x8000)
-	{
-		return true;
-	}
-	return false;
+	return s_KeysDown.test(size_t(key) & (KEY_COUNT - 1));
+}
+
+bool e2d::EKeyboardMsg::wasPressedThisFrame(KEY key)
+{
+	return s_KeysPressed.test(size_t(key) & (KEY_COUNT - 1));
+}
+
+bool e2d::EKeyboardMsg::wasReleasedThisFrame(KEY key)
+{
+	return s_KeysReleased.test(size_t(key) & (KEY_COUNT - 1));
 }
 
 bool e2d::EKeyboardMsg::isCapitalLockOn()
@@ -54,3 +69,39 @@ bool e2d::EKeyboardMsg::isScrollLockOn()
 	}
 	return false;
 }
+
+const e2d::EInputEvent & e2d::EKeyboardMsg::getEvent()
+{
+	return EKeyboardMsg::s_Event;
+}
+
+void e2d::EKeyboardMsg::_beginFrame()
+{
+	s_KeysPressed.reset();
+	s_KeysReleased.reset();
+}
+
+void e2d::EKeyboardMsg::_updateKeyState(const EInputEvent & event)
+{
+	size_t key = size_t(event.m_wParam) & (KEY_COUNT - 1);
+
+	if (event.m_nMsg == KEY_DOWN)
+	{
+		// סʱظϢ
+		if (!s_KeysDown.test(key))
+		{
+			s_KeysDown.set(key);
+			s_KeysPressed.set(key);
+		}
+	}
+	else if (event.m_nMsg == KEY_UP)
+	{
+		s_KeysDown.reset(key);
+		s_KeysReleased.set(key);
+	}
+	else if (event.m_nMsg == WM_KILLFOCUS)
+	{
+		s_KeysReleased |= s_KeysDown;
+		s_KeysDown.reset();
+	}
+}
@@ -0,0 +1,152 @@
+#include "..\enodes.h"
+#include "..\Win\winbase.h"
+#include "..\Win\RenderFrame.h"
+#include "..\Win\Renderer.h"
+
+e2d::EBitmapText::EBitmapText()
+	: m_pFont(nullptr)
+{
+}
+
+e2d::EBitmapText::EBitmapText(EBitmapFont * font)
+	: m_pFont(nullptr)
+{
+	this->setFont(font);
+}
+
+e2d::EBitmapText::EBitmapText(const EString & text, EBitmapFont * font)
+	: m_pFont(nullptr)
+{
+	m_sText = text;
+	this->setFont(font);
+}
+
+e2d::EBitmapText::~EBitmapText()
+{
+	SafeRelease(&m_pFont);
+}
+
+e2d::EString e2d::EBitmapText::getText() const
+{
+	return m_sText;
+}
+
+e2d::EBitmapFont * e2d::EBitmapText::getFont() const
+{
+	return m_pFont;
+}
+
+void e2d::EBitmapText::setText(const EString & text)
+{
+	// δıʱҪ
+	if (m_sText == text)
+		return;
+
+	m_sText = text;
+	_initLayout();
+}
+
+void e2d::EBitmapText::setFont(EBitmapFont * font)
+{
+	if (font)
+	{
+		font->retain();
+		SafeRelease(&m_pFont);
+		m_pFont = font;
+
+		_initLayout();
+	}
+}
+
+void e2d::EBitmapText::_render()
+{
+	if (!m_pFont)
+		return;
+
+	size_t start = 0;
+	for (auto iter = m_vPageRuns.begin(); iter != m_vPageRuns.end(); iter++)
+	{
+		GetRenderer()->drawTextureBatch(
+			m_pFont->_getPage(iter->first),
+			&m_vDestRects[start],
+			&m_vSrcRects[start],
+			iter->second,
+			m_fDisplayOpacity
+		);
+		start += iter->second;
+	}
+}
+
+void e2d::EBitmapText::_record(ERenderFrame & frame)
+{
+	if (!m_pFont)
+		return;
+
+	size_t start = 0;
+	for (auto iter = m_vPageRuns.begin(); iter != m_vPageRuns.end(); iter++)
+	{
+		ETexture * pTexture = m_pFont->_getPage(iter->first);
+		ID2D1Bitmap * pBitmap = pTexture ? pTexture->_getBitmap() : nullptr;
+		for (size_t i = start; pBitmap && i < start + iter->second; i++)
+		{
+			ERenderItem & item = frame.add(ERenderItem::BITMAP, _getRenderTransform());
+			item.m_pBitmap = pBitmap;
+			item.m_pBitmap->AddRef();
+			item.m_fOpacity = m_fDisplayOpacity;
+			item.m_Rect = m_vDestRects[i];
+			item.m_SrcRect = m_vSrcRects[i];
+		}
+		start += iter->second;
+	}
+}
+
+void e2d::EBitmapText::_initLayout()
+{
+	// ıݻı䣬Ҫػ
+	_setDirty();
+
+	m_vQuads.clear();
+	m_vDestRects.clear();
+	m_vSrcRects.clear();
+	m_vPageRuns.clear();
+
+	if (!m_pFont || m_sText.isEmpty())
+	{
+		this->_setSize(0, 0);
+		return;
+	}
+
+	m_pFont->prepare(m_sText);
+
+	// ֮ǰֲٷڴ
+	float width, height;
+	m_pFont->m_Atlas.layout(m_sText, size_t(m_sText.length()), m_vQuads, width, height);
+	this->_setSize(width, height);
+
+	for (auto iter = m_vQuads.begin(); iter != m_vQuads.end(); iter++)
+	{
+		m_vDestRects.push_back(D2D1::RectF(iter->dest[0], iter->dest[1], iter->dest[2], iter->dest[3]));
+		m_vSrcRects.push_back(D2D1::RectF(iter->src[0], iter->src[1], iter->src[2], iter->src[3]));
+
+		if (m_vPageRuns.empty() || m_vPageRuns.back().first != iter->page)
+		{
+			m_vPageRuns.push_back(std::make_pair(iter->page, 0U));
+		}
+		m_vPageRuns.back().second++;
+	}
+}
+
+D2D1_RECT_F e2d::EBitmapText::_getDrawnBounds()
+{
+	D2D1_RECT_F bounds = ENode::_getDrawnBounds();
+
+	// εƫƿʹ䳬ŰõĿ
+	for (auto iter = m_vDestRects.begin(); iter != m_vDestRects.end(); iter++)
+	{
+		bounds.left = min(bounds.left, iter->left);
+		bounds.top = min(bounds.top, iter->top);
+		bounds.right = max(bounds.right, iter->right);
+		bounds.bottom = max(bounds.bottom, iter->bottom);
+	}
+	return bounds;
+}
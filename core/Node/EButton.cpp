@@ -221,6 +221,8 @@ void e2d::EButton::_init()
 {
 	m_pListener = new EListenerMouse(std::bind(&EButton::_updateStatus, this));
 	m_pListener->setAlwaysWorking(true);
+	// ֻλڰťϡ뿪ťº϶ʱ״̬
+	m_pListener->setHitTest(true);
 	EMsgManager::bindListener(m_pListener, this);
 }
 
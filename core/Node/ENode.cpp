@@ -4,11 +4,42 @@
 #include "..\eactions.h"
 #include "..\egeometry.h"
 #include "..\Win\winbase.h"
+#include "..\Win\RenderFrame.h"
+#include "..\Win\Renderer.h"
 #include <algorithm>
 
 // Ĭĵλ
 static float s_fDefaultPiovtX = 0;
 static float s_fDefaultPiovtY = 0;
+// ȾʱĲü
+static const D2D1_RECT_F * s_pRenderClip = nullptr;
+// ȾʱĲֵ
+static float s_fInterpolation = 1.0f;
+// 任ıڵ㱣Ĵ֮ͬʱŽвֵ
+static UINT s_nSavedTransform = 1;
+
+
+// жϾǷΪ
+static bool IsRectEmpty(const D2D1_RECT_F & rect)
+{
+	return rect.right <= rect.left || rect.bottom <= rect.top;
+}
+
+// жǷͬ
+static bool IsRectEqual(const D2D1_RECT_F & r1, const D2D1_RECT_F & r2)
+{
+	return r1.left == r2.left && r1.top == r2.top && r1.right == r2.right && r1.bottom == r2.bottom;
+}
+
+// жϽڵǷҪȾʾΪʱ޷жϣȾ
+static bool IsInRenderClip(const D2D1_RECT_F & rect)
+{
+	if (!s_pRenderClip || IsRectEmpty(rect))
+		return true;
+
+	return rect.left < s_pRenderClip->right && s_pRenderClip->left < rect.right &&
+		rect.top < s_pRenderClip->bottom && s_pRenderClip->top < rect.bottom;
+}
 
 e2d::ENode::ENode()
 	: m_nOrder(0)
@@ -23,14 +54,20 @@ e2d::ENode::ENode()
 	, m_fPivotY(s_fDefaultPiovtY)
 	, m_MatriInitial(D2D1::Matrix3x2F::Identity())
 	, m_MatriFinal(D2D1::Matrix3x2F::Identity())
+	, m_MatriPrevious(D2D1::Matrix3x2F::Identity())
+	, m_nSavedTransform(0)
 	, m_bVisiable(true)
 	, m_bDisplayedInScene(false)
 	, m_pGeometry(nullptr)
 	, m_pParent(nullptr)
 	, m_pParentScene(nullptr)
-	, m_nHashName(0)
 	, m_bSortChildrenNeeded(false)
 	, m_bTransformNeeded(false)
+	, m_bInverseNeeded(true)
+	, m_bBoundingBoxNeeded(true)
+	, m_bDirty(false)
+	, m_DrawnRect(D2D1::RectF())
+	, m_BoundingBox(D2D1::RectF())
 {
 }
 
@@ -47,14 +84,20 @@ e2d::ENode::ENode(const EString & name)
 	, m_fPivotY(s_fDefaultPiovtY)
 	, m_MatriInitial(D2D1::Matrix3x2F::Identity())
 	, m_MatriFinal(D2D1::Matrix3x2F::Identity())
+	, m_MatriPrevious(D2D1::Matrix3x2F::Identity())
+	, m_nSavedTransform(0)
 	, m_bVisiable(true)
 	, m_bDisplayedInScene(false)
 	, m_pGeometry(nullptr)
 	, m_pParent(nullptr)
 	, m_pParentScene(nullptr)
-	, m_nHashName(0)
 	, m_bSortChildrenNeeded(false)
 	, m_bTransformNeeded(false)
+	, m_bInverseNeeded(true)
+	, m_bBoundingBoxNeeded(true)
+	, m_bDirty(false)
+	, m_DrawnRect(D2D1::RectF())
+	, m_BoundingBox(D2D1::RectF())
 {
 	this->setName(name);
 }
@@ -113,9 +156,12 @@ void e2d::ENode::_update()
 			}
 		}
 
-		GetRenderTarget()->SetTransform(m_MatriFinal);
 		// Ⱦ
-		this->_render();
+		if (IsInRenderClip(m_DrawnRect))
+		{
+			GetRenderer()->setTransform(_getRenderTransform());
+			this->_render();
+		}
 
 		// ʣڵ
 		for (; i < size; i++)
@@ -123,9 +169,12 @@ void e2d::ENode::_update()
 	}
 	else
 	{
-		GetRenderTarget()->SetTransform(m_MatriFinal);
 		// Ⱦ
-		this->_render();
+		if (IsInRenderClip(m_DrawnRect))
+		{
+			GetRenderer()->setTransform(_getRenderTransform());
+			this->_render();
+		}
 	}
 }
 
@@ -223,6 +272,7 @@ void e2d::ENode::_updateTransform()
 	}
 	// ĵձ任
 	m_MatriFinal = m_MatriInitial * D2D1::Matrix3x2F::Translation(-pivot.x, -pivot.y);
+	m_bInverseNeeded = true;
 }
 
 void e2d::ENode::_updateChildrenTransform()
@@ -246,6 +296,94 @@ void e2d::ENode::_updateTransform(ENode * node)
 	node->_updateChildrenTransform();
 	// ־ִй任
 	node->m_bTransformNeeded = false;
+	// ڵڴеλøı䣬ΧҪ¼
+	node->_setBoundingBoxNeeded();
+}
+
+void e2d::ENode::_setTransformNeeded()
+{
+	m_bTransformNeeded = true;
+	_setBoundingBoxNeeded();
+}
+
+void e2d::ENode::_setBoundingBoxNeeded()
+{
+	// ڵİΧҪ¼ʱ丸ڵİΧһҲҪ¼
+	// ´ĽڵѱǵڵδǣıǲΪֹͣ
+	m_bBoundingBoxNeeded = true;
+	for (ENode * node = m_pParent; node && !node->m_bBoundingBoxNeeded; node = node->m_pParent)
+	{
+		node->m_bBoundingBoxNeeded = true;
+	}
+}
+
+void e2d::ENode::_updateBoundingBox()
+{
+	if (!m_bBoundingBoxNeeded)
+		return;
+
+	if (m_bTransformNeeded)
+	{
+		_updateTransform(this);
+	}
+
+	// ڵεĸ任Ӿ
+	const D2D1_POINT_2F corners[4] = {
+		m_MatriFinal.TransformPoint(D2D1::Point2F(0, 0)),
+		m_MatriFinal.TransformPoint(D2D1::Point2F(getRealWidth(), 0)),
+		m_MatriFinal.TransformPoint(D2D1::Point2F(0, getRealHeight())),
+		m_MatriFinal.TransformPoint(D2D1::Point2F(getRealWidth(), getRealHeight()))
+	};
+	m_BoundingBox = D2D1::RectF(corners[0].x, corners[0].y, corners[0].x, corners[0].y);
+	for (int i = 1; i < 4; i++)
+	{
+		m_BoundingBox.left = min(m_BoundingBox.left, corners[i].x);
+		m_BoundingBox.top = min(m_BoundingBox.top, corners[i].y);
+		m_BoundingBox.right = max(m_BoundingBox.right, corners[i].x);
+		m_BoundingBox.bottom = max(m_BoundingBox.bottom, corners[i].y);
+	}
+
+	// ϲӽڵİΧ
+	for (auto child = m_vChildren.begin(); child != m_vChildren.end(); child++)
+	{
+		(*child)->_updateBoundingBox();
+		const D2D1_RECT_F & box = (*child)->m_BoundingBox;
+		m_BoundingBox.left = min(m_BoundingBox.left, box.left);
+		m_BoundingBox.top = min(m_BoundingBox.top, box.top);
+		m_BoundingBox.right = max(m_BoundingBox.right, box.right);
+		m_BoundingBox.bottom = max(m_BoundingBox.bottom, box.bottom);
+	}
+	m_bBoundingBoxNeeded = false;
+}
+
+bool e2d::ENode::_containsPoint(const EPoint & point)
+{
+	if (m_bInverseNeeded)
+	{
+		// 󣬽任ؽڵ
+		const D2D1::Matrix3x2F & m = m_MatriFinal;
+		float det = m._11 * m._22 - m._12 * m._21;
+		if (det == 0)
+		{
+			// ڵ㱻Ϊ 0κε
+			m_MatriInverse = D2D1::Matrix3x2F(0, 0, 0, 0, -1, -1);
+		}
+		else
+		{
+			m_MatriInverse = D2D1::Matrix3x2F(
+				m._22 / det,
+				-m._12 / det,
+				-m._21 / det,
+				m._11 / det,
+				(m._21 * m._32 - m._22 * m._31) / det,
+				(m._12 * m._31 - m._11 * m._32) / det
+			);
+		}
+		m_bInverseNeeded = false;
+	}
+
+	D2D1_POINT_2F local = m_MatriInverse.TransformPoint(D2D1::Point2F(point.x, point.y));
+	return local.x >= 0 && local.y >= 0 && local.x <= getRealWidth() && local.y <= getRealHeight();
 }
 
 void e2d::ENode::_updateChildrenOpacity()
@@ -262,6 +400,7 @@ void e2d::ENode::_updateOpacity(ENode * node)
 	{
 		node->m_fDisplayOpacity = node->m_fRealOpacity * node->m_pParent->m_fDisplayOpacity;
 	}
+	node->m_bDirty = true;
 	node->_updateChildrenOpacity();
 }
 
@@ -272,7 +411,12 @@ bool e2d::ENode::isVisiable() const
 
 e2d::EString e2d::ENode::getName() const
 {
-	return m_sName;
+	return m_Name.toString();
+}
+
+const e2d::EName & e2d::ENode::getNameAtom() const
+{
+	return m_Name;
 }
 
 float e2d::ENode::getPosX() const
@@ -368,6 +512,7 @@ int e2d::ENode::getOrder() const
 void e2d::ENode::setOrder(int order)
 {
 	m_nOrder = order;
+	m_bDirty = true;
 }
 
 void e2d::ENode::setPosX(float x)
@@ -392,7 +537,7 @@ void e2d::ENode::setPos(float x, float y)
 
 	m_Pos.x = x;
 	m_Pos.y = y;
-	m_bTransformNeeded = true;
+	_setTransformNeeded();
 }
 
 void e2d::ENode::movePosX(float x)
@@ -437,7 +582,7 @@ void e2d::ENode::_setSize(float width, float height)
 
 	m_Size.width = width;
 	m_Size.height = height;
-	m_bTransformNeeded = true;
+	_setTransformNeeded();
 }
 
 void e2d::ENode::setScaleX(float scaleX)
@@ -462,7 +607,7 @@ void e2d::ENode::setScale(float scaleX, float scaleY)
 
 	m_fScaleX = scaleX;
 	m_fScaleY = scaleY;
-	m_bTransformNeeded = true;
+	_setTransformNeeded();
 }
 
 void e2d::ENode::setSkewX(float angleX)
@@ -482,7 +627,7 @@ void e2d::ENode::setSkew(float angleX, float angleY)
 
 	m_fSkewAngleX = angleX;
 	m_fSkewAngleY = angleY;
-	m_bTransformNeeded = true;
+	_setTransformNeeded();
 }
 
 void e2d::ENode::setRotation(float angle)
@@ -491,7 +636,7 @@ void e2d::ENode::setRotation(float angle)
 		return;
 
 	m_fRotation = angle;
-	m_bTransformNeeded = true;
+	_setTransformNeeded();
 }
 
 void e2d::ENode::setOpacity(float opacity)
@@ -521,7 +666,7 @@ void e2d::ENode::setPivot(float pivotX, float pivotY)
 
 	m_fPivotX = min(max(pivotX, 0), 1);
 	m_fPivotY = min(max(pivotY, 0), 1);
-	m_bTransformNeeded = true;
+	_setTransformNeeded();
 }
 
 void e2d::ENode::setGeometry(EGeometry * geometry)
@@ -561,12 +706,15 @@ void e2d::ENode::addChild(ENode * child, int order  /* = 0 */)
 
 		child->retain();
 
+		// ڵıʱ䱣֮µĸڵƽ
+		child->_getLocalTime();
 		child->m_pParent = this;
 
 		if (this->m_pParentScene)
 		{
 			child->_setParentScene(this->m_pParentScene);
 		}
+		child->_attachTime();
 
 		if (this->m_bDisplayedInScene)
 		{
@@ -576,7 +724,7 @@ void e2d::ENode::addChild(ENode * child, int order  /* = 0 */)
 		// ӽڵ͸
 		_updateOpacity(child);
 		// ½ڵת
-		child->m_bTransformNeeded = true;
+		child->_setTransformNeeded();
 		// ӽڵ
 		m_bSortChildrenNeeded = true;
 	}
@@ -606,12 +754,14 @@ e2d::ENode * e2d::ENode::getChild(const EString & name)
 {
 	WARN_IF(name.isEmpty(), "Invalid ENode name.");
 
-	unsigned int hash = name.hash();
+	// ƱвڵƲκνڵ
+	EName key = EName::find(name);
+	if (key.isEmpty())
+		return nullptr;
 
 	for (auto child = m_vChildren.begin(); child != m_vChildren.end(); child++)
 	{
-		// ͬƿܻͬ Hash ֵȱȽ Hash ٶ
-		if ((*child)->m_nHashName == hash && (*child)->m_sName == name)
+		if ((*child)->m_Name == key)
 			return (*child);
 	}
 	return nullptr;
@@ -642,11 +792,15 @@ bool e2d::ENode::removeChild(ENode * child)
 			if (m_vChildren[i] == child)
 			{
 				m_vChildren.erase(m_vChildren.begin() + i);
+				_setBoundingBoxNeeded();
+				child->_getLocalTime();
 				child->m_pParent = nullptr;
 				if (child->m_pParentScene)
 				{
+					child->_clearDrawnRect();
 					child->_setParentScene(nullptr);
 				}
+				child->_attachTime();
 				child->_onExit();
 				child->release();
 				return true;
@@ -665,21 +819,29 @@ void e2d::ENode::removeChild(const EString & childName)
 		return;
 	}
 
-	//  Hash ֵ
-	unsigned int hash = childName.hash();
+	// ƱвڵƲκνڵ
+	EName key = EName::find(childName);
+	if (key.isEmpty())
+	{
+		return;
+	}
 
 	size_t size = m_vChildren.size();
 	for (size_t i = 0; i < size; i++)
 	{
 		auto child = m_vChildren[i];
-		if (child->m_nHashName == hash && child->m_sName == childName)
+		if (child->m_Name == key)
 		{
 			m_vChildren.erase(m_vChildren.begin() + i);
+			_setBoundingBoxNeeded();
+			child->_getLocalTime();
 			child->m_pParent = nullptr;
 			if (child->m_pParentScene)
 			{
+				child->_clearDrawnRect();
 				child->_setParentScene(nullptr);
 			}
+			child->_attachTime();
 			child->_onExit();
 			child->release();
 			return;
@@ -692,11 +854,13 @@ void e2d::ENode::clearAllChildren()
 	// нڵüһ
 	for (auto child = m_vChildren.begin(); child != m_vChildren.end(); child++)
 	{
+		(*child)->_clearDrawnRect();
 		(*child)->_onExit();
 		(*child)->release();
 	}
 	// մڵ
 	m_vChildren.clear();
+	_setBoundingBoxNeeded();
 }
 
 void e2d::ENode::runAction(EAction * action)
@@ -725,28 +889,63 @@ void e2d::ENode::pauseAction(EAction * action)
 	}
 }
 
+bool e2d::ENode::_pick(const EPoint & point, std::vector<ENode*> & path)
+{
+	if (!m_bVisiable)
+		return false;
+
+	_updateBoundingBox();
+	if (point.x < m_BoundingBox.left || point.x > m_BoundingBox.right ||
+		point.y < m_BoundingBox.top || point.y > m_BoundingBox.bottom)
+	{
+		return false;
+	}
+
+	this->_sortChildren();
+
+	// ˳෴ Order Сӽڵ㣬Ȼ Order Сӽڵ
+	size_t i = m_vChildren.size();
+	for (; i > 0 && m_vChildren[i - 1]->getOrder() >= 0; i--)
+	{
+		if (m_vChildren[i - 1]->_pick(point, path))
+		{
+			path.push_back(this);
+			return true;
+		}
+	}
+
+	if (_containsPoint(point))
+	{
+		path.push_back(this);
+		return true;
+	}
+
+	for (; i > 0; i--)
+	{
+		if (m_vChildren[i - 1]->_pick(point, path))
+		{
+			path.push_back(this);
+			return true;
+		}
+	}
+	return false;
+}
+
 bool e2d::ENode::isPointIn(EPoint point)
 {
 	if (m_bTransformNeeded)
 	{
 		_updateTransform(this);
 	}
-	// Ϊڵ㴴һ״
-	ID2D1RectangleGeometry * rect;
-	GetFactory()->CreateRectangleGeometry(
-		D2D1::RectF(0, 0, getRealWidth(), getRealHeight()),
-		&rect
-	);
-	// жϵǷ״
-	BOOL ret;
-	rect->FillContainsPoint(
-		D2D1::Point2F(
-			point.x,
-			point.y),
-		&m_MatriFinal,
-		&ret
-	);
-	if (ret)
+	// 㲻ڽڵ㼰ӽڵİΧʱҪж
+	_updateBoundingBox();
+	if (point.x < m_BoundingBox.left || point.x > m_BoundingBox.right ||
+		point.y < m_BoundingBox.top || point.y > m_BoundingBox.bottom)
+	{
+		return false;
+	}
+	// жϵǷڽڵ
+	if (_containsPoint(point))
 	{
 		return true;
 	}
@@ -759,6 +958,68 @@ bool e2d::ENode::isPointIn(EPoint point)
 	return false;
 }
 
+void e2d::ENode::setTimeScale(float scale)
+{
+	// ֮ǰʱ䰴ԭı
+	_getLocalTime();
+	m_Clock.setTimeScale(scale);
+}
+
+float e2d::ENode::getTimeScale() const
+{
+	return m_Clock.getTimeScale();
+}
+
+void e2d::ENode::setTimePaused(bool paused)
+{
+	_getLocalTime();
+	m_Clock.setPaused(paused);
+}
+
+bool e2d::ENode::isTimePaused() const
+{
+	return m_Clock.isPaused();
+}
+
+LONGLONG e2d::ENode::_getLocalTime()
+{
+	// ڵʱֻҪʱ游ڵƽűıǰȸһΣ˽֡ƽͬ
+	return m_Clock.follow(_getParentTime());
+}
+
+LONGLONG e2d::ENode::_getParentTime()
+{
+	if (m_pParent)
+	{
+		return m_pParent->_getLocalTime();
+	}
+	if (m_pParentScene)
+	{
+		// ĸڵ泡ʱ
+		return m_pParentScene->m_Clock.getTime();
+	}
+	return GetNow().QuadPart;
+}
+
+float e2d::ENode::_getGlobalTimeScale() const
+{
+	float scale = m_Clock.getEffectiveScale();
+	if (m_pParent)
+	{
+		return scale * m_pParent->_getGlobalTimeScale();
+	}
+	if (m_pParentScene)
+	{
+		return scale * m_pParentScene->m_Clock.getEffectiveScale();
+	}
+	return scale;
+}
+
+void e2d::ENode::_attachTime()
+{
+	m_Clock.attach(_getParentTime());
+}
+
 void e2d::ENode::setDefaultPiovt(float defaultPiovtX, float defaultPiovtY)
 {
 	s_fDefaultPiovtX = min(max(defaultPiovtX, 0), 1);
@@ -803,10 +1064,8 @@ void e2d::ENode::setName(const EString & name)
 
 	if (!name.isEmpty())
 	{
-		// ڵ
-		m_sName = name;
-		// ڵ Hash 
-		m_nHashName = name.hash();
+		// ڵͬƹƱеͬһ
+		m_Name = EName(name);
 	}
 }
 
@@ -817,4 +1076,229 @@ void e2d::ENode::_setParentScene(EScene * scene)
 	{
 		(*child)->_setParentScene(scene);
 	}
+}
+
+void e2d::ENode::_setDirty()
+{
+	m_bDirty = true;
+}
+
+void e2d::ENode::_updateDirtyRect(bool visiable)
+{
+	visiable = visiable && m_bVisiable;
+
+	if (visiable && m_bTransformNeeded)
+	{
+		_updateTransform(this);
+	}
+
+	// ƷΧĸ任Ӿ
+	D2D1_RECT_F rect = D2D1::RectF();
+	D2D1_RECT_F bounds = visiable ? _getDrawnBounds() : D2D1::RectF();
+	if (!IsRectEmpty(bounds))
+	{
+		D2D1::Matrix3x2F matrix = _getRenderTransform();
+		D2D1_POINT_2F points[4] = {
+			matrix.TransformPoint(D2D1::Point2F(bounds.left, bounds.top)),
+			matrix.TransformPoint(D2D1::Point2F(bounds.right, bounds.top)),
+			matrix.TransformPoint(D2D1::Point2F(bounds.left, bounds.bottom)),
+			matrix.TransformPoint(D2D1::Point2F(bounds.right, bounds.bottom))
+		};
+		rect = D2D1::RectF(points[0].x, points[0].y, points[0].x, points[0].y);
+		for (int i = 1; i < 4; i++)
+		{
+			rect.left = min(rect.left, points[i].x);
+			rect.top = min(rect.top, points[i].y);
+			rect.right = max(rect.right, points[i].x);
+			rect.bottom = max(rect.bottom, points[i].y);
+		}
+	}
+
+	// Ҫػ
+	if (m_pParentScene && (m_bDirty || !IsRectEqual(rect, m_DrawnRect)))
+	{
+		if (!IsRectEmpty(m_DrawnRect))
+			m_pParentScene->_addDirtyRect(m_DrawnRect);
+		if (!IsRectEmpty(rect))
+			m_pParentScene->_addDirtyRect(rect);
+	}
+	m_DrawnRect = rect;
+	m_bDirty = false;
+
+	for (auto child = m_vChildren.begin(); child != m_vChildren.end(); child++)
+	{
+		(*child)->_updateDirtyRect(visiable);
+	}
+}
+
+D2D1_RECT_F e2d::ENode::_getDrawnBounds()
+{
+	return D2D1::RectF(0, 0, getRealWidth(), getRealHeight());
+}
+
+void e2d::ENode::_clearDrawnRect()
+{
+	if (m_pParentScene && !IsRectEmpty(m_DrawnRect))
+	{
+		m_pParentScene->_addDirtyRect(m_DrawnRect);
+	}
+	m_DrawnRect = D2D1::RectF();
+
+	for (auto child = m_vChildren.begin(); child != m_vChildren.end(); child++)
+	{
+		(*child)->_clearDrawnRect();
+	}
+}
+
+void e2d::ENode::_setRenderClip(const D2D1_RECT_F * clip)
+{
+	s_pRenderClip = clip;
+}
+
+void e2d::ENode::_saveTransform()
+{
+	if (m_bTransformNeeded)
+	{
+		_updateTransform(this);
+	}
+	m_MatriPrevious = m_MatriFinal;
+	m_nSavedTransform = s_nSavedTransform;
+
+	for (auto child = m_vChildren.begin(); child != m_vChildren.end(); child++)
+	{
+		(*child)->_saveTransform();
+	}
+}
+
+D2D1::Matrix3x2F e2d::ENode::_getRenderTransform() const
+{
+	// ϴαż볡Ľڵûвֵ
+	if (s_fInterpolation >= 1.0f || m_nSavedTransform != s_nSavedTransform)
+	{
+		return m_MatriFinal;
+	}
+
+	// Բֵÿθ¼ı仯СתҲԽƴ
+	float a = s_fInterpolation;
+	float b = 1.0f - a;
+	return D2D1::Matrix3x2F(
+		m_MatriPrevious._11 * b + m_MatriFinal._11 * a,
+		m_MatriPrevious._12 * b + m_MatriFinal._12 * a,
+		m_MatriPrevious._21 * b + m_MatriFinal._21 * a,
+		m_MatriPrevious._22 * b + m_MatriFinal._22 * a,
+		m_MatriPrevious._31 * b + m_MatriFinal._31 * a,
+		m_MatriPrevious._32 * b + m_MatriFinal._32 * a
+	);
+}
+
+void e2d::ENode::_saveTransforms(ENode * root)
+{
+	s_nSavedTransform++;
+	root->_saveTransform();
+}
+
+void e2d::ENode::_setInterpolation(float alpha)
+{
+	s_fInterpolation = min(max(alpha, 0), 1);
+}
+
+void e2d::ENode::_snapshot(ERenderFrame & frame)
+{
+	if (!m_bVisiable)
+	{
+		return;
+	}
+
+	if (m_bTransformNeeded)
+	{
+		_updateTransform(this);
+	}
+
+	//  _update ķ˳ͬ
+	this->_sortChildren();
+
+	size_t size = m_vChildren.size();
+	size_t i;
+	for (i = 0; i < size && m_vChildren[i]->getOrder() < 0; i++)
+	{
+		m_vChildren[i]->_snapshot(frame);
+	}
+
+	this->_record(frame);
+
+	for (; i < size; i++)
+	{
+		m_vChildren[i]->_snapshot(frame);
+	}
+}
+
+void e2d::ENode::_record(ERenderFrame & frame)
+{
+	ERenderItem & item = frame.add(ERenderItem::NODE, _getRenderTransform());
+	item.m_pNode = this;
+	this->retain();
+}
+
+void e2d::ENode::_snapshotGeometry(ERenderFrame & frame)
+{
+	if (m_pGeometry && m_pGeometry->m_bIsVisiable && m_pGeometry->m_pTransformedGeometry)
+	{
+		ERenderItem & item = frame.add(ERenderItem::GEOMETRY, D2D1::Matrix3x2F::Identity());
+		item.m_pGeometry = m_pGeometry->m_pTransformedGeometry;
+		item.m_pGeometry->AddRef();
+		item.m_nColor = m_pGeometry->m_nColor;
+		item.m_fOpacity = m_pGeometry->m_fOpacity;
+	}
+
+	for (auto child = m_vChildren.begin(); child != m_vChildren.end(); child++)
+	{
+		(*child)->_snapshotGeometry(frame);
+	}
+}
+
+void e2d::ENode::_renderItem(const ERenderItem & item)
+{
+	GetRenderTarget()->SetTransform(item.m_Transform);
+
+	switch (item.m_eType)
+	{
+	case ERenderItem::NODE:
+		item.m_pNode->_render();
+		break;
+
+	case ERenderItem::BITMAP:
+		GetRenderTarget()->DrawBitmap(
+			item.m_pBitmap,
+			item.m_Rect,
+			item.m_fOpacity,
+			D2D1_BITMAP_INTERPOLATION_MODE_LINEAR,
+			item.m_SrcRect
+		);
+		break;
+
+	case ERenderItem::TEXT:
+		GetSolidColorBrush()->SetColor(D2D1::ColorF(item.m_nColor, item.m_fOpacity));
+		GetRenderTarget()->DrawTextW(
+			item.m_sText.c_str(),
+			UINT32(item.m_sText.length()),
+			item.m_pTextFormat,
+			item.m_Rect,
+			GetSolidColorBrush()
+		);
+		break;
+
+	case ERenderItem::TEXT_LAYOUT:
+		GetSolidColorBrush()->SetColor(D2D1::ColorF(item.m_nColor, item.m_fOpacity));
+		GetRenderTarget()->DrawTextLayout(
+			D2D1::Point2F(0, 0),
+			item.m_pTextLayout,
+			GetSolidColorBrush()
+		);
+		break;
+
+	case ERenderItem::GEOMETRY:
+		GetSolidColorBrush()->SetColor(D2D1::ColorF(item.m_nColor, item.m_fOpacity));
+		GetRenderTarget()->DrawGeometry(item.m_pGeometry, GetSolidColorBrush());
+		break;
+	}
 }
\ No newline at end of file
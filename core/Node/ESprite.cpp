@@ -1,5 +1,7 @@
 #include "..\enodes.h"
 #include "..\Win\winbase.h"
+#include "..\Win\RenderFrame.h"
+#include "..\Win\Renderer.h"
 
 
 e2d::ESprite::ESprite()
@@ -75,6 +77,7 @@ void e2d::ESprite::loadFrom(ETexture * texture)
 		m_fSourceClipX = m_fSourceClipY = 0;
 		ENode::_setWidth(m_pTexture->getSourceWidth());
 		ENode::_setHeight(m_pTexture->getSourceHeight());
+		ENode::_setDirty();
 	}
 }
 
@@ -109,18 +112,18 @@ void e2d::ESprite::clip(float x, float y, float width, float height)
 	m_fSourceClipY = min(max(y, 0), m_pTexture->getSourceHeight());
 	ENode::_setWidth(min(max(width, 0), m_pTexture->getSourceWidth() - m_fSourceClipX));
 	ENode::_setHeight(min(max(height, 0), m_pTexture->getSourceHeight() - m_fSourceClipY));
+	ENode::_setDirty();
 }
 
 void e2d::ESprite::_render()
 {
-	if (m_pTexture && m_pTexture->_getBitmap())
+	if (m_pTexture)
 	{
 		// Draw bitmap
-		GetRenderTarget()->DrawBitmap(
-			m_pTexture->_getBitmap(),
+		GetRenderer()->drawTexture(
+			m_pTexture,
 			D2D1::RectF(0, 0, getRealWidth(), getRealHeight()),
 			m_fDisplayOpacity,
-			D2D1_BITMAP_INTERPOLATION_MODE_LINEAR,
 			D2D1::RectF(
 				m_fSourceClipX, 
 				m_fSourceClipY, 
@@ -130,3 +133,23 @@ void e2d::ESprite::_render()
 		);
 	}
 }
+
+void e2d::ESprite::_record(ERenderFrame & frame)
+{
+	// Resolve the bitmap on the update thread and keep it alive until the frame is drawn
+	ID2D1Bitmap * pBitmap = m_pTexture ? m_pTexture->_getBitmap() : nullptr;
+	if (pBitmap)
+	{
+		ERenderItem & item = frame.add(ERenderItem::BITMAP, _getRenderTransform());
+		item.m_pBitmap = pBitmap;
+		item.m_pBitmap->AddRef();
+		item.m_fOpacity = m_fDisplayOpacity;
+		item.m_Rect = D2D1::RectF(0, 0, getRealWidth(), getRealHeight());
+		item.m_SrcRect = D2D1::RectF(
+			m_fSourceClipX,
+			m_fSourceClipY,
+			m_fSourceClipX + getRealWidth(),
+			m_fSourceClipY + getRealHeight()
+		);
+	}
+}
@@ -1,10 +1,14 @@
 #include "..\enodes.h"
 #include "..\Win\winbase.h"
+#include "..\Win\RenderFrame.h"
+#include "..\Win\Renderer.h"
 
 e2d::EText::EText()
 	: m_bWordWrapping(false)
 	, m_pFont(nullptr)
 	, m_fWordWrappingWidth(0)
+	, m_pTextLayout(nullptr)
+	, m_pLayoutFormat(nullptr)
 {
 	this->setFont(new EFont());
 }
@@ -13,6 +17,8 @@ e2d::EText::EText(const EString & text)
 	: m_bWordWrapping(false)
 	, m_pFont(nullptr)
 	, m_fWordWrappingWidth(0)
+	, m_pTextLayout(nullptr)
+	, m_pLayoutFormat(nullptr)
 {
 	this->setText(text);
 	this->setFont(new EFont());
@@ -22,6 +28,8 @@ e2d::EText::EText(EFont * font)
 	: m_bWordWrapping(false)
 	, m_pFont(nullptr)
 	, m_fWordWrappingWidth(0)
+	, m_pTextLayout(nullptr)
+	, m_pLayoutFormat(nullptr)
 {
 	this->setFont(font);
 }
@@ -30,6 +38,8 @@ e2d::EText::EText(const EString & text, EFont * font)
 	: m_bWordWrapping(false)
 	, m_pFont(nullptr)
 	, m_fWordWrappingWidth(0)
+	, m_pTextLayout(nullptr)
+	, m_pLayoutFormat(nullptr)
 {
 	this->setText(text);
 	this->setFont(font);
@@ -39,6 +49,8 @@ e2d::EText::EText(const EString & text, EString fontFamily, float fontSize, UINT
 	: m_bWordWrapping(false)
 	, m_pFont(nullptr)
 	, m_fWordWrappingWidth(0)
+	, m_pTextLayout(nullptr)
+	, m_pLayoutFormat(nullptr)
 {
 	this->setText(text);
 	this->setFont(new EFont(fontFamily, fontSize, color, fontWeight, italic));
@@ -46,6 +58,8 @@ e2d::EText::EText(const EString & text, EString fontFamily, float fontSize, UINT
 
 e2d::EText::~EText()
 {
+	SafeReleaseInterface(&m_pTextLayout);
+	SafeReleaseInterface(&m_pLayoutFormat);
 	SafeRelease(&m_pFont);
 }
 
@@ -101,62 +115,108 @@ void e2d::EText::setWordWrappingWidth(float wordWrapWidth)
 
 void e2d::EText::_render()
 {
-	GetSolidColorBrush()->SetColor(D2D1::ColorF(m_pFont->m_Color, m_fDisplayOpacity));
-	GetRenderTarget()->DrawTextW(
-		m_sText,
-		UINT32(m_sText.length()),
-		m_pFont->_getTextFormat(),
-		D2D1::RectF(
-			0,
-			0,
-			m_bWordWrapping ? m_fWordWrappingWidth : m_Size.width,
-			getRealHeight()
-		),
-		GetSolidColorBrush()
-	);
+	// ʽ޸ĺ TextFormat ᱻ´ʱҪŰ
+	if (m_pFont && m_pFont->_getTextFormat() != m_pLayoutFormat)
+	{
+		_initTextLayout();
+	}
+
+	if (m_pTextLayout)
+	{
+		GetRenderer()->drawTextLayout(
+			m_pTextLayout,
+			m_pFont->m_Color,
+			m_fDisplayOpacity
+		);
+	}
 }
 
-void e2d::EText::_initTextLayout()
+void e2d::EText::_record(ERenderFrame & frame)
 {
-	// δַʱıΪ 0
-	if (!m_pFont || m_sText.isEmpty())
+	if (m_pFont && m_pFont->_getTextFormat() != m_pLayoutFormat)
+	{
+		_initTextLayout();
+	}
+
+	if (!m_pTextLayout)
 	{
-		this->_setHeight(0);
-		m_fWordWrappingWidth = 0;
 		return;
 	}
 
-	// δıԶʱ TextFormat Ϊ
-	if (!m_bWordWrapping)
+	// Űɺ TextLayout ޸ģͼ̳߳
+	ERenderItem & item = frame.add(ERenderItem::TEXT_LAYOUT, _getRenderTransform());
+	item.m_pTextLayout = m_pTextLayout;
+	item.m_pTextLayout->AddRef();
+	item.m_nColor = m_pFont->m_Color;
+	item.m_fOpacity = m_fDisplayOpacity;
+}
+
+D2D1_RECT_F e2d::EText::_getDrawnBounds()
+{
+	D2D1_RECT_F bounds = ENode::_getDrawnBounds();
+
+	// б塢ֺŵ±ʻᳬ
+	DWRITE_OVERHANG_METRICS overhang;
+	if (m_pTextLayout && SUCCEEDED(m_pTextLayout->GetOverhangMetrics(&overhang)))
+	{
+		bounds.left -= max(overhang.left, 0);
+		bounds.top -= max(overhang.top, 0);
+		bounds.right += max(overhang.right, 0);
+		bounds.bottom += max(overhang.bottom, 0);
+	}
+	return bounds;
+}
+
+void e2d::EText::_initTextLayout()
+{
+	// ıݻʽı䣬Ҫػ
+	_setDirty();
+
+	// ͷ֮ǰŰ
+	SafeReleaseInterface(&m_pTextLayout);
+	SafeReleaseInterface(&m_pLayoutFormat);
+
+	// ¼Űʱʹõ TextFormatַʱҲҪ¼ÿ֡Ű沢ػ
+	if (m_pFont)
 	{
-		m_pFont->_getTextFormat()->SetWordWrapping(DWRITE_WORD_WRAPPING_NO_WRAP);
+		m_pLayoutFormat = m_pFont->_getTextFormat();
+		if (m_pLayoutFormat)
+		{
+			m_pLayoutFormat->AddRef();
+		}
 	}
-	else
+
+	// δַʱıΪ 0
+	if (!m_pFont || m_sText.isEmpty())
 	{
-		m_pFont->_getTextFormat()->SetWordWrapping(DWRITE_WORD_WRAPPING_WRAP);
+		this->_setHeight(0);
+		m_fWordWrappingWidth = 0;
+		return;
 	}
-	
-	// ȡ TextLayout
-	IDWriteTextLayout * pDWriteTextLayout = nullptr;
 
+	//  TextLayoutݡͻòʱظʹ
 	HRESULT hr = GetDirectWriteFactory()->CreateTextLayout(
 		m_sText,
 		UINT32(m_sText.length()),
-		m_pFont->_getTextFormat(),
+		m_pLayoutFormat,
 		m_bWordWrapping ? m_fWordWrappingWidth : 0,
 		0,
-		&pDWriteTextLayout
+		&m_pTextLayout
 	);
 
-	ASSERT(SUCCEEDED(hr), "Create IDWriteTextFormat Failed!");
+	ASSERT(SUCCEEDED(hr), "Create IDWriteTextLayout Failed!");
+
+	// зʽǲֵԣTextFormat ɶ干ã޸
+	m_pTextLayout->SetWordWrapping(m_bWordWrapping ? DWRITE_WORD_WRAPPING_WRAP : DWRITE_WORD_WRAPPING_NO_WRAP);
 
 	// ȡıֵĿȺ͸߶
 	DWRITE_TEXT_METRICS metrics;
-	pDWriteTextLayout->GetMetrics(&metrics);
+	m_pTextLayout->GetMetrics(&metrics);
 
 	this->_setSize(metrics.widthIncludingTrailingWhitespace, metrics.height);
 	m_fWordWrappingWidth = metrics.widthIncludingTrailingWhitespace;
 
-	// ɾԴ
-	SafeReleaseInterface(&pDWriteTextLayout);
+	// ڵСһ£ʹֵĶ뷽ʽЧ
+	m_pTextLayout->SetMaxWidth(metrics.widthIncludingTrailingWhitespace);
+	m_pTextLayout->SetMaxHeight(metrics.height);
 }
@@ -1,6 +1,7 @@
 #include "..\etools.h"
 #include <mmsystem.h>
 #include "..\Win\MciPlayer.h"
+#include "PackStorage.h"
 #include <map>
 
 typedef std::pair<UINT, MciPlayer *> Music;
@@ -47,7 +48,18 @@ UINT e2d::EMusicUtils::preloadMusic(const EString & musicFilePath)
 
 	getMciPlayerList().insert(Music(nRet, new MciPlayer()));
 	MciPlayer * pPlayer = getMciPlayerList()[nRet];
-	pPlayer->open(musicFilePath, nRet);
+
+	// ȴѹصԴжȡ
+	PackFileData file;
+	if (ReadPackFile(musicFilePath, file))
+	{
+		EString extension = EFileUtils::getFileExtension(musicFilePath);
+		pPlayer->open(file.data, file.size, extension.sub(1), nRet);
+	}
+	else
+	{
+		pPlayer->open(musicFilePath, nRet);
+	}
 
 	if (nRet == pPlayer->getMusicID()) return nRet;
 
@@ -0,0 +1,204 @@
+#include "..\etools.h"
+#include "..\Win\winbase.h"
+#include "PackFile.h"
+#include "PackStorage.h"
+
+
+// ڴӳԴ
+class PackMapping
+{
+public:
+	PackMapping()
+		: m_hFile(INVALID_HANDLE_VALUE)
+		, m_hMapping(nullptr)
+		, m_pView(nullptr)
+	{
+	}
+
+	~PackMapping()
+	{
+		if (m_pView)
+			::UnmapViewOfFile(m_pView);
+		if (m_hMapping)
+			::CloseHandle(m_hMapping);
+		if (m_hFile != INVALID_HANDLE_VALUE)
+			::CloseHandle(m_hFile);
+	}
+
+	bool open(const e2d::EString & filePath)
+	{
+		m_hFile = ::CreateFileW(filePath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, NULL);
+		if (m_hFile == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER fileSize;
+		if (!::GetFileSizeEx(m_hFile, &fileSize) || fileSize.QuadPart <= 0 || static_cast<ULONGLONG>(fileSize.QuadPart) > SIZE_MAX)
+			return false;
+
+		m_hMapping = ::CreateFileMappingW(m_hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (!m_hMapping)
+			return false;
+
+		m_pView = ::MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0);
+		if (!m_pView)
+			return false;
+
+		return PackFile::parse(m_pView, static_cast<size_t>(fileSize.QuadPart), m_View);
+	}
+
+	PackFile::View & getView() { return m_View; }
+
+	e2d::EString m_sPath;
+
+private:
+	HANDLE m_hFile;
+	HANDLE m_hMapping;
+	void * m_pView;
+	PackFile::View m_View;
+};
+
+// ѹصԴصں
+static std::vector<std::shared_ptr<PackMapping>> s_vPacks;
+// ״̬İ汾
+static UINT s_nGeneration = 0;
+
+
+// ȡԴĹ淶·жǷΪͬһԴ
+static e2d::EString GetPackPath(const e2d::EString & packFilePath)
+{
+	wchar_t fullPath[MAX_PATH];
+	DWORD length = ::GetFullPathNameW(packFilePath, MAX_PATH, fullPath, NULL);
+	if (length == 0 || length >= MAX_PATH)
+		return packFilePath.lower();
+	return e2d::EString(fullPath).lower();
+}
+
+// ѹصԴвļ
+static std::shared_ptr<PackMapping> FindPackEntry(const std::string & name, PackFile::Entry & entry)
+{
+	for (auto iter = s_vPacks.rbegin(); iter != s_vPacks.rend(); iter++)
+	{
+		if (PackFile::find((*iter)->getView(), name.c_str(), entry))
+		{
+			return *iter;
+		}
+	}
+	return nullptr;
+}
+
+
+bool e2d::EPackUtils::mount(const EString & packFilePath)
+{
+	WARN_IF(packFilePath.isEmpty(), "EPackUtils cannot mount pack from NULL file name.");
+	if (packFilePath.isEmpty())
+		return false;
+
+	EString path = GetPackPath(packFilePath);
+	for (auto iter = s_vPacks.begin(); iter != s_vPacks.end(); iter++)
+	{
+		if ((*iter)->m_sPath == path)
+			return true;
+	}
+
+	std::shared_ptr<PackMapping> pack(new PackMapping());
+	if (!pack->open(packFilePath))
+	{
+		WARN_IF(true, "Mount pack file failed!");
+		return false;
+	}
+
+	pack->m_sPath = path;
+	s_vPacks.push_back(pack);
+	s_nGeneration++;
+	return true;
+}
+
+void e2d::EPackUtils::unmount(const EString & packFilePath)
+{
+	EString path = GetPackPath(packFilePath);
+	for (auto iter = s_vPacks.begin(); iter != s_vPacks.end(); iter++)
+	{
+		if ((*iter)->m_sPath == path)
+		{
+			// ʹõݳԴãڴӳͷźر
+			s_vPacks.erase(iter);
+			s_nGeneration++;
+			return;
+		}
+	}
+}
+
+void e2d::EPackUtils::unmountAll()
+{
+	if (!s_vPacks.empty())
+	{
+		s_vPacks.clear();
+		s_nGeneration++;
+	}
+}
+
+bool e2d::EPackUtils::exists(const EString & fileName)
+{
+	if (s_vPacks.empty() || fileName.isEmpty())
+		return false;
+
+	PackFile::Entry entry;
+	return FindPackEntry(fileName.toUtf8(), entry) != nullptr;
+}
+
+
+bool ReadPackFile(const e2d::EString & fileName, PackFileData & file)
+{
+	if (s_vPacks.empty() || fileName.isEmpty())
+		return false;
+
+	PackFile::Entry entry;
+	std::shared_ptr<PackMapping> pack = FindPackEntry(fileName.toUtf8(), entry);
+	if (!pack)
+		return false;
+
+	file.pack = pack;
+	file.size = static_cast<size_t>(entry.size);
+
+	if (!PackFile::isCompressed(entry))
+	{
+		// ֱʹڴӳе
+		file.data = PackFile::getData(pack->getView(), entry);
+		return true;
+	}
+
+	file.buffer.resize(file.size);
+	if (file.size && !PackFile::extract(pack->getView(), entry, &file.buffer[0], file.size))
+	{
+		WARN_IF(true, "Pack file data is corrupt!");
+		return false;
+	}
+	file.data = file.size ? &file.buffer[0] : nullptr;
+	return true;
+}
+
+void GetPackFiles(const e2d::EString & extension, std::vector<e2d::EString> & fileNames)
+{
+	std::string ext = extension.toUtf8();
+
+	for (auto iter = s_vPacks.begin(); iter != s_vPacks.end(); iter++)
+	{
+		PackFile::View & view = (*iter)->getView();
+		for (unsigned int i = 0; i < view.entryCount; i++)
+		{
+			PackFile::Entry entry;
+			PackFile::getEntry(view, i, entry);
+
+			if (entry.nameLength < ext.length() ||
+				_strnicmp(entry.name + entry.nameLength - ext.length(), ext.c_str(), ext.length()) != 0)
+				continue;
+
+			fileNames.push_back(e2d::EString::fromUtf8(entry.name, entry.nameLength));
+		}
+	}
+}
+
+UINT GetPackGeneration()
+{
+	return s_nGeneration;
+}
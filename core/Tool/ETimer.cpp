@@ -53,7 +53,7 @@ bool e2d::ETimer::isRunning() const
 void e2d::ETimer::start()
 {
 	m_bRunning = true;
-	m_tLast = GetNow();
+	m_tLast.QuadPart = _getNow();
 }
 
 void e2d::ETimer::stop()
@@ -61,9 +61,9 @@ void e2d::ETimer::stop()
 	m_bRunning = false;
 }
 
-e2d::EString e2d::ETimer::getName() const
+const e2d::EString & e2d::ETimer::getName() const
 {
-	return m_sName;
+	return m_Name.toString();
 }
 
 e2d::ENode * e2d::ETimer::getParentNode() const
@@ -73,7 +73,15 @@ e2d::ENode * e2d::ETimer::getParentNode() const
 
 void e2d::ETimer::setName(const EString & name)
 {
-	m_sName = name;
+	// Ѱ󶨵ĶʱҪ
+	if (m_pParentNode)
+	{
+		ETimerManager::_renameTimer(this, name);
+	}
+	else
+	{
+		m_Name = EName(name);
+	}
 }
 
 void e2d::ETimer::setInterval(LONGLONG interval)
@@ -133,7 +141,7 @@ bool e2d::ETimer::_isReady()
 		if (m_nInterval.QuadPart == 0)
 			return true;
 
-		if (IsIntervalFull(m_tLast, m_nInterval))
+		if (IsIntervalFull(_getNow(), m_tLast, m_nInterval))
 		{
 			m_tLast.QuadPart += m_nInterval.QuadPart;
 			return true;
@@ -141,3 +149,8 @@ bool e2d::ETimer::_isReady()
 	}
 	return false;
 }
+
+LONGLONG e2d::ETimer::_getNow()
+{
+	return m_pParentNode ? m_pParentNode->_getLocalTime() : GetNow().QuadPart;
+}
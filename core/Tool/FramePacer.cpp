@@ -0,0 +1,238 @@
+#include "FramePacer.h"
+#include <cmath>
+#include <cstring>
+
+
+// ֡֡ʱͳޣ΢룩ƽ
+static const unsigned int MAX_SAMPLE = 10000000;
+
+
+FramePacer::FramePacer(FrameClock * clock)
+	: m_pClock(clock)
+	, m_eWaitMode(WAIT_SLEEP_SPIN)
+	, m_nInterval(0)
+	, m_nSpinTime(-1)
+	, m_tNext(0)
+	, m_tLastFrame(0)
+	, m_bHasLastFrame(false)
+	, m_nCatchUpLimit(0)
+	, m_bTimerFailed(false)
+{
+	clearStats();
+	reset();
+}
+
+void FramePacer::setInterval(long long interval)
+{
+	m_nInterval = interval > 0 ? interval : 0;
+}
+
+long long FramePacer::getInterval() const
+{
+	return m_nInterval;
+}
+
+void FramePacer::setWaitMode(WaitMode mode)
+{
+	m_eWaitMode = mode;
+	m_bTimerFailed = false;
+}
+
+FramePacer::WaitMode FramePacer::getWaitMode() const
+{
+	return m_eWaitMode;
+}
+
+void FramePacer::setSpinTime(long long ticks)
+{
+	m_nSpinTime = ticks;
+}
+
+void FramePacer::setCatchUpLimit(unsigned int frames)
+{
+	m_nCatchUpLimit = frames;
+}
+
+unsigned int FramePacer::getCatchUpLimit() const
+{
+	return m_nCatchUpLimit;
+}
+
+void FramePacer::reset()
+{
+	m_tNext = m_pClock->now();
+	m_bHasLastFrame = false;
+}
+
+long long FramePacer::getRemaining()
+{
+	long long remaining = m_tNext - m_pClock->now();
+	return remaining > 0 ? remaining : 0;
+}
+
+unsigned int FramePacer::beginFrame()
+{
+	long long now = m_pClock->now();
+
+	// ¼֡ʼʱļ
+	if (m_bHasLastFrame)
+	{
+		_addSample(now - m_tLastFrame);
+	}
+	m_tLastFrame = now;
+	m_bHasLastFrame = true;
+
+	if (m_nInterval == 0)
+	{
+		m_tNext = now;
+		return 1;
+	}
+
+	// ֡ಹ m_nCatchUpLimit ֡
+	unsigned int updates = 1;
+	if (now > m_tNext)
+	{
+		long long behind = (now - m_tNext) / m_nInterval;
+		updates += static_cast<unsigned int>(behind < m_nCatchUpLimit ? behind : m_nCatchUpLimit);
+	}
+	m_tNext += updates * m_nInterval;
+
+	// ޵ֱ֡Ӷһ֡Զ뵽ԭĽϣԽ׷Խ
+	if (m_tNext <= now)
+	{
+		m_tNext += ((now - m_tNext) / m_nInterval + 1) * m_nInterval;
+	}
+	return updates;
+}
+
+void FramePacer::wait()
+{
+	long long spinTime = _getSpinTime();
+
+	for (;;)
+	{
+		long long remaining = m_tNext - m_pClock->now();
+		if (remaining <= 0)
+			return;
+
+		if (remaining > spinTime)
+		{
+			// ȹ𵽽ӽһ֡ʱ
+			long long ticks = remaining - spinTime;
+			if (m_eWaitMode == WAIT_TIMER && !m_bTimerFailed)
+			{
+				if (m_pClock->waitTimer(ticks))
+					continue;
+
+				// ָ֧߾ȶʱͨĹ
+				m_bTimerFailed = true;
+				spinTime = _getSpinTime();
+				continue;
+			}
+			m_pClock->sleep(ticks);
+		}
+		else
+		{
+			// ʣʱ䲻Թæȴһ֡
+			m_pClock->spin();
+		}
+	}
+}
+
+void FramePacer::getStats(Stats & stats) const
+{
+	memset(&stats, 0, sizeof(stats));
+	if (m_nSampleCount == 0)
+		return;
+
+	unsigned int minimum = m_nSamples[0];
+	unsigned int maximum = m_nSamples[0];
+	for (unsigned int i = 1; i < m_nSampleCount; i++)
+	{
+		if (m_nSamples[i] < minimum) minimum = m_nSamples[i];
+		if (m_nSamples[i] > maximum) maximum = m_nSamples[i];
+	}
+
+	double average = double(m_nSum) / m_nSampleCount;
+	double variance = double(m_nSquareSum) / m_nSampleCount - average * average;
+
+	stats.frames = m_nSampleCount;
+	stats.average = average / 1000.0;
+	stats.minimum = minimum / 1000.0;
+	stats.maximum = maximum / 1000.0;
+	stats.jitter = variance > 0 ? std::sqrt(variance) / 1000.0 : 0;
+}
+
+double FramePacer::getPercentile(double percent) const
+{
+	if (m_nSampleCount == 0)
+		return 0;
+
+	if (percent < 0) percent = 0;
+	if (percent > 100) percent = 100;
+
+	// ҵۼ֡ﵽ percent% 䣬Ͻ
+	double target = std::ceil(m_nSampleCount * percent / 100.0);
+	unsigned int count = 0;
+	for (unsigned int i = 0; i < BUCKET_COUNT - 1; i++)
+	{
+		count += m_nHistogram[i];
+		if (count >= target && count > 0)
+			return (i + 1) * BUCKET_WIDTH / 1000.0;
+	}
+
+	Stats stats;
+	getStats(stats);
+	return stats.maximum;
+}
+
+const unsigned int * FramePacer::getHistogram() const
+{
+	return m_nHistogram;
+}
+
+void FramePacer::clearStats()
+{
+	memset(m_nSamples, 0, sizeof(m_nSamples));
+	memset(m_nHistogram, 0, sizeof(m_nHistogram));
+	m_nSampleCount = 0;
+	m_nSampleIndex = 0;
+	m_nSum = 0;
+	m_nSquareSum = 0;
+}
+
+void FramePacer::_addSample(long long ticks)
+{
+	double micros = ticks > 0 ? double(ticks) * 1000000.0 / m_pClock->frequency() : 0;
+	unsigned int sample = static_cast<unsigned int>(micros < MAX_SAMPLE ? micros : MAX_SAMPLE);
+
+	// ʱƳһ֡
+	if (m_nSampleCount == SAMPLE_COUNT)
+	{
+		unsigned int old = m_nSamples[m_nSampleIndex];
+		m_nHistogram[old / BUCKET_WIDTH < BUCKET_COUNT ? old / BUCKET_WIDTH : BUCKET_COUNT - 1]--;
+		m_nSum -= old;
+		m_nSquareSum -= (unsigned long long)old * old;
+	}
+	else
+	{
+		m_nSampleCount++;
+	}
+
+	m_nSamples[m_nSampleIndex] = sample;
+	m_nSampleIndex = (m_nSampleIndex + 1) % SAMPLE_COUNT;
+	m_nHistogram[sample / BUCKET_WIDTH < BUCKET_COUNT ? sample / BUCKET_WIDTH : BUCKET_COUNT - 1]++;
+	m_nSum += sample;
+	m_nSquareSum += (unsigned long long)sample * sample;
+}
+
+long long FramePacer::_getSpinTime() const
+{
+	if (m_nSpinTime >= 0)
+		return m_nSpinTime;
+
+	// ߾ȶʱͨ 0.5 ڣͨɴ 2 
+	if (m_eWaitMode == WAIT_TIMER && !m_bTimerFailed)
+		return m_pClock->frequency() / 2000;
+	return m_pClock->frequency() / 500;
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+
+// ֡ʿʹõʱ
+// ʱ䵥λΪʱڣͨ frequency Ϊ
+// ʱʵһʱӣʹ֡ʿƵĽ
+class FrameClock
+{
+public:
+	virtual ~FrameClock() {}
+
+	// ȡǰʱ
+	virtual long long now() = 0;
+
+	// ȡÿļʱ
+	virtual long long frequency() = 0;
+
+	// ̣߳ʵʹʱܳ ticks
+	virtual void sleep(
+		long long ticks
+	) = 0;
+
+	// ʹø߾ȶʱ̣֧߳ʱ false
+	virtual bool waitTimer(
+		long long ticks
+	) = 0;
+
+	// æȴʱó
+	virtual void spin() = 0;
+};
+
+
+// ֡ʿ
+// ȴһ֡Ŀʼʱ䣬ʱ֡ͳ֡֡ʱ
+class FramePacer
+{
+public:
+	// ȴʽ
+	enum WaitMode
+	{
+		WAIT_SLEEP_SPIN,	/* Թæȴ */
+		WAIT_TIMER			/* ߾ȶʱæȴ֧ʱͬ WAIT_SLEEP_SPIN */
+	};
+
+	// ͳƵ֡
+	static const unsigned int SAMPLE_COUNT = 240;
+
+	// ֡ʱֲһи֡ʱ
+	static const unsigned int BUCKET_COUNT = 80;
+
+	// ֡ʱֲȣ΢룩
+	static const unsigned int BUCKET_WIDTH = 500;
+
+	// ֡ʱͳƣ룩
+	struct Stats
+	{
+		unsigned int	frames;
+		double			average;
+		double			minimum;
+		double			maximum;
+		double			jitter;		/* ׼ */
+	};
+
+public:
+	explicit FramePacer(
+		FrameClock * clock
+	);
+
+	// ֡ʱ
+	void setInterval(
+		long long interval
+	);
+
+	// ȡ֡
+	long long getInterval() const;
+
+	// õȴʽ
+	void setWaitMode(
+		WaitMode mode
+	);
+
+	// ȡȴʽ
+	WaitMode getWaitMode() const;
+
+	// õȴǰæȴʱʱ
+	// С 0 ʱȴʽԶѡ
+	void setSpinTime(
+		long long ticks
+	);
+
+	// ʱಹ֡Ϊ 0 ʱֱӶ֡
+	void setCatchUpLimit(
+		unsigned int frames
+	);
+
+	// ȡʱಹ֡
+	unsigned int getCatchUpLimit() const;
+
+	// ӵǰʱ¿ʼʱһ֡ʼҲͳμ
+	void reset();
+
+	// ȡһ֡ʼʱ䣬ѵʱ 0
+	long long getRemaining();
+
+	// ʼµһ֡һ֡Ҫִеĸ´
+	unsigned int beginFrame();
+
+	// ȴһ֡Ŀʼʱ
+	void wait();
+
+	// ȡ֡ʱͳ
+	void getStats(
+		Stats & stats
+	) const;
+
+	// ȡ֡ʱİٷλ룩֡ʱֲ
+	double getPercentile(
+		double percent
+	) const;
+
+	// ȡ֡ʱֲ BUCKET_COUNT 
+	const unsigned int * getHistogram() const;
+
+	// ֡ʱͳ
+	void clearStats();
+
+private:
+	// ¼һ֡֡ʱ
+	void _addSample(
+		long long ticks
+	);
+
+	// ȡæȴʱ
+	long long _getSpinTime() const;
+
+private:
+	FrameClock *	m_pClock;
+	WaitMode		m_eWaitMode;
+	long long		m_nInterval;
+	long long		m_nSpinTime;
+	long long		m_tNext;
+	long long		m_tLastFrame;
+	bool			m_bHasLastFrame;
+	unsigned int	m_nCatchUpLimit;
+	unsigned int	m_nSamples[SAMPLE_COUNT];
+	unsigned int	m_nSampleCount;
+	unsigned int	m_nSampleIndex;
+	unsigned int	m_nHistogram[BUCKET_COUNT];
+	unsigned long long	m_nSum;
+	unsigned long long	m_nSquareSum;
+	bool			m_bTimerFailed;
+};
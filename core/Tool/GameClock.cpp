@@ -0,0 +1,93 @@
+#include "GameClock.h"
+#include <cmath>
+
+
+GameClock::GameClock()
+	: m_nTime(0)
+	, m_nParentTime(0)
+	, m_nDelta(0)
+	, m_fRemainder(0)
+	, m_fScale(1)
+	, m_bPaused(false)
+{
+}
+
+void GameClock::reset(long long time)
+{
+	m_nTime = time;
+	m_nDelta = 0;
+	m_fRemainder = 0;
+}
+
+long long GameClock::advance(long long delta)
+{
+	if (m_bPaused || delta <= 0 || m_fScale == 0)
+	{
+		m_nDelta = 0;
+	}
+	else if (m_fScale == 1)
+	{
+		// ʱֱۼӣ
+		m_nDelta = delta;
+	}
+	else
+	{
+		double scaled = static_cast<double>(delta) * m_fScale + m_fRemainder;
+		double whole = std::floor(scaled);
+		m_fRemainder = scaled - whole;
+		m_nDelta = static_cast<long long>(whole);
+	}
+	m_nTime += m_nDelta;
+	return m_nDelta;
+}
+
+long long GameClock::follow(long long parentTime)
+{
+	if (parentTime != m_nParentTime)
+	{
+		advance(parentTime - m_nParentTime);
+		m_nParentTime = parentTime;
+	}
+	return m_nTime;
+}
+
+void GameClock::attach(long long parentTime)
+{
+	m_nParentTime = parentTime;
+}
+
+long long GameClock::getTime() const
+{
+	return m_nTime;
+}
+
+long long GameClock::getDelta() const
+{
+	return m_nDelta;
+}
+
+void GameClock::setTimeScale(float scale)
+{
+	m_fScale = scale > 0 ? scale : 0;
+	m_fRemainder = 0;
+}
+
+float GameClock::getTimeScale() const
+{
+	return m_fScale;
+}
+
+void GameClock::setPaused(bool paused)
+{
+	m_bPaused = paused;
+}
+
+bool GameClock::isPaused() const
+{
+	return m_bPaused;
+}
+
+float GameClock::getEffectiveScale() const
+{
+	return m_bPaused ? 0 : m_fScale;
+}
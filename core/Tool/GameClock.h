@@ -0,0 +1,66 @@
+#pragma once
+
+
+// šͣϷʱ
+// ʱ䵥λΪʱڣϼʱƽϼʱӾʱ䰴űۼӵʱ
+// ʱÿ֡ʱƽڵʱӸ游ڵ򳡾ʱ
+// ļ Windowsƽʱɵ߸֡
+class GameClock
+{
+public:
+	GameClock();
+
+	// ʱ
+	void reset(
+		long long time = 0
+	);
+
+	// ƽʱӣdelta ΪϼʱӾرʱӾ
+	long long advance(
+		long long delta
+	);
+
+	// ϼʱƽ parentTimeرʱӵĵǰʱ
+	// ޸űͣ״̬ǰȸһΣ֮ǰʱ䰴ԭ
+	long long follow(
+		long long parentTime
+	);
+
+	// ҽӵµϼʱӣֻ¼䵱ǰʱ䣬ƽʱ
+	void attach(
+		long long parentTime
+	);
+
+	// ȡǰʱ
+	long long getTime() const;
+
+	// ȡһƽ
+	long long getDelta() const;
+
+	// ʱűС 0 ʱΪ 0
+	void setTimeScale(
+		float scale
+	);
+
+	// ȡʱű
+	float getTimeScale() const;
+
+	// ͣ
+	void setPaused(
+		bool paused
+	);
+
+	// Ƿͣ
+	bool isPaused() const;
+
+	// ȡʵʵűͣʱΪ 0
+	float getEffectiveScale() const;
+
+private:
+	long long	m_nTime;
+	long long	m_nParentTime;	/* һθʱϼʱӵʱ */
+	long long	m_nDelta;
+	double		m_fRemainder;	/* źһڵĲ֣ۼƵ´ƽ */
+	float		m_fScale;
+	bool		m_bPaused;
+};
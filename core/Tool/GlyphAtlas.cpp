@@ -0,0 +1,375 @@
+#include "GlyphAtlas.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+
+// ͼ֮ļԲʱε
+static const int GLYPH_SPACING = 1;
+
+
+// ־ļ
+static unsigned long long KerningKey(unsigned int first, unsigned int second)
+{
+	return (static_cast<unsigned long long>(first) << 32) | second;
+}
+
+// ͼҳȽ
+static bool ComparePage(const GlyphAtlas::Quad & a, const GlyphAtlas::Quad & b)
+{
+	return a.page < b.page;
+}
+
+
+// BMFont ıʽеһУ char id=65 x=0 y=0 ...
+class BMFontLine
+{
+public:
+	BMFontLine(const char * begin, const char * end)
+	{
+		const char * p = begin;
+		while (p < end && *p != ' ' && *p != '\t')
+			p++;
+		m_sTag.assign(begin, p);
+
+		while (p < end)
+		{
+			while (p < end && (*p == ' ' || *p == '\t'))
+				p++;
+
+			const char * key = p;
+			while (p < end && *p != '=' && *p != ' ' && *p != '\t')
+				p++;
+			std::string name(key, p);
+			if (p >= end || *p != '=')
+				continue;
+			p++;
+
+			// ֵܴţп԰ո
+			std::string value;
+			if (p < end && *p == '"')
+			{
+				const char * start = ++p;
+				while (p < end && *p != '"')
+					p++;
+				value.assign(start, p);
+				if (p < end)
+					p++;
+			}
+			else
+			{
+				const char * start = p;
+				while (p < end && *p != ' ' && *p != '\t')
+					p++;
+				value.assign(start, p);
+			}
+			m_vKeys.push_back(name);
+			m_vValues.push_back(value);
+		}
+	}
+
+	const std::string & tag() const
+	{
+		return m_sTag;
+	}
+
+	const std::string * get(const char * name) const
+	{
+		for (size_t i = 0; i < m_vKeys.size(); i++)
+		{
+			if (m_vKeys[i] == name)
+				return &m_vValues[i];
+		}
+		return nullptr;
+	}
+
+	int getInt(const char * name, int defaultValue = 0) const
+	{
+		const std::string * value = get(name);
+		return value ? atoi(value->c_str()) : defaultValue;
+	}
+
+private:
+	std::string m_sTag;
+	std::vector<std::string> m_vKeys;
+	std::vector<std::string> m_vValues;
+};
+
+
+GlyphAtlas::GlyphAtlas()
+{
+	m_nPageWidth = 512;
+	m_nPageHeight = 512;
+	clear();
+}
+
+void GlyphAtlas::clear()
+{
+	m_vGlyphs.clear();
+	m_mGlyphs.clear();
+	m_mKerning.clear();
+	for (int i = 0; i < ASCII_COUNT; i++)
+	{
+		m_Ascii[i] = -1;
+	}
+	m_fLineHeight = 0;
+	m_nPageCount = 0;
+	m_nShelfX = 0;
+	m_nShelfY = 0;
+	m_nShelfHeight = 0;
+}
+
+bool GlyphAtlas::parseBMFont(const char * data, size_t size, std::vector<std::string> & pages)
+{
+	clear();
+	pages.clear();
+
+	const char * end = data + size;
+	//  UTF-8 BOM
+	if (size >= 3 && memcmp(data, "\xEF\xBB\xBF", 3) == 0)
+		data += 3;
+
+	bool hasCommon = false;
+	while (data < end)
+	{
+		const char * lineEnd = data;
+		while (lineEnd < end && *lineEnd != '\n' && *lineEnd != '\r')
+			lineEnd++;
+
+		BMFontLine line(data, lineEnd);
+		if (line.tag() == "common")
+		{
+			hasCommon = true;
+			m_fLineHeight = static_cast<float>(line.getInt("lineHeight"));
+			m_nPageWidth = line.getInt("scaleW", m_nPageWidth);
+			m_nPageHeight = line.getInt("scaleH", m_nPageHeight);
+		}
+		else if (line.tag() == "page")
+		{
+			int id = line.getInt("id", -1);
+			const std::string * file = line.get("file");
+			if (id >= 0 && file)
+			{
+				if (pages.size() <= size_t(id))
+					pages.resize(id + 1);
+				pages[id] = *file;
+			}
+		}
+		else if (line.tag() == "char")
+		{
+			int id = line.getInt("id", -1);
+			if (id >= 0)
+			{
+				Glyph glyph;
+				glyph.x = line.getInt("x");
+				glyph.y = line.getInt("y");
+				glyph.width = line.getInt("width");
+				glyph.height = line.getInt("height");
+				glyph.xoffset = static_cast<float>(line.getInt("xoffset"));
+				glyph.yoffset = static_cast<float>(line.getInt("yoffset"));
+				glyph.xadvance = static_cast<float>(line.getInt("xadvance"));
+				glyph.page = line.getInt("page");
+				addGlyph(static_cast<unsigned int>(id), glyph);
+			}
+		}
+		else if (line.tag() == "kerning")
+		{
+			int first = line.getInt("first", -1);
+			int second = line.getInt("second", -1);
+			int amount = line.getInt("amount");
+			if (first >= 0 && second >= 0 && amount != 0)
+			{
+				addKerning(first, second, static_cast<float>(amount));
+			}
+		}
+
+		data = lineEnd;
+		while (data < end && (*data == '\n' || *data == '\r'))
+			data++;
+	}
+
+	m_nPageCount = static_cast<int>(pages.size());
+	// ȡ岻ٷµ
+	m_nShelfY = m_nPageHeight;
+	return hasCommon && !pages.empty();
+}
+
+void GlyphAtlas::addGlyph(unsigned int code, const Glyph & glyph)
+{
+	int * pIndex = nullptr;
+	if (code < ASCII_COUNT)
+	{
+		pIndex = &m_Ascii[code];
+	}
+	else
+	{
+		auto iter = m_mGlyphs.find(code);
+		if (iter == m_mGlyphs.end())
+			iter = m_mGlyphs.insert(std::make_pair(code, -1)).first;
+		pIndex = &iter->second;
+	}
+
+	if (*pIndex < 0)
+	{
+		*pIndex = static_cast<int>(m_vGlyphs.size());
+		m_vGlyphs.push_back(glyph);
+	}
+	else
+	{
+		m_vGlyphs[*pIndex] = glyph;
+	}
+}
+
+const GlyphAtlas::Glyph * GlyphAtlas::findGlyph(unsigned int code) const
+{
+	if (code < ASCII_COUNT)
+	{
+		return m_Ascii[code] < 0 ? nullptr : &m_vGlyphs[m_Ascii[code]];
+	}
+
+	auto iter = m_mGlyphs.find(code);
+	return iter == m_mGlyphs.end() ? nullptr : &m_vGlyphs[iter->second];
+}
+
+void GlyphAtlas::addKerning(unsigned int first, unsigned int second, float amount)
+{
+	m_mKerning[KerningKey(first, second)] = amount;
+}
+
+float GlyphAtlas::getKerning(unsigned int first, unsigned int second) const
+{
+	if (m_mKerning.empty())
+		return 0;
+
+	auto iter = m_mKerning.find(KerningKey(first, second));
+	return iter == m_mKerning.end() ? 0 : iter->second;
+}
+
+void GlyphAtlas::setLineHeight(float lineHeight)
+{
+	m_fLineHeight = lineHeight;
+}
+
+float GlyphAtlas::getLineHeight() const
+{
+	return m_fLineHeight;
+}
+
+void GlyphAtlas::setPageSize(int width, int height)
+{
+	m_nPageWidth = width;
+	m_nPageHeight = height;
+}
+
+int GlyphAtlas::getPageCount() const
+{
+	return m_nPageCount;
+}
+
+bool GlyphAtlas::allocate(int width, int height, int & x, int & y, int & page)
+{
+	int cellWidth = width + GLYPH_SPACING;
+	int cellHeight = height + GLYPH_SPACING;
+	if (width <= 0 || height <= 0 || cellWidth > m_nPageWidth || cellHeight > m_nPageHeight)
+		return false;
+
+	// Уܣ򣬵ǰзŲʱУǰҳŲʱҳ
+	if (m_nPageCount > 0 && m_nShelfX + cellWidth > m_nPageWidth)
+	{
+		m_nShelfX = 0;
+		m_nShelfY += m_nShelfHeight;
+		m_nShelfHeight = 0;
+	}
+	if (m_nPageCount == 0 || m_nShelfY + cellHeight > m_nPageHeight)
+	{
+		m_nPageCount++;
+		m_nShelfX = 0;
+		m_nShelfY = 0;
+		m_nShelfHeight = 0;
+	}
+
+	x = m_nShelfX;
+	y = m_nShelfY;
+	page = m_nPageCount - 1;
+	m_nShelfX += cellWidth;
+	m_nShelfHeight = std::max(m_nShelfHeight, cellHeight);
+	return true;
+}
+
+void GlyphAtlas::layout(const wchar_t * text, size_t length, std::vector<Quad> & quads, float & width, float & height) const
+{
+	quads.clear();
+	width = 0;
+	height = 0;
+
+	float penX = 0;
+	float penY = 0;
+	unsigned int prev = 0;
+	bool multiPage = false;
+
+	for (size_t i = 0; i < length;)
+	{
+		unsigned int code;
+		i += decode(text + i, length - i, code);
+
+		if (code == L'\n')
+		{
+			width = std::max(width, penX);
+			penX = 0;
+			penY += m_fLineHeight;
+			prev = 0;
+			continue;
+		}
+
+		const Glyph * glyph = findGlyph(code);
+		if (!glyph)
+			continue;
+
+		if (prev)
+		{
+			penX += getKerning(prev, code);
+		}
+		prev = code;
+
+		if (glyph->width > 0 && glyph->height > 0)
+		{
+			Quad quad;
+			quad.dest[0] = penX + glyph->xoffset;
+			quad.dest[1] = penY + glyph->yoffset;
+			quad.dest[2] = quad.dest[0] + glyph->width;
+			quad.dest[3] = quad.dest[1] + glyph->height;
+			quad.src[0] = static_cast<float>(glyph->x);
+			quad.src[1] = static_cast<float>(glyph->y);
+			quad.src[2] = static_cast<float>(glyph->x + glyph->width);
+			quad.src[3] = static_cast<float>(glyph->y + glyph->height);
+			quad.page = glyph->page;
+			multiPage = multiPage || (!quads.empty() && quads.back().page != glyph->page);
+			quads.push_back(quad);
+		}
+		penX += glyph->xadvance;
+	}
+
+	width = std::max(width, penX);
+	height = length > 0 ? penY + m_fLineHeight : 0;
+
+	// ͬһҳУһλ
+	if (multiPage)
+	{
+		std::stable_sort(quads.begin(), quads.end(), ComparePage);
+	}
+}
+
+size_t GlyphAtlas::decode(const wchar_t * text, size_t length, unsigned int & code)
+{
+	code = static_cast<unsigned int>(text[0]);
+	if (sizeof(wchar_t) == 2 && code >= 0xD800 && code <= 0xDBFF && length > 1)
+	{
+		unsigned int low = static_cast<unsigned int>(text[1]);
+		if (low >= 0xDC00 && low <= 0xDFFF)
+		{
+			code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+			return 2;
+		}
+	}
+	return 1;
+}
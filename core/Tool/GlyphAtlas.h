@@ -0,0 +1,132 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+
+// λͼα
+// ÿַͼеƫơȺ־ַŰÿεĻ
+// οԴ BMFont ıʽ .fnt ļжȡҲʱͼ
+// ASCII ֱַӰ±ңַ纺֣ʹùϣ
+// ļ Windowsƽ̨ϱ
+class GlyphAtlas
+{
+public:
+	// 
+	struct Glyph
+	{
+		int		x;			/* ͼҳеأ */
+		int		y;
+		int		width;
+		int		height;
+		float	xoffset;	/* λڱλõƫ */
+		float	yoffset;
+		float	xadvance;	/* ƺλǰľ */
+		int		page;		/* ͼҳ */
+	};
+
+	// ŰõһΣ˳Ϊ left, top, right, bottom
+	struct Quad
+	{
+		float	dest[4];	/*  */
+		float	src[4];		/* ͼҳеԴ */
+		int		page;
+	};
+
+public:
+	GlyphAtlas();
+
+	// ɾΡ־ͼҳ
+	void clear();
+
+	//  BMFont ıʽpages ظͼҳͼƬļļеԭʼ룩
+	bool parseBMFont(
+		const char * data,
+		size_t size,
+		std::vector<std::string> & pages
+	);
+
+	// ΣѴʱ滻
+	void addGlyph(
+		unsigned int code,
+		const Glyph & glyph
+	);
+
+	// Σʱؿ
+	const Glyph * findGlyph(
+		unsigned int code
+	) const;
+
+	// ַ֮־
+	void addKerning(
+		unsigned int first,
+		unsigned int second,
+		float amount
+	);
+
+	// ȡַ֮־
+	float getKerning(
+		unsigned int first,
+		unsigned int second
+	) const;
+
+	// и
+	void setLineHeight(
+		float lineHeight
+	);
+
+	// ȡи
+	float getLineHeight() const;
+
+	// ͼҳСأʱʹ
+	void setPageSize(
+		int width,
+		int height
+	);
+
+	// ȡͼҳ
+	int getPageCount() const;
+
+	// ͼзһ򣬵ǰҳŲʱʹµһҳ
+	// ҳʱ false
+	bool allocate(
+		int width,
+		int height,
+		int & x,
+		int & y,
+		int & page
+	);
+
+	// Űַ'\n' Уȱεַ
+	// quads ͼҳУͬһҳαַе˳
+	void layout(
+		const wchar_t * text,
+		size_t length,
+		std::vector<Quad> & quads,
+		float & width,
+		float & height
+	) const;
+
+	// ȡַһַı룬 UTF-16 ԣضȡ wchar_t 
+	static size_t decode(
+		const wchar_t * text,
+		size_t length,
+		unsigned int & code
+	);
+
+private:
+	enum { ASCII_COUNT = 128 };
+
+	std::vector<Glyph>	m_vGlyphs;
+	int					m_Ascii[ASCII_COUNT];	/* ASCII ַ m_vGlyphs е±꣬-1 ʾ */
+	std::unordered_map<unsigned int, int>					m_mGlyphs;	/* ַ m_vGlyphs е± */
+	std::unordered_map<unsigned long long, float>		m_mKerning;
+	float	m_fLineHeight;
+	int		m_nPageWidth;
+	int		m_nPageHeight;
+	int		m_nPageCount;
+	int		m_nShelfX;			/* ǰҳеǰһеһλ */
+	int		m_nShelfY;
+	int		m_nShelfHeight;
+};
@@ -0,0 +1,169 @@
+#include "InputLog.h"
+
+
+static void WriteVarint(std::vector<unsigned char> & data, unsigned long long value)
+{
+	while (value >= 0x80)
+	{
+		data.push_back((unsigned char)(value | 0x80));
+		value >>= 7;
+	}
+	data.push_back((unsigned char)value);
+}
+
+static bool ReadVarint(const std::vector<unsigned char> & data, size_t & pos, unsigned long long & value)
+{
+	value = 0;
+	for (int shift = 0; shift < 64 && pos < data.size(); shift += 7)
+	{
+		unsigned char byte = data[pos++];
+		value |= (unsigned long long)(byte & 0x7F) << shift;
+		if (!(byte & 0x80))
+			return true;
+	}
+	return false;
+}
+
+// ZigZag 룬ֵСĸҲֻռٵֽ
+static unsigned long long ZigZag(long long value)
+{
+	return ((unsigned long long)value << 1) ^ (unsigned long long)(value >> 63);
+}
+
+static long long UnZigZag(unsigned long long value)
+{
+	return (long long)(value >> 1) ^ -(long long)(value & 1);
+}
+
+static void WriteU64(unsigned char * p, unsigned long long value)
+{
+	for (int i = 0; i < 8; i++)
+	{
+		p[i] = (unsigned char)(value >> (i * 8));
+	}
+}
+
+static unsigned long long ReadU64(const unsigned char * p)
+{
+	unsigned long long value = 0;
+	for (int i = 0; i < 8; i++)
+	{
+		value |= (unsigned long long)p[i] << (i * 8);
+	}
+	return value;
+}
+
+
+InputLog::InputLog()
+	: m_nReadPos(0)
+	, m_nFrameCount(0)
+	, m_nFrequency(0)
+{
+}
+
+void InputLog::reset(long long frequency)
+{
+	m_vData.assign(HEADER_SIZE, 0);
+	m_nReadPos = HEADER_SIZE;
+	m_nFrameCount = 0;
+	m_nFrequency = frequency;
+
+	unsigned char * p = &m_vData[0];
+	WriteU64(p, (unsigned long long)MAGIC | ((unsigned long long)VERSION << 32));
+	WriteU64(p + 8, (unsigned long long)frequency);
+}
+
+void InputLog::addFrame(long long delta, const Event * events, size_t count)
+{
+	WriteVarint(m_vData, ZigZag(delta));
+	WriteVarint(m_vData, count);
+	for (size_t i = 0; i < count; i++)
+	{
+		const Event & event = events[i];
+		WriteVarint(m_vData, event.message);
+		WriteVarint(m_vData, event.wParam);
+		WriteVarint(m_vData, ZigZag(event.lParam));
+		WriteVarint(m_vData, ZigZag(event.time));
+		WriteVarint(m_vData, event.count);
+	}
+	m_nFrameCount++;
+}
+
+unsigned int InputLog::getFrameCount() const
+{
+	return m_nFrameCount;
+}
+
+const std::vector<unsigned char> & InputLog::getData() const
+{
+	return m_vData;
+}
+
+bool InputLog::load(const void * data, size_t size)
+{
+	m_vData.clear();
+	m_nReadPos = 0;
+	m_nFrameCount = 0;
+	m_nFrequency = 0;
+
+	if (!data || size < HEADER_SIZE)
+		return false;
+
+	const unsigned char * p = static_cast<const unsigned char *>(data);
+	unsigned long long header = ReadU64(p);
+	long long frequency = (long long)ReadU64(p + 8);
+	if ((unsigned int)header != MAGIC || (unsigned short)(header >> 32) != VERSION || frequency <= 0)
+		return false;
+
+	m_vData.assign(p, p + size);
+	m_nReadPos = HEADER_SIZE;
+	m_nFrequency = frequency;
+	return true;
+}
+
+long long InputLog::getFrequency() const
+{
+	return m_nFrequency;
+}
+
+bool InputLog::readFrame(long long & delta, std::vector<Event> & events)
+{
+	events.clear();
+	if (isEnd())
+		return false;
+
+	size_t pos = m_nReadPos;
+	unsigned long long value, count;
+	if (!ReadVarint(m_vData, pos, value) || !ReadVarint(m_vData, pos, count))
+		return false;
+	delta = UnZigZag(value);
+
+	for (unsigned long long i = 0; i < count; i++)
+	{
+		Event event;
+		unsigned long long message, lParam, time, merged;
+		if (!ReadVarint(m_vData, pos, message) ||
+			!ReadVarint(m_vData, pos, event.wParam) ||
+			!ReadVarint(m_vData, pos, lParam) ||
+			!ReadVarint(m_vData, pos, time) ||
+			!ReadVarint(m_vData, pos, merged))
+		{
+			events.clear();
+			return false;
+		}
+		event.message = (unsigned int)message;
+		event.lParam = UnZigZag(lParam);
+		event.time = UnZigZag(time);
+		event.count = (unsigned int)merged;
+		events.push_back(event);
+	}
+
+	m_nReadPos = pos;
+	m_nFrameCount++;
+	return true;
+}
+
+bool InputLog::isEnd() const
+{
+	return m_nReadPos >= m_vData.size();
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+
+// ¼.e2di
+// ֡¼߼ʱƽͱ֡յꡢϢطʱ֡Ϸ
+// ļ Windows¼ƽ̨Ϸ
+//
+// ļ֣С򣩣
+//   ļͷ   16 ֽڣʶ汾¼ʱļʱƵ
+//   ֡¼   ÿ֡ΪʱƽϢ͸Ϣ
+//   Ϣ     ͡wParamlParamյϢʱ䣨һ֡ʱ߼ʱ䣩ϲϢ
+// ֡¼еֵʹñ䳤룬з ZigZag 룬ͨÿϢֻռ 6  10 ֽ
+class InputLog
+{
+public:
+	// ļʶ "E2DI"
+	static const unsigned int MAGIC = 0x49443245;
+
+	// ļʽ汾
+	static const unsigned short VERSION = 1;
+
+	// ļͷĴС
+	static const size_t HEADER_SIZE = 16;
+
+	// һϢ
+	struct Event
+	{
+		unsigned int		message;
+		unsigned long long	wParam;
+		long long			lParam;
+		long long			time;		/* һ֡ʱ߼ʱ䣨ʱڣ */
+		unsigned int		count;		/* ϲϢ */
+	};
+
+public:
+	InputLog();
+
+	// ռ¼ʼµļ¼
+	void reset(
+		long long frequency
+	);
+
+	// ׷һ֡
+	void addFrame(
+		long long delta,
+		const Event * events,
+		size_t count
+	);
+
+	// ȡ¼֡
+	unsigned int getFrameCount() const;
+
+	// ȡļ¼
+	const std::vector<unsigned char> & getData() const;
+
+	// ȡ¼֮Դӵһ֡ʼ֡ȡ
+	bool load(
+		const void * data,
+		size_t size
+	);
+
+	// ȡ¼ʱļʱƵ
+	long long getFrequency() const;
+
+	// ȡһ֡Ѷʱ false
+	bool readFrame(
+		long long & delta,
+		std::vector<Event> & events
+	);
+
+	// ǷѶ֡
+	bool isEnd() const;
+
+private:
+	std::vector<unsigned char> m_vData;
+	size_t			m_nReadPos;
+	unsigned int	m_nFrameCount;
+	long long		m_nFrequency;
+};
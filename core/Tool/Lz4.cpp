@@ -0,0 +1,180 @@
+#include "Lz4.h"
+#include <cstring>
+
+
+// LZ4 Сƥ䳤
+static const size_t LZ4_MIN_MATCH = 4;
+// һƥھβ 12 ֽ֮ǰʼ
+static const size_t LZ4_MF_LIMIT = 12;
+// β 5 ֽڱΪ
+static const size_t LZ4_LAST_LITERALS = 5;
+// ƥұĴС2 ݴΣ
+static const unsigned int LZ4_HASH_LOG = 12;
+
+static unsigned int ReadU32(const unsigned char * p)
+{
+	return (unsigned int)p[0] | ((unsigned int)p[1] << 8) | ((unsigned int)p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+static unsigned short ReadU16(const unsigned char * p)
+{
+	return (unsigned short)(p[0] | (p[1] << 8));
+}
+
+// д LZ4 չȣ 15 Ĳ֣
+static void WriteLZ4Length(std::vector<unsigned char> & dst, size_t length)
+{
+	length -= 15;
+	while (length >= 255)
+	{
+		dst.push_back(255);
+		length -= 255;
+	}
+	dst.push_back((unsigned char)length);
+}
+
+// ȡ LZ4 չ
+static bool ReadLZ4Length(const unsigned char * src, size_t srcSize, size_t & ip, size_t & length)
+{
+	unsigned char byte;
+	do
+	{
+		if (ip >= srcSize)
+			return false;
+		byte = src[ip++];
+		length += byte;
+	} while (byte == 255);
+	return true;
+}
+
+// дһ LZ4 УmatchLength Ϊ 0 ʱʾһ
+static void WriteLZ4Sequence(
+	std::vector<unsigned char> & dst,
+	const unsigned char * literals,
+	size_t literalLength,
+	size_t matchLength,
+	size_t offset
+)
+{
+	unsigned char token = (unsigned char)((literalLength >= 15 ? 15 : literalLength) << 4);
+	if (matchLength)
+	{
+		size_t length = matchLength - LZ4_MIN_MATCH;
+		token |= (unsigned char)(length >= 15 ? 15 : length);
+	}
+	dst.push_back(token);
+
+	if (literalLength >= 15)
+	{
+		WriteLZ4Length(dst, literalLength);
+	}
+	dst.insert(dst.end(), literals, literals + literalLength);
+
+	if (matchLength)
+	{
+		dst.push_back((unsigned char)(offset));
+		dst.push_back((unsigned char)(offset >> 8));
+		if (matchLength - LZ4_MIN_MATCH >= 15)
+		{
+			WriteLZ4Length(dst, matchLength - LZ4_MIN_MATCH);
+		}
+	}
+}
+
+
+void Lz4::compress(const void * src, size_t srcSize, std::vector<unsigned char> & dst)
+{
+	const unsigned char * in = static_cast<const unsigned char *>(src);
+	// ұλ + 10 ʾ
+	std::vector<size_t> table(size_t(1) << LZ4_HASH_LOG, 0);
+
+	size_t anchor = 0;
+	size_t ip = 0;
+
+	if (srcSize > LZ4_MF_LIMIT)
+	{
+		size_t limit = srcSize - LZ4_MF_LIMIT;
+		while (ip < limit)
+		{
+			unsigned int sequence = ReadU32(in + ip);
+			unsigned int hash = (sequence * 2654435761U) >> (32 - LZ4_HASH_LOG);
+			size_t candidate = table[hash];
+			table[hash] = ip + 1;
+
+			if (candidate && ip - (candidate - 1) <= 65535 && ReadU32(in + candidate - 1) == sequence)
+			{
+				size_t match = candidate - 1;
+				size_t length = LZ4_MIN_MATCH;
+				size_t maxLength = srcSize - LZ4_LAST_LITERALS - ip;
+				while (length < maxLength && in[match + length] == in[ip + length])
+				{
+					length++;
+				}
+
+				WriteLZ4Sequence(dst, in + anchor, ip - anchor, length, ip - match);
+				ip += length;
+				anchor = ip;
+			}
+			else
+			{
+				ip++;
+			}
+		}
+	}
+
+	WriteLZ4Sequence(dst, in + anchor, srcSize - anchor, 0, 0);
+}
+
+bool Lz4::decompress(const void * src, size_t srcSize, void * dst, size_t dstSize)
+{
+	const unsigned char * in = static_cast<const unsigned char *>(src);
+	unsigned char * out = static_cast<unsigned char *>(dst);
+
+	size_t ip = 0;
+	size_t op = 0;
+
+	while (ip < srcSize)
+	{
+		unsigned char token = in[ip++];
+
+		// 
+		size_t literalLength = token >> 4;
+		if (literalLength == 15 && !ReadLZ4Length(in, srcSize, ip, literalLength))
+			return false;
+		if (literalLength > srcSize - ip || literalLength > dstSize - op)
+			return false;
+
+		memcpy(out + op, in + ip, literalLength);
+		ip += literalLength;
+		op += literalLength;
+
+		// һûƥ䲿
+		if (ip == srcSize)
+			break;
+
+		// ƥ
+		if (srcSize - ip < 2)
+			return false;
+		size_t offset = ReadU16(in + ip);
+		ip += 2;
+		if (offset == 0 || offset > op)
+			return false;
+
+		size_t matchLength = token & 15;
+		if (matchLength == 15 && !ReadLZ4Length(in, srcSize, ip, matchLength))
+			return false;
+		matchLength += LZ4_MIN_MATCH;
+		if (matchLength > dstSize - op)
+			return false;
+
+		// ƥصֽڸ
+		const unsigned char * match = out + op - offset;
+		for (size_t i = 0; i < matchLength; i++)
+		{
+			out[op + i] = match[i];
+		}
+		op += matchLength;
+	}
+
+	return op == dstSize;
+}
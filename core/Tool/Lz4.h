@@ -0,0 +1,24 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+
+// LZ4 ʽѹѹ֡ʽ Windows
+class Lz4
+{
+public:
+	// ѹݣ׷ӵ dst ĩβ
+	static void compress(
+		const void * src,
+		size_t srcSize,
+		std::vector<unsigned char> & dst
+	);
+
+	// ѹݣѹǡΪ dstSize ֽ
+	static bool decompress(
+		const void * src,
+		size_t srcSize,
+		void * dst,
+		size_t dstSize
+	);
+};
@@ -0,0 +1,58 @@
+#pragma once
+#include <unordered_map>
+#include <vector>
+
+
+// ͬĶж
+// ƵɢֵΪʱֻȽɢֵͬĶ󣬰ƲҵĿͬĶйأ޹
+// Name ṩ hash() ļ Windows
+template<class Name, class T>
+class NameIndex
+{
+public:
+	// Ӷ
+	void add(const Name & name, T * object)
+	{
+		m_mObjects.insert(std::make_pair(name.hash(), object));
+	}
+
+	// ɾname ʱͬʱ false
+	bool remove(const Name & name, T * object)
+	{
+		auto range = m_mObjects.equal_range(name.hash());
+		for (auto iter = range.first; iter != range.second; iter++)
+		{
+			if (iter->second == object)
+			{
+				m_mObjects.erase(iter);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Ϊ name Ķ󣬽 objects 
+	// ͬƿͬɢֵequal ж϶ǷȷʵΪ name
+	template<class Equal>
+	void find(const Name & name, std::vector<T*> & objects, Equal equal) const
+	{
+		objects.clear();
+		auto range = m_mObjects.equal_range(name.hash());
+		for (auto iter = range.first; iter != range.second; iter++)
+		{
+			if (equal(iter->second))
+			{
+				objects.push_back(iter->second);
+			}
+		}
+	}
+
+	// ɾж
+	void clear()
+	{
+		m_mObjects.clear();
+	}
+
+private:
+	std::unordered_multimap<unsigned int, T *> m_mObjects;
+};
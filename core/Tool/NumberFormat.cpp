@@ -0,0 +1,184 @@
+#include "NumberFormat.h"
+#include <cmath>
+#include <cwchar>
+
+
+// 10  0 ~ 9 ηתСʱСλ
+static const int FAST_PRECISION = 9;
+static const unsigned long long s_nPowers[FAST_PRECISION + 1] = {
+	1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL,
+	100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL
+};
+
+// ŴֵС 2^52 ʱn + 0.5  double ȷʾ
+static const double FAST_LIMIT = 4503599627370496.0;
+
+// λʮֱÿתλٳ
+static const char s_Digits[] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+// ޷Ӻǰд뻺д minDigits λصһַλ
+static wchar_t * WriteDigits(wchar_t * end, unsigned long long value, int minDigits)
+{
+	wchar_t * p = end;
+	while (value >= 100)
+	{
+		unsigned int index = static_cast<unsigned int>(value % 100) * 2;
+		value /= 100;
+		*--p = static_cast<wchar_t>(s_Digits[index + 1]);
+		*--p = static_cast<wchar_t>(s_Digits[index]);
+	}
+	if (value >= 10)
+	{
+		unsigned int index = static_cast<unsigned int>(value) * 2;
+		*--p = static_cast<wchar_t>(s_Digits[index + 1]);
+		*--p = static_cast<wchar_t>(s_Digits[index]);
+	}
+	else
+	{
+		*--p = static_cast<wchar_t>(L'0' + value);
+	}
+	while (end - p < minDigits)
+	{
+		*--p = L'0';
+	}
+	return p;
+}
+
+//  [begin, end) ƶͷӽβ 0ַ
+static size_t MoveToFront(wchar_t * buffer, const wchar_t * begin, const wchar_t * end)
+{
+	size_t count = size_t(end - begin);
+	wmemmove(buffer, begin, count);
+	buffer[count] = 0;
+	return count;
+}
+
+// VS2013 ֮ǰ CRT û std::fma  std::signbitʵ
+#if defined(_MSC_VER) && _MSC_VER < 1800 && !defined(NUMBER_FORMAT_NO_FMA)
+#define NUMBER_FORMAT_NO_FMA
+#endif
+
+#ifndef NUMBER_FORMAT_NO_FMA
+
+//  a * b - cֻһ
+static inline double MulSub(double a, double b, double c)
+{
+	return std::fma(a, b, -c);
+}
+
+static inline bool SignBit(double value)
+{
+	return std::signbit(value);
+}
+
+#else
+
+//  value Ϊߵ֣ÿֲ 26 λЧ֣֮ĳ˻Ծȷʾ
+static inline void Split(double value, double & high, double & low)
+{
+	const double factor = 134217729.0;	/* 2^27 + 1 */
+	double t = factor * value;
+	high = t - (t - value);
+	low = value - high;
+}
+
+//  a * b - cȽ˻ȷرʾΪ p + eDekker 㷨
+//  c  p p - c û룬Զ 0ķȷ
+static double MulSub(double a, double b, double c)
+{
+	double p = a * b;
+	double ah, al, bh, bl;
+	Split(a, ah, al);
+	Split(b, bh, bl);
+	double e = ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+	return (p - c) + e;
+}
+
+//  -0.0  true
+static inline bool SignBit(double value)
+{
+	return value < 0 || (value == 0 && 1 / value < 0);
+}
+
+#endif
+
+//  magnitude * scale 뵽ǡмʱȡż
+// ˻ľȷֵѡĲ MulSub 㣬ֻһΣȷ
+static unsigned long long RoundScaled(double magnitude, double scale)
+{
+	double floorValue = std::floor(magnitude * scale);
+	if (MulSub(magnitude, scale, floorValue) < 0)
+		floorValue -= 1;
+	else if (MulSub(magnitude, scale, floorValue + 1) >= 0)
+		floorValue += 1;
+
+	unsigned long long units = static_cast<unsigned long long>(floorValue);
+	double half = MulSub(magnitude, scale, floorValue + 0.5);
+	if (half > 0 || (half == 0 && (units & 1)))
+		units++;
+	return units;
+}
+
+
+size_t NumberFormat::formatInt(long long value, wchar_t * buffer)
+{
+	// ȡֵʱתΪ޷СĸҲ
+	bool negative = value < 0;
+	unsigned long long magnitude = negative ? 0ULL - static_cast<unsigned long long>(value) : static_cast<unsigned long long>(value);
+
+	wchar_t * end = buffer + INT_BUFFER_SIZE - 1;
+	wchar_t * begin = WriteDigits(end, magnitude, 1);
+	if (negative)
+		*--begin = L'-';
+	return MoveToFront(buffer, begin, end);
+}
+
+size_t NumberFormat::formatFloat(double value, int precision, wchar_t * buffer)
+{
+	if (precision < 0)
+		precision = 0;
+	if (precision > MAX_PRECISION)
+		precision = MAX_PRECISION;
+
+	double magnitude = std::fabs(value);
+	if (precision <= FAST_PRECISION && magnitude * double(s_nPowers[precision]) < FAST_LIMIT)
+	{
+		unsigned long long units = RoundScaled(magnitude, double(s_nPowers[precision]));
+
+		wchar_t * end = buffer + FLOAT_BUFFER_SIZE - 1;
+		wchar_t * begin;
+		if (precision > 0)
+		{
+			begin = WriteDigits(end, units % s_nPowers[precision], precision);
+			*--begin = L'.';
+			begin = WriteDigits(begin, units / s_nPowers[precision], 1);
+		}
+		else
+		{
+			begin = WriteDigits(end, units, 1);
+		}
+		//  swprintf ͬΪ 0 ʱ
+		if (SignBit(value))
+			*--begin = L'-';
+		return MoveToFront(buffer, begin, end);
+	}
+
+	// ֵֵܴͺܶλС swprintfдջϵĻͬڴ
+	int count = swprintf(buffer, FLOAT_BUFFER_SIZE, L"%.*f", precision, value);
+	if (count < 0)
+	{
+		buffer[0] = 0;
+		return 0;
+	}
+	return size_t(count);
+}
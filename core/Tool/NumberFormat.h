@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+
+
+// ָʽΪַַҲڴ
+//  swprintf  "%lld"  "%.*f" ͬ侫ȷֵ˫
+// ļ Windowsƽ̨ϱ
+class NumberFormat
+{
+public:
+	enum
+	{
+		INT_BUFFER_SIZE = 24,		/* formatInt ҪĻС */
+		MAX_PRECISION = 64,			/* formatFloat ֵ֧Сλ */
+		FLOAT_BUFFER_SIZE = 400		/* formatFloat ҪĻС㹻 double */
+	};
+
+public:
+	// ʽbuffer Ҫ INT_BUFFER_SIZE  wchar_tдַβ 0
+	static size_t formatInt(
+		long long value,
+		wchar_t * buffer
+	);
+
+	// ʽ precision λС0 ~ MAX_PRECISION
+	// buffer Ҫ FLOAT_BUFFER_SIZE  wchar_tдַβ 0
+	static size_t formatFloat(
+		double value,
+		int precision,
+		wchar_t * buffer
+	);
+};
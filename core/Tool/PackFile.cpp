@@ -0,0 +1,360 @@
+#include "PackFile.h"
+#include "Lz4.h"
+#include <algorithm>
+#include <cstring>
+
+
+static unsigned int ReadU32(const unsigned char * p)
+{
+	return (unsigned int)p[0] | ((unsigned int)p[1] << 8) | ((unsigned int)p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+static unsigned short ReadU16(const unsigned char * p)
+{
+	return (unsigned short)(p[0] | (p[1] << 8));
+}
+
+static unsigned long long ReadU64(const unsigned char * p)
+{
+	return (unsigned long long)ReadU32(p) | ((unsigned long long)ReadU32(p + 4) << 32);
+}
+
+static void WriteU32(unsigned char * p, unsigned int value)
+{
+	p[0] = (unsigned char)(value);
+	p[1] = (unsigned char)(value >> 8);
+	p[2] = (unsigned char)(value >> 16);
+	p[3] = (unsigned char)(value >> 24);
+}
+
+static void WriteU16(unsigned char * p, unsigned short value)
+{
+	p[0] = (unsigned char)(value);
+	p[1] = (unsigned char)(value >> 8);
+}
+
+static void WriteU64(unsigned char * p, unsigned long long value)
+{
+	WriteU32(p, (unsigned int)value);
+	WriteU32(p + 4, (unsigned int)(value >> 32));
+}
+
+// ļȽʱʹõַ'\' Ϊ '/'ASCII ĸΪСд
+static unsigned char FoldChar(char ch)
+{
+	if (ch == '\\')
+		return '/';
+	if (ch >= 'A' && ch <= 'Z')
+		return (unsigned char)(ch - 'A' + 'a');
+	return (unsigned char)ch;
+}
+
+// ļͷ "./"  "/"
+static void SkipNamePrefix(const char *& name, size_t & length)
+{
+	while (length)
+	{
+		if (length >= 2 && name[0] == '.' && FoldChar(name[1]) == '/')
+		{
+			name += 2;
+			length -= 2;
+		}
+		else if (FoldChar(name[0]) == '/')
+		{
+			name++;
+			length--;
+		}
+		else
+		{
+			break;
+		}
+	}
+}
+
+// Ƚļֵ strcmp ͬ
+static int CompareNames(const char * a, size_t aLength, const char * b, size_t bLength)
+{
+	size_t length = std::min(aLength, bLength);
+	for (size_t i = 0; i < length; i++)
+	{
+		unsigned char ca = FoldChar(a[i]);
+		unsigned char cb = FoldChar(b[i]);
+		if (ca != cb)
+			return ca < cb ? -1 : 1;
+	}
+	if (aLength == bLength)
+		return 0;
+	return aLength < bLength ? -1 : 1;
+}
+
+// ȡ index Ŀ¼ĿУ飩
+static void ReadEntry(const PackFile::View & view, unsigned int index, PackFile::Entry & entry)
+{
+	const unsigned char * p = view.file + PackFile::HEADER_SIZE + size_t(index) * PackFile::ENTRY_SIZE;
+	entry.hash = ReadU64(p);
+	entry.offset = ReadU64(p + 8);
+	entry.storedSize = ReadU64(p + 16);
+	entry.size = ReadU64(p + 24);
+	entry.name = reinterpret_cast<const char *>(view.file + ReadU32(view.file + 12) + ReadU32(p + 32));
+	entry.nameLength = ReadU16(p + 36);
+	entry.flags = ReadU16(p + 38);
+}
+
+// ϣֵ
+static bool EntryLess(const PackFile::Entry & a, const PackFile::Entry & b)
+{
+	if (a.hash != b.hash)
+		return a.hash < b.hash;
+	return CompareNames(a.name, a.nameLength, b.name, b.nameLength) < 0;
+}
+
+
+unsigned long long PackFile::hashName(const char * name, size_t length)
+{
+	SkipNamePrefix(name, length);
+
+	// 64 λ FNV-1a
+	unsigned long long hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < length; i++)
+	{
+		hash ^= FoldChar(name[i]);
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+std::string PackFile::normalizeName(const std::string & name)
+{
+	const char * p = name.c_str();
+	size_t length = name.length();
+	SkipNamePrefix(p, length);
+
+	std::string result(p, length);
+	std::replace(result.begin(), result.end(), '\\', '/');
+	return result;
+}
+
+bool PackFile::parse(const void * file, size_t size, View & view)
+{
+	if (!file || size < HEADER_SIZE)
+		return false;
+
+	const unsigned char * p = static_cast<const unsigned char *>(file);
+	if (ReadU32(p) != MAGIC || ReadU16(p + 4) != VERSION)
+		return false;
+
+	unsigned int entryCount = ReadU32(p + 8);
+	unsigned long long namesOffset = ReadU32(p + 12);
+	unsigned long long namesSize = ReadU32(p + 16);
+	unsigned long long namesEnd = namesOffset + namesSize;
+
+	if (HEADER_SIZE + (unsigned long long)entryCount * ENTRY_SIZE > namesOffset)
+		return false;
+	if (namesEnd > size)
+		return false;
+
+	view.file = p;
+	view.size = size;
+	view.entryCount = entryCount;
+
+	// УĿ֮Ĳټ߽
+	Entry previous = Entry();
+	for (unsigned int i = 0; i < entryCount; i++)
+	{
+		const unsigned char * e = p + HEADER_SIZE + size_t(i) * ENTRY_SIZE;
+		if (ReadU32(e + 32) + (unsigned long long)ReadU16(e + 36) > namesSize)
+			return false;
+
+		Entry entry;
+		ReadEntry(view, i, entry);
+
+		if (entry.offset < namesEnd || entry.offset > size || entry.storedSize > size - entry.offset)
+			return false;
+		if (entry.offset % ALIGNMENT != 0)
+			return false;
+		if (entry.size > size_t(-1))
+			return false;
+		if (!isCompressed(entry) && entry.storedSize != entry.size)
+			return false;
+		if (entry.hash != hashName(entry.name, entry.nameLength))
+			return false;
+		if (i > 0 && !EntryLess(previous, entry))
+			return false;
+
+		previous = entry;
+	}
+	return true;
+}
+
+bool PackFile::getEntry(const View & view, unsigned int index, Entry & entry)
+{
+	if (index >= view.entryCount)
+		return false;
+
+	ReadEntry(view, index, entry);
+	return true;
+}
+
+bool PackFile::find(const View & view, const char * name, Entry & entry)
+{
+	if (!name)
+		return false;
+
+	size_t length = strlen(name);
+	unsigned long long hash = hashName(name, length);
+	SkipNamePrefix(name, length);
+
+	// ֲҵһϣֵС hash Ŀ
+	unsigned int first = 0;
+	unsigned int count = view.entryCount;
+	while (count > 0)
+	{
+		unsigned int step = count / 2;
+		unsigned int middle = first + step;
+		if (ReadU64(view.file + HEADER_SIZE + size_t(middle) * ENTRY_SIZE) < hash)
+		{
+			first = middle + 1;
+			count -= step + 1;
+		}
+		else
+		{
+			count = step;
+		}
+	}
+
+	// ϣֵͬʱȶļ
+	for (unsigned int i = first; i < view.entryCount; i++)
+	{
+		ReadEntry(view, i, entry);
+		if (entry.hash != hash)
+			break;
+		if (CompareNames(entry.name, entry.nameLength, name, length) == 0)
+			return true;
+	}
+	return false;
+}
+
+const unsigned char * PackFile::getData(const View & view, const Entry & entry)
+{
+	return view.file + entry.offset;
+}
+
+bool PackFile::isCompressed(const Entry & entry)
+{
+	return (entry.flags & FLAG_LZ4) != 0;
+}
+
+bool PackFile::extract(const View & view, const Entry & entry, void * dst, size_t dstSize)
+{
+	if (dstSize != entry.size)
+		return false;
+
+	if (isCompressed(entry))
+	{
+		return Lz4::decompress(getData(view, entry), size_t(entry.storedSize), dst, dstSize);
+	}
+
+	// ļ dst Ϊָ
+	if (dstSize)
+	{
+		memcpy(dst, getData(view, entry), dstSize);
+	}
+	return true;
+}
+
+bool PackFile::build(const std::vector<Input> & inputs, std::vector<unsigned char> & file)
+{
+	struct Item
+	{
+		std::string name;
+		unsigned long long hash;
+		const Input * input;
+		std::vector<unsigned char> compressed;
+	};
+
+	std::vector<Item> items(inputs.size());
+	size_t namesSize = 0;
+	for (size_t i = 0; i < inputs.size(); i++)
+	{
+		items[i].name = normalizeName(inputs[i].name);
+		items[i].hash = hashName(items[i].name.c_str(), items[i].name.length());
+		items[i].input = &inputs[i];
+
+		if (items[i].name.empty() || items[i].name.length() > 0xFFFF)
+			return false;
+		namesSize += items[i].name.length();
+	}
+
+	std::sort(items.begin(), items.end(), [](const Item & a, const Item & b)
+	{
+		if (a.hash != b.hash)
+			return a.hash < b.hash;
+		return CompareNames(a.name.c_str(), a.name.length(), b.name.c_str(), b.name.length()) < 0;
+	});
+
+	for (size_t i = 1; i < items.size(); i++)
+	{
+		if (items[i].hash == items[i - 1].hash &&
+			CompareNames(items[i].name.c_str(), items[i].name.length(), items[i - 1].name.c_str(), items[i - 1].name.length()) == 0)
+			return false;
+	}
+
+	size_t namesOffset = HEADER_SIZE + items.size() * ENTRY_SIZE;
+	if (items.size() > 0xFFFFFFFFULL || namesOffset + namesSize > 0xFFFFFFFFULL)
+		return false;
+
+	// ÿļλ
+	unsigned long long offset = namesOffset + namesSize;
+	std::vector<unsigned long long> offsets(items.size());
+	for (size_t i = 0; i < items.size(); i++)
+	{
+		const Input * input = items[i].input;
+		if (input->compress && input->size)
+		{
+			Lz4::compress(input->data, input->size, items[i].compressed);
+			if (items[i].compressed.size() >= input->size)
+				std::vector<unsigned char>().swap(items[i].compressed);
+		}
+
+		offset = (offset + ALIGNMENT - 1) & ~(unsigned long long)(ALIGNMENT - 1);
+		offsets[i] = offset;
+		offset += items[i].compressed.empty() ? input->size : items[i].compressed.size();
+	}
+
+	if (offset > size_t(-1))
+		return false;
+
+	file.assign(size_t(offset), 0);
+	unsigned char * p = &file[0];
+	WriteU32(p, MAGIC);
+	WriteU16(p + 4, VERSION);
+	WriteU32(p + 8, (unsigned int)items.size());
+	WriteU32(p + 12, (unsigned int)namesOffset);
+	WriteU32(p + 16, (unsigned int)namesSize);
+
+	size_t nameOffset = 0;
+	for (size_t i = 0; i < items.size(); i++)
+	{
+		const Input * input = items[i].input;
+		bool compressed = !items[i].compressed.empty();
+		size_t storedSize = compressed ? items[i].compressed.size() : input->size;
+
+		unsigned char * e = p + HEADER_SIZE + i * ENTRY_SIZE;
+		WriteU64(e, items[i].hash);
+		WriteU64(e + 8, offsets[i]);
+		WriteU64(e + 16, storedSize);
+		WriteU64(e + 24, input->size);
+		WriteU32(e + 32, (unsigned int)nameOffset);
+		WriteU16(e + 36, (unsigned short)items[i].name.length());
+		WriteU16(e + 38, compressed ? FLAG_LZ4 : 0);
+
+		memcpy(p + namesOffset + nameOffset, items[i].name.data(), items[i].name.length());
+		nameOffset += items[i].name.length();
+
+		if (storedSize)
+		{
+			memcpy(p + offsets[i], compressed ? &items[i].compressed[0] : input->data, storedSize);
+		}
+	}
+	return true;
+}
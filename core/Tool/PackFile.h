@@ -0,0 +1,125 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+// Դļ.e2dp
+// ԴļϲΪһļͨڴӳȡļݿɲֱʹ
+// ļ Windows߿ƽ̨ϱ
+//
+// ļ֣С򣩣
+//   ļͷ   32 ֽڣ PackFile::Header
+//   Ŀ¼     entryCount Ŀÿ 40 ֽڣƹϣֵƣ
+//   Ʊ   ļUTF-8 '/' ָβ 0
+//   ļ ÿļ 16 ֽڶλÿʼɵʹ LZ4 ѹ
+//
+// ļҲ ASCII ĸĴСд'\'  '/' Ϊͬ
+class PackFile
+{
+public:
+	// ļʶ "E2DP"
+	static const unsigned int MAGIC = 0x50443245;
+
+	// ļʽ汾
+	static const unsigned short VERSION = 1;
+
+	// ļʹ LZ4 ѹ
+	static const unsigned short FLAG_LZ4 = 0x0001;
+
+	// ļͷĴС
+	static const size_t HEADER_SIZE = 32;
+
+	// Ŀ¼ĿĴС
+	static const size_t ENTRY_SIZE = 40;
+
+	// ļݵĶֽ
+	static const size_t ALIGNMENT = 16;
+
+	// Ŀ¼Ŀ
+	struct Entry
+	{
+		unsigned long long	hash;		/* ƹϣֵ */
+		unsigned long long	offset;		/* ļԴеƫ */
+		unsigned long long	storedSize;	/* ļԴеĴС */
+		unsigned long long	size;		/* ļѹĴС */
+		const char *		name;		/* ļָƱ 0 β */
+		unsigned short		nameLength;
+		unsigned short		flags;
+	};
+
+	// Դֻͼκ
+	struct View
+	{
+		const unsigned char *	file;
+		size_t					size;
+		unsigned int			entryCount;
+	};
+
+	// ʱļ
+	struct Input
+	{
+		std::string		name;		/* ļԴе */
+		const void *	data;
+		size_t			size;
+		bool			compress;	/* Ƿѹ */
+	};
+
+public:
+	// ԴУĿ¼Ŀ
+	static bool parse(
+		const void * file,
+		size_t size,
+		View & view
+	);
+
+	// ȡĿ¼Ŀ
+	static bool getEntry(
+		const View & view,
+		unsigned int index,
+		Entry & entry
+	);
+
+	// Ʋļ
+	static bool find(
+		const View & view,
+		const char * name,
+		Entry & entry
+	);
+
+	// ȡļԴе
+	static const unsigned char * getData(
+		const View & view,
+		const Entry & entry
+	);
+
+	// жļǷ񾭹ѹ
+	static bool isCompressed(
+		const Entry & entry
+	);
+
+	// ȡļݣdst ĴСΪ entry.size
+	static bool extract(
+		const View & view,
+		const Entry & entry,
+		void * dst,
+		size_t dstSize
+	);
+
+	// 淶ļ'\' 滻Ϊ '/'ȥͷ "./"  "/"
+	static std::string normalizeName(
+		const std::string & name
+	);
+
+	// ļĹϣֵ ASCII ĸСд
+	static unsigned long long hashName(
+		const char * name,
+		size_t length
+	);
+
+	// Դļظʱ false
+	static bool build(
+		const std::vector<Input> & inputs,
+		std::vector<unsigned char> & file
+	);
+};
@@ -0,0 +1,30 @@
+#pragma once
+#include "..\etools.h"
+#include <memory>
+#include <vector>
+
+class PackMapping;
+
+// ѹԴеļ
+struct PackFileData
+{
+	const void *	data;	/* ļݣδѹʱֱָڴӳ */
+	size_t			size;
+	std::shared_ptr<PackMapping> pack;	/* Դ֤ڴӳʹڼЧ */
+	std::vector<unsigned char> buffer;	/* ѹļѹ */
+};
+
+// ѹصԴжȡļصԴ
+bool ReadPackFile(
+	const e2d::EString & fileName,
+	PackFileData & file
+);
+
+// ȡѹԴָչСд L".ttf"ļ
+void GetPackFiles(
+	const e2d::EString & extension,
+	std::vector<e2d::EString> & fileNames
+);
+
+// ȡԴ״̬İ汾ţÿιػжغ
+UINT GetPackGeneration();
@@ -0,0 +1,429 @@
+#include "SoftRaster.h"
+#include <cmath>
+
+//  SOFTRASTER_NO_SSE2 ʱֻʹصʵ֣ڼʵֵĽǷͬ
+#if !defined(SOFTRASTER_NO_SSE2) && (defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__))
+#define SOFTRASTER_SSE2
+#include <emmintrin.h>
+#endif
+
+
+//  x / 255 룬x  65025
+static inline unsigned int Div255(unsigned int x)
+{
+	x += 128;
+	return (x + (x >> 8)) >> 8;
+}
+
+// һأdst = src * op + dst * (1 - srcAlpha * op)op ȡֵ 0 ~ 256
+static inline unsigned int BlendPixel(unsigned int d, unsigned int s, unsigned int op)
+{
+	unsigned int a = ((s >> 24) * op) >> 8;
+	unsigned int inv = 255 - a;
+	unsigned int result = 0;
+	for (int shift = 0; shift < 32; shift += 8)
+	{
+		unsigned int c = ((((s >> shift) & 0xFF) * op) >> 8) + Div255(((d >> shift) & 0xFF) * inv);
+		result |= (c > 255 ? 255 : c) << shift;
+	}
+	return result;
+}
+
+#ifdef SOFTRASTER_SSE2
+// ͬ BlendPixelһλ 4 
+static inline __m128i BlendPixels(__m128i d, __m128i s, __m128i op)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i full = _mm_set1_epi16(255);
+	const __m128i half = _mm_set1_epi16(128);
+
+	__m128i slo = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), op), 8);
+	__m128i shi = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), op), 8);
+
+	// ÿص alpha Ƶ 4 ͨ
+	__m128i alo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(slo, 0xFF), 0xFF);
+	__m128i ahi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(shi, 0xFF), 0xFF);
+	__m128i invlo = _mm_sub_epi16(full, alo);
+	__m128i invhi = _mm_sub_epi16(full, ahi);
+
+	// ͬ Div255
+	__m128i dlo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), invlo), half);
+	__m128i dhi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), invhi), half);
+	dlo = _mm_srli_epi16(_mm_add_epi16(dlo, _mm_srli_epi16(dlo, 8)), 8);
+	dhi = _mm_srli_epi16(_mm_add_epi16(dhi, _mm_srli_epi16(dhi, 8)), 8);
+
+	return _mm_packus_epi16(_mm_add_epi16(slo, dlo), _mm_add_epi16(shi, dhi));
+}
+#endif
+
+// һԴػϵ
+static void BlendSpan(unsigned int * dst, const unsigned int * src, int count, unsigned int op)
+{
+	int i = 0;
+#ifdef SOFTRASTER_SSE2
+	__m128i vop = _mm_set1_epi16(static_cast<short>(op));
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+		__m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), BlendPixels(d, s, vop));
+	}
+#endif
+	for (; i < count; i++)
+	{
+		dst[i] = BlendPixel(dst[i], src[i], op);
+	}
+}
+
+// ͬһɫϵһ
+static void BlendColor(unsigned int * dst, unsigned int color, int count)
+{
+	if ((color >> 24) == 0xFF)
+	{
+		// ͸ɫֱӸ
+		for (int i = 0; i < count; i++)
+			dst[i] = color;
+		return;
+	}
+
+	int i = 0;
+#ifdef SOFTRASTER_SSE2
+	__m128i vop = _mm_set1_epi16(256);
+	__m128i s = _mm_set1_epi32(static_cast<int>(color));
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), BlendPixels(d, s, vop));
+	}
+#endif
+	for (; i < count; i++)
+	{
+		dst[i] = BlendPixel(dst[i], color, 256);
+	}
+}
+
+// ͸תΪ 0 ~ 256 
+static unsigned int ToOpacity(float opacity)
+{
+	if (opacity <= 0)
+		return 0;
+	if (opacity >= 1)
+		return 256;
+	return static_cast<unsigned int>(opacity * 256 + 0.5f);
+}
+
+
+SoftRaster::SoftRaster()
+	: m_nWidth(0)
+	, m_nHeight(0)
+	, m_bInvertible(true)
+{
+	const float identity[6] = { 1, 0, 0, 1, 0, 0 };
+	setTransform(identity);
+	resetClip();
+}
+
+void SoftRaster::resize(int width, int height)
+{
+	m_nWidth = width > 0 ? width : 0;
+	m_nHeight = height > 0 ? height : 0;
+	m_vPixels.assign(size_t(m_nWidth) * m_nHeight, 0);
+	resetClip();
+}
+
+int SoftRaster::getWidth() const
+{
+	return m_nWidth;
+}
+
+int SoftRaster::getHeight() const
+{
+	return m_nHeight;
+}
+
+const unsigned int * SoftRaster::getPixels() const
+{
+	return m_vPixels.empty() ? nullptr : &m_vPixels[0];
+}
+
+void SoftRaster::setTransform(const float matrix[6])
+{
+	for (int i = 0; i < 6; i++)
+		m_Matrix[i] = matrix[i];
+
+	// 󣬻ʱӻ귴Դ
+	float det = matrix[0] * matrix[3] - matrix[1] * matrix[2];
+	m_bInvertible = det != 0;
+	if (!m_bInvertible)
+		return;
+
+	m_Inverse[0] = matrix[3] / det;
+	m_Inverse[1] = -matrix[1] / det;
+	m_Inverse[2] = -matrix[2] / det;
+	m_Inverse[3] = matrix[0] / det;
+	m_Inverse[4] = -(matrix[4] * m_Inverse[0] + matrix[5] * m_Inverse[2]);
+	m_Inverse[5] = -(matrix[4] * m_Inverse[1] + matrix[5] * m_Inverse[3]);
+}
+
+void SoftRaster::setClip(int left, int top, int right, int bottom)
+{
+	m_nClipLeft = left > 0 ? left : 0;
+	m_nClipTop = top > 0 ? top : 0;
+	m_nClipRight = right < m_nWidth ? right : m_nWidth;
+	m_nClipBottom = bottom < m_nHeight ? bottom : m_nHeight;
+}
+
+void SoftRaster::resetClip()
+{
+	m_nClipLeft = 0;
+	m_nClipTop = 0;
+	m_nClipRight = m_nWidth;
+	m_nClipBottom = m_nHeight;
+}
+
+void SoftRaster::clear(unsigned int color)
+{
+	for (int y = m_nClipTop; y < m_nClipBottom; y++)
+	{
+		unsigned int * row = &m_vPixels[size_t(y) * m_nWidth];
+		for (int x = m_nClipLeft; x < m_nClipRight; x++)
+			row[x] = color;
+	}
+}
+
+void SoftRaster::fillRect(float left, float top, float right, float bottom, unsigned int color)
+{
+	const float rect[4] = { left, top, right, bottom };
+	int y0, y1;
+	if (color == 0 || !_getRows(rect, y0, y1))
+		return;
+
+	for (int y = y0; y < y1; y++)
+	{
+		int x0, x1;
+		if (_getSpan(y, rect, x0, x1))
+		{
+			BlendColor(&m_vPixels[size_t(y) * m_nWidth + x0], color, x1 - x0);
+		}
+	}
+}
+
+void SoftRaster::drawLine(float x0, float y0, float x1, float y1, unsigned int color)
+{
+	if (color == 0)
+		return;
+
+	// 任˵ز
+	float ax = x0 * m_Matrix[0] + y0 * m_Matrix[2] + m_Matrix[4];
+	float ay = x0 * m_Matrix[1] + y0 * m_Matrix[3] + m_Matrix[5];
+	float bx = x1 * m_Matrix[0] + y1 * m_Matrix[2] + m_Matrix[4];
+	float by = x1 * m_Matrix[1] + y1 * m_Matrix[3] + m_Matrix[5];
+
+	float dx = bx - ax;
+	float dy = by - ay;
+	int steps = static_cast<int>(std::ceil(std::fabs(dx) > std::fabs(dy) ? std::fabs(dx) : std::fabs(dy)));
+	if (steps <= 0)
+		steps = 1;
+
+	for (int i = 0; i <= steps; i++)
+	{
+		float t = float(i) / steps;
+		int x = static_cast<int>(std::floor(ax + dx * t));
+		int y = static_cast<int>(std::floor(ay + dy * t));
+		if (x >= m_nClipLeft && x < m_nClipRight && y >= m_nClipTop && y < m_nClipBottom)
+		{
+			unsigned int & pixel = m_vPixels[size_t(y) * m_nWidth + x];
+			pixel = BlendPixel(pixel, color, 256);
+		}
+	}
+}
+
+void SoftRaster::drawImage(const Image & image, const float dest[4], const float src[4], float opacity)
+{
+	unsigned int op = ToOpacity(opacity);
+	int y0, y1;
+	if (op == 0 || !image.pixels || dest[2] <= dest[0] || dest[3] <= dest[1] || !_getRows(dest, y0, y1))
+		return;
+
+	// ԴڿɲطΧ
+	int sl = static_cast<int>(std::floor(src[0]));
+	int st = static_cast<int>(std::floor(src[1]));
+	int sr = static_cast<int>(std::ceil(src[2]));
+	int sb = static_cast<int>(std::ceil(src[3]));
+	if (sl < 0) sl = 0;
+	if (st < 0) st = 0;
+	if (sr > image.width) sr = image.width;
+	if (sb > image.height) sb = image.height;
+	if (sl >= sr || st >= sb)
+		return;
+
+	float scaleX = (src[2] - src[0]) / (dest[2] - dest[0]);
+	float scaleY = (src[3] - src[1]) / (dest[3] - dest[1]);
+
+	// ֻƽҲʱÿеԴģҪ
+	float offsetX = src[0] - dest[0] - m_Matrix[4];
+	float offsetY = src[1] - dest[1] - m_Matrix[5];
+	bool bDirect = m_Matrix[0] == 1 && m_Matrix[1] == 0 && m_Matrix[2] == 0 && m_Matrix[3] == 1 &&
+		scaleX == 1 && scaleY == 1 && offsetX == std::floor(offsetX) && offsetY == std::floor(offsetY);
+
+	for (int y = y0; y < y1; y++)
+	{
+		int x0, x1;
+		if (!_getSpan(y, dest, x0, x1))
+			continue;
+
+		unsigned int * dst = &m_vPixels[size_t(y) * m_nWidth + x0];
+		int count = x1 - x0;
+
+		if (bDirect)
+		{
+			int sy = y + static_cast<int>(offsetY);
+			int sx = x0 + static_cast<int>(offsetX);
+			if (sy < st || sy >= sb)
+				continue;
+			// õԴĲ
+			if (sx < sl)
+			{
+				dst += sl - sx;
+				count -= sl - sx;
+				sx = sl;
+			}
+			if (sx + count > sr)
+				count = sr - sx;
+			if (count > 0)
+				BlendSpan(dst, image.pixels + size_t(sy) * image.stride + sx, count, op);
+			continue;
+		}
+
+		// طԴ꣬ʱͳһ
+		if (m_vSpan.size() < size_t(count))
+			m_vSpan.resize(count);
+
+		float py = y + 0.5f;
+		for (int i = 0; i < count; i++)
+		{
+			float px = x0 + i + 0.5f;
+			float u = px * m_Inverse[0] + py * m_Inverse[2] + m_Inverse[4];
+			float v = px * m_Inverse[1] + py * m_Inverse[3] + m_Inverse[5];
+			int sx = static_cast<int>(std::floor(src[0] + (u - dest[0]) * scaleX));
+			int sy = static_cast<int>(std::floor(src[1] + (v - dest[1]) * scaleY));
+			sx = sx < sl ? sl : (sx >= sr ? sr - 1 : sx);
+			sy = sy < st ? st : (sy >= sb ? sb - 1 : sy);
+			m_vSpan[i] = image.pixels[size_t(sy) * image.stride + sx];
+		}
+		BlendSpan(dst, &m_vSpan[0], count, op);
+	}
+}
+
+unsigned int SoftRaster::premultiply(unsigned int rgb, float alpha)
+{
+	unsigned int a = alpha <= 0 ? 0 : (alpha >= 1 ? 255 : static_cast<unsigned int>(alpha * 255 + 0.5f));
+	unsigned int r = (((rgb >> 16) & 0xFF) * a + 127) / 255;
+	unsigned int g = (((rgb >> 8) & 0xFF) * a + 127) / 255;
+	unsigned int b = ((rgb & 0xFF) * a + 127) / 255;
+	return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+size_t SoftRaster::compare(const unsigned int * a, const unsigned int * b, size_t count, unsigned int tolerance)
+{
+	if (tolerance > 255)
+		tolerance = 255;
+
+	size_t diff = 0;
+	size_t i = 0;
+#ifdef SOFTRASTER_SSE2
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i tol = _mm_set1_epi8(static_cast<char>(tolerance));
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+		__m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+		// ֵͨľֵݲĲֲΪ 0
+		__m128i d = _mm_or_si128(_mm_subs_epu8(va, vb), _mm_subs_epu8(vb, va));
+		__m128i same = _mm_cmpeq_epi32(_mm_subs_epu8(d, tol), zero);
+		int mask = _mm_movemask_ps(_mm_castsi128_ps(same));
+		diff += 4 - ((mask & 1) + ((mask >> 1) & 1) + ((mask >> 2) & 1) + ((mask >> 3) & 1));
+	}
+#endif
+	for (; i < count; i++)
+	{
+		for (int shift = 0; shift < 32; shift += 8)
+		{
+			int ca = (a[i] >> shift) & 0xFF;
+			int cb = (b[i] >> shift) & 0xFF;
+			if ((ca > cb ? ca - cb : cb - ca) > static_cast<int>(tolerance))
+			{
+				diff++;
+				break;
+			}
+		}
+	}
+	return diff;
+}
+
+bool SoftRaster::_getRows(const float rect[4], int & y0, int & y1) const
+{
+	if (!m_bInvertible || rect[2] <= rect[0] || rect[3] <= rect[1])
+		return false;
+
+	// 任ĸǵ귶Χ
+	float minY = 0, maxY = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		float x = rect[(i & 1) ? 2 : 0];
+		float y = rect[(i & 2) ? 3 : 1];
+		float ty = x * m_Matrix[1] + y * m_Matrix[3] + m_Matrix[5];
+		if (i == 0 || ty < minY) minY = ty;
+		if (i == 0 || ty > maxY) maxY = ty;
+	}
+
+	y0 = static_cast<int>(std::floor(minY));
+	y1 = static_cast<int>(std::ceil(maxY));
+	if (y0 < m_nClipTop) y0 = m_nClipTop;
+	if (y1 > m_nClipBottom) y1 = m_nClipBottom;
+	return y0 < y1 && m_nClipLeft < m_nClipRight;
+}
+
+bool SoftRaster::_getSpan(int y, const float rect[4], int & x0, int & x1) const
+{
+	// ķԴ (u, v)Ƕ px Ժ
+	// ֱ uv ھڵ px Χȡ
+	float py = y + 0.5f;
+	float minX = static_cast<float>(m_nClipLeft);
+	float maxX = static_cast<float>(m_nClipRight);
+
+	for (int axis = 0; axis < 2; axis++)
+	{
+		float k = m_Inverse[axis];
+		float c = py * m_Inverse[axis + 2] + m_Inverse[axis + 4];
+		float lo = rect[axis];
+		float hi = rect[axis + 2];
+
+		if (k == 0)
+		{
+			if (c < lo || c >= hi)
+				return false;
+			continue;
+		}
+
+		float a = (lo - c) / k;
+		float b = (hi - c) / k;
+		if (a > b)
+		{
+			float t = a;
+			a = b;
+			b = t;
+		}
+		// ΪڵķΧ
+		a -= 0.5f;
+		b -= 0.5f;
+		if (a > minX) minX = a;
+		if (b < maxX) maxX = b;
+	}
+
+	x0 = static_cast<int>(std::ceil(minX));
+	x1 = static_cast<int>(std::ceil(maxX));
+	if (x0 < m_nClipLeft) x0 = m_nClipLeft;
+	if (x1 > m_nClipRight) x1 = m_nClipRight;
+	return x0 < x1;
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+
+// դ
+// ڴе 32 λ BGRA ͼԤ alphaϻλͼκ߶Σ
+// ֶ֧ά任;βüػ֧ SSE2 ʱÿδ 4 
+// ļ Windowsƽ̨ϱ
+//
+// ֵ 0xAARRGGBB ȡСڴΪ BGRA
+// ϵĽֻȡ룬Ƿʹ SSE2 ޹أڻȶ
+class SoftRaster
+{
+public:
+	// ֻԴͼ
+	struct Image
+	{
+		const unsigned int *	pixels;
+		int						width;
+		int						height;
+		int						stride;		/* ÿе */
+	};
+
+public:
+	SoftRaster();
+
+	// ޸ĻСݱ
+	void resize(
+		int width,
+		int height
+	);
+
+	// ȡ
+	int getWidth() const;
+
+	// ȡ߶
+	int getHeight() const;
+
+	// ȡأÿ getWidth() 
+	const unsigned int * getPixels() const;
+
+	// ñ任˳ͬ D2D1_MATRIX_3X2_F
+	// x' = x * m[0] + y * m[2] + m[4]y' = x * m[1] + y * m[3] + m[5]
+	void setTransform(
+		const float matrix[6]
+	);
+
+	// òüأ֮ĻֻӰڵ
+	void setClip(
+		int left,
+		int top,
+		int right,
+		int bottom
+	);
+
+	// ȡü
+	void resetClip();
+
+	// ʹɫü򣬲л
+	void clear(
+		unsigned int color
+	);
+
+	// Σ任ǰ꣩
+	void fillRect(
+		float left,
+		float top,
+		float right,
+		float bottom,
+		unsigned int color
+	);
+
+	// ƿΪ 1 ص߶Σ任ǰ꣩
+	void drawLine(
+		float x0,
+		float y0,
+		float x1,
+		float y1,
+		unsigned int color
+	);
+
+	// ͼ src Ƶ dest ˳Ϊ left, top, right, bottom
+	// ʹopacity ȡֵ 0 ~ 1
+	void drawImage(
+		const Image & image,
+		const float dest[4],
+		const float src[4],
+		float opacity
+	);
+
+	//  0xRRGGBB ɫͲ͸תΪԤ alpha ֵ
+	static unsigned int premultiply(
+		unsigned int rgb,
+		float alpha
+	);
+
+	// Ƚͼ񣬷һֵͨ tolerance 
+	static size_t compare(
+		const unsigned int * a,
+		const unsigned int * b,
+		size_t count,
+		unsigned int tolerance
+	);
+
+private:
+	// һλڱ任ڵطΧ [x0, x1)Ϊʱ false
+	bool _getSpan(
+		int y,
+		const float rect[4],
+		int & x0,
+		int & x1
+	) const;
+
+	// 任θǵзΧ [y0, y1)
+	bool _getRows(
+		const float rect[4],
+		int & y0,
+		int & y1
+	) const;
+
+private:
+	int		m_nWidth;
+	int		m_nHeight;
+	int		m_nClipLeft;
+	int		m_nClipTop;
+	int		m_nClipRight;
+	int		m_nClipBottom;
+	float	m_Matrix[6];
+	float	m_Inverse[6];
+	bool	m_bInvertible;
+	std::vector<unsigned int>	m_vPixels;
+	std::vector<unsigned int>	m_vSpan;	/* һԴصʱ */
+};
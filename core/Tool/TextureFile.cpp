@@ -0,0 +1,179 @@
+#include "TextureFile.h"
+#include "Lz4.h"
+#include <cstring>
+
+
+static unsigned int ReadU32(const unsigned char * p)
+{
+	return (unsigned int)p[0] | ((unsigned int)p[1] << 8) | ((unsigned int)p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+static unsigned short ReadU16(const unsigned char * p)
+{
+	return (unsigned short)(p[0] | (p[1] << 8));
+}
+
+static void WriteU32(unsigned char * p, unsigned int value)
+{
+	p[0] = (unsigned char)(value);
+	p[1] = (unsigned char)(value >> 8);
+	p[2] = (unsigned char)(value >> 16);
+	p[3] = (unsigned char)(value >> 24);
+}
+
+static void WriteU16(unsigned char * p, unsigned short value)
+{
+	p[0] = (unsigned char)(value);
+	p[1] = (unsigned char)(value >> 8);
+}
+
+
+bool TextureFile::isTextureFile(const void * file, size_t size)
+{
+	return file && size >= HEADER_SIZE && ReadU32(static_cast<const unsigned char *>(file)) == MAGIC;
+}
+
+bool TextureFile::parse(const void * file, size_t size, View & view)
+{
+	if (!isTextureFile(file, size))
+		return false;
+
+	const unsigned char * p = static_cast<const unsigned char *>(file);
+
+	Header & header = view.header;
+	header.magic = ReadU32(p);
+	header.version = ReadU16(p + 4);
+	header.flags = ReadU16(p + 6);
+	header.width = ReadU32(p + 8);
+	header.height = ReadU32(p + 12);
+	header.stride = ReadU32(p + 16);
+	header.frameCount = ReadU32(p + 20);
+	header.dataOffset = ReadU32(p + 24);
+	header.dataSize = ReadU32(p + 28);
+
+	if (header.version != VERSION)
+		return false;
+	if (header.width == 0 || header.height == 0)
+		return false;
+	if (header.width > header.stride / 4)
+		return false;
+
+	// ֡ݱλļڣһص
+	unsigned long long framesEnd = HEADER_SIZE + (unsigned long long)header.frameCount * FRAME_SIZE;
+	if (framesEnd > header.dataOffset)
+		return false;
+	if ((unsigned long long)header.dataOffset + header.dataSize > size)
+		return false;
+
+	unsigned long long pixelSize = (unsigned long long)header.stride * header.height;
+	if (pixelSize > size_t(-1))
+		return false;
+	if (!(header.flags & FLAG_LZ4) && header.dataSize != pixelSize)
+		return false;
+
+	view.frames.resize(header.frameCount);
+	for (unsigned int i = 0; i < header.frameCount; i++)
+	{
+		const unsigned char * f = p + HEADER_SIZE + i * FRAME_SIZE;
+		Frame & frame = view.frames[i];
+		frame.x = ReadU32(f);
+		frame.y = ReadU32(f + 4);
+		frame.width = ReadU32(f + 8);
+		frame.height = ReadU32(f + 12);
+
+		if ((unsigned long long)frame.x + frame.width > header.width ||
+			(unsigned long long)frame.y + frame.height > header.height)
+			return false;
+	}
+
+	view.data = p + header.dataOffset;
+	return true;
+}
+
+size_t TextureFile::getPixelSize(const View & view)
+{
+	return size_t(view.header.stride) * view.header.height;
+}
+
+bool TextureFile::isCompressed(const View & view)
+{
+	return (view.header.flags & FLAG_LZ4) != 0;
+}
+
+bool TextureFile::decode(const View & view, void * pixels, size_t size)
+{
+	if (size != getPixelSize(view))
+		return false;
+
+	if (isCompressed(view))
+	{
+		return Lz4::decompress(view.data, view.header.dataSize, pixels, size);
+	}
+
+	memcpy(pixels, view.data, size);
+	return true;
+}
+
+bool TextureFile::encode(
+	unsigned int width,
+	unsigned int height,
+	unsigned int stride,
+	const void * pixels,
+	const std::vector<Frame> & frames,
+	bool compress,
+	std::vector<unsigned char> & file
+)
+{
+	if (width == 0 || height == 0 || width > stride / 4 || !pixels)
+		return false;
+
+	for (size_t i = 0; i < frames.size(); i++)
+	{
+		if ((unsigned long long)frames[i].x + frames[i].width > width ||
+			(unsigned long long)frames[i].y + frames[i].height > height)
+			return false;
+	}
+
+	size_t pixelSize = size_t(stride) * height;
+
+	std::vector<unsigned char> compressed;
+	unsigned short flags = 0;
+	if (compress)
+	{
+		Lz4::compress(pixels, pixelSize, compressed);
+		if (compressed.size() < pixelSize)
+			flags |= FLAG_LZ4;
+	}
+
+	const unsigned char * data = flags ? &compressed[0] : static_cast<const unsigned char *>(pixels);
+	size_t dataSize = flags ? compressed.size() : pixelSize;
+	// ݰ 16 ֽڶ
+	size_t dataOffset = (HEADER_SIZE + frames.size() * FRAME_SIZE + 15) & ~size_t(15);
+
+	if (dataOffset + dataSize > 0xFFFFFFFFULL)
+		return false;
+
+	file.assign(dataOffset + dataSize, 0);
+	unsigned char * p = &file[0];
+	WriteU32(p, MAGIC);
+	WriteU16(p + 4, VERSION);
+	WriteU16(p + 6, flags);
+	WriteU32(p + 8, width);
+	WriteU32(p + 12, height);
+	WriteU32(p + 16, stride);
+	WriteU32(p + 20, (unsigned int)frames.size());
+	WriteU32(p + 24, (unsigned int)dataOffset);
+	WriteU32(p + 28, (unsigned int)dataSize);
+
+	for (size_t i = 0; i < frames.size(); i++)
+	{
+		unsigned char * f = p + HEADER_SIZE + i * FRAME_SIZE;
+		WriteU32(f, frames[i].x);
+		WriteU32(f + 4, frames[i].y);
+		WriteU32(f + 8, frames[i].width);
+		WriteU32(f + 12, frames[i].height);
+	}
+
+	memcpy(p + dataOffset, data, dataSize);
+	return true;
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+
+// Ԥļ.e2dt
+// ļбԤ Alpha  BGRA أʱ룬ֱӴڴӳϴ
+// ļ Windowsƽ̨ϱ롢ת
+//
+// ļ֣С򣩣
+//   ļͷ   32 ֽڣ TextureFile::Header
+//   ֡   frameCount  TextureFile::Frameÿ 16 ֽ
+//     dataOffset16 ֽڶ룩ʼ dataSize ֽ
+//            δѹʱΪ stride * height ֽڣΪ LZ4 ʽ
+class TextureFile
+{
+public:
+	// ļʶ "E2DT"
+	static const unsigned int MAGIC = 0x54443245;
+
+	// ļʽ汾
+	static const unsigned short VERSION = 1;
+
+	// ʹ LZ4 ѹ
+	static const unsigned short FLAG_LZ4 = 0x0001;
+
+	// ļͷ
+	struct Header
+	{
+		unsigned int	magic;
+		unsigned short	version;
+		unsigned short	flags;
+		unsigned int	width;		/* ͼƬȣأ */
+		unsigned int	height;		/* ͼƬ߶ȣأ */
+		unsigned int	stride;		/* ÿռõֽ */
+		unsigned int	frameCount;	/* ֡ */
+		unsigned int	dataOffset;	/* ļеƫ */
+		unsigned int	dataSize;	/* ݵĴС */
+	};
+
+	// ֡ͼƬеľ
+	struct Frame
+	{
+		unsigned int	x;
+		unsigned int	y;
+		unsigned int	width;
+		unsigned int	height;
+	};
+
+	// ļֻͼdata ָԭʼļݣ
+	struct View
+	{
+		Header				header;
+		std::vector<Frame>	frames;
+		const unsigned char *	data;
+	};
+
+	// ļͷĴС
+	static const size_t HEADER_SIZE = 32;
+
+	// ֡ĴС
+	static const size_t FRAME_SIZE = 16;
+
+public:
+	// жǷļʶͷ
+	static bool isTextureFile(
+		const void * file,
+		size_t size
+	);
+
+	// ļݣУʧʱ false
+	static bool parse(
+		const void * file,
+		size_t size,
+		View & view
+	);
+
+	// ȡݵĴС
+	static size_t getPixelSize(
+		const View & view
+	);
+
+	// жǷ񾭹ѹ
+	static bool isCompressed(
+		const View & view
+	);
+
+	// ݣpixels ĴСΪ getPixelSize(view)
+	static bool decode(
+		const View & view,
+		void * pixels,
+		size_t size
+	);
+
+	// Ԥ Alpha  BGRA رΪļ
+	// ѹûмСʱΪδѹ
+	static bool encode(
+		unsigned int width,
+		unsigned int height,
+		unsigned int stride,
+		const void * pixels,
+		const std::vector<Frame> & frames,
+		bool compress,
+		std::vector<unsigned char> & file
+	);
+};
@@ -0,0 +1,314 @@
+#include "Utf8.h"
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define UTF8_SSE2
+#include <emmintrin.h>
+#endif
+
+
+// 滻Чеַ
+static const unsigned int REPLACEMENT_CHAR = 0xFFFD;
+
+// Ƿ 0x80 ~ 0xBF ֮ĺֽ
+static bool IsContinuation(unsigned char byte)
+{
+	return (byte & 0xC0) == 0x80;
+}
+
+// һ ASCII ַضȡֽcode ַ
+// Чʱ code Ϊ U+FFFDȡֽΪЧЧǰ׺ 1 ֽڣ
+static size_t DecodeOne(const unsigned char * p, const unsigned char * end, unsigned int & code, bool & valid)
+{
+	unsigned char lead = p[0];
+	size_t count;
+	// ڶֽڵЧΧų롢ͳ U+10FFFF ַ
+	unsigned char low = 0x80, high = 0xBF;
+
+	if (lead >= 0xC2 && lead <= 0xDF)
+	{
+		count = 2;
+		code = lead & 0x1F;
+	}
+	else if (lead >= 0xE0 && lead <= 0xEF)
+	{
+		count = 3;
+		code = lead & 0x0F;
+		if (lead == 0xE0) low = 0xA0;
+		if (lead == 0xED) high = 0x9F;
+	}
+	else if (lead >= 0xF0 && lead <= 0xF4)
+	{
+		count = 4;
+		code = lead & 0x07;
+		if (lead == 0xF0) low = 0x90;
+		if (lead == 0xF4) high = 0x8F;
+	}
+	else
+	{
+		code = REPLACEMENT_CHAR;
+		valid = false;
+		return 1;
+	}
+
+	for (size_t i = 1; i < count; i++)
+	{
+		unsigned char byte = (p + i < end) ? p[i] : 0;
+		bool inRange = (i == 1) ? (byte >= low && byte <= high) : IsContinuation(byte);
+		if (!inRange)
+		{
+			code = REPLACEMENT_CHAR;
+			valid = false;
+			return i;
+		}
+		code = (code << 6) | (byte & 0x3F);
+	}
+	return count;
+}
+
+// дһַд wchar_t 
+static size_t WriteWide(unsigned int code, wchar_t * dst)
+{
+	if (sizeof(wchar_t) == 2 && code >= 0x10000)
+	{
+		code -= 0x10000;
+		dst[0] = static_cast<wchar_t>(0xD800 + (code >> 10));
+		dst[1] = static_cast<wchar_t>(0xDC00 + (code & 0x3FF));
+		return 2;
+	}
+	dst[0] = static_cast<wchar_t>(code);
+	return 1;
+}
+
+// ȡһ ASCII Ŀַضȡ wchar_t ɶԵĴͳΧֵ U+FFFD
+static size_t ReadWide(const wchar_t * src, const wchar_t * end, unsigned int & code)
+{
+	code = static_cast<unsigned int>(src[0]);
+	if (sizeof(wchar_t) == 2)
+	{
+		code &= 0xFFFF;
+		if (code >= 0xD800 && code <= 0xDBFF && src + 1 < end)
+		{
+			unsigned int low = static_cast<unsigned int>(src[1]) & 0xFFFF;
+			if (low >= 0xDC00 && low <= 0xDFFF)
+			{
+				code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+				return 2;
+			}
+		}
+	}
+	if ((code >= 0xD800 && code <= 0xDFFF) || code > 0x10FFFF)
+	{
+		code = REPLACEMENT_CHAR;
+	}
+	return 1;
+}
+
+// дһ ASCII ַ UTF-8 룬дֽ
+static size_t WriteUtf8(unsigned int code, unsigned char * dst)
+{
+	if (code < 0x800)
+	{
+		dst[0] = static_cast<unsigned char>(0xC0 | (code >> 6));
+		dst[1] = static_cast<unsigned char>(0x80 | (code & 0x3F));
+		return 2;
+	}
+	if (code < 0x10000)
+	{
+		dst[0] = static_cast<unsigned char>(0xE0 | (code >> 12));
+		dst[1] = static_cast<unsigned char>(0x80 | ((code >> 6) & 0x3F));
+		dst[2] = static_cast<unsigned char>(0x80 | (code & 0x3F));
+		return 3;
+	}
+	dst[0] = static_cast<unsigned char>(0xF0 | (code >> 18));
+	dst[1] = static_cast<unsigned char>(0x80 | ((code >> 12) & 0x3F));
+	dst[2] = static_cast<unsigned char>(0x80 | ((code >> 6) & 0x3F));
+	dst[3] = static_cast<unsigned char>(0x80 | (code & 0x3F));
+	return 4;
+}
+
+#ifdef UTF8_SSE2
+
+// ͷ ASCII ַÿμ 16 ֽڣֽ
+static size_t SkipAscii(const unsigned char * src, size_t size)
+{
+	size_t i = 0;
+	for (; i + 16 <= size; i += 16)
+	{
+		__m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+		if (_mm_movemask_epi8(bytes) != 0)
+			break;
+	}
+	return i;
+}
+
+// ͷ ASCII ַչΪַÿ 16 ֽڣشֽ
+static size_t WidenAscii(const unsigned char * src, size_t size, wchar_t * dst)
+{
+	const __m128i zero = _mm_setzero_si128();
+	size_t i = 0;
+	for (; i + 16 <= size; i += 16)
+	{
+		__m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+		if (_mm_movemask_epi8(bytes) != 0)
+			break;
+
+		__m128i lo = _mm_unpacklo_epi8(bytes, zero);
+		__m128i hi = _mm_unpackhi_epi8(bytes, zero);
+		__m128i * out = reinterpret_cast<__m128i *>(dst + i);
+		if (sizeof(wchar_t) == 2)
+		{
+			_mm_storeu_si128(out, lo);
+			_mm_storeu_si128(out + 1, hi);
+		}
+		else
+		{
+			_mm_storeu_si128(out, _mm_unpacklo_epi16(lo, zero));
+			_mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo, zero));
+			_mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hi, zero));
+			_mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hi, zero));
+		}
+	}
+	return i;
+}
+
+// ͷ ASCII ַѹΪֽڣÿ 16 ش wchar_t 
+static size_t NarrowAscii(const wchar_t * src, size_t size, unsigned char * dst)
+{
+	const __m128i zero = _mm_setzero_si128();
+	size_t i = 0;
+	for (; i + 16 <= size; i += 16)
+	{
+		const __m128i * in = reinterpret_cast<const __m128i *>(src + i);
+		__m128i bytes, any;
+		if (sizeof(wchar_t) == 2)
+		{
+			__m128i a = _mm_loadu_si128(in);
+			__m128i b = _mm_loadu_si128(in + 1);
+			any = _mm_and_si128(_mm_or_si128(a, b), _mm_set1_epi16(static_cast<short>(0xFF80)));
+			bytes = _mm_packus_epi16(a, b);
+		}
+		else
+		{
+			__m128i a = _mm_loadu_si128(in);
+			__m128i b = _mm_loadu_si128(in + 1);
+			__m128i c = _mm_loadu_si128(in + 2);
+			__m128i d = _mm_loadu_si128(in + 3);
+			any = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), _mm_set1_epi32(static_cast<int>(0xFFFFFF80)));
+			bytes = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+		}
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(any, zero)) != 0xFFFF)
+			break;
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), bytes);
+	}
+	return i;
+}
+
+#else
+
+static size_t SkipAscii(const unsigned char *, size_t)
+{
+	return 0;
+}
+
+static size_t WidenAscii(const unsigned char *, size_t, wchar_t *)
+{
+	return 0;
+}
+
+static size_t NarrowAscii(const wchar_t *, size_t, unsigned char *)
+{
+	return 0;
+}
+
+#endif
+
+
+size_t Utf8::decode(const char * src, size_t srcSize, wchar_t * dst)
+{
+	const unsigned char * p = reinterpret_cast<const unsigned char *>(src);
+	const unsigned char * end = p + srcSize;
+	wchar_t * out = dst;
+	bool valid = true;
+
+	while (p < end)
+	{
+		size_t ascii = WidenAscii(p, size_t(end - p), out);
+		p += ascii;
+		out += ascii;
+
+		// ʣಿֱַٴ ASCII ַ֮
+		while (p < end)
+		{
+			if (*p < 0x80)
+			{
+				*out++ = static_cast<wchar_t>(*p++);
+				continue;
+			}
+
+			unsigned int code;
+			p += DecodeOne(p, end, code, valid);
+			out += WriteWide(code, out);
+			break;
+		}
+	}
+	return size_t(out - dst);
+}
+
+size_t Utf8::encode(const wchar_t * src, size_t srcSize, char * dst)
+{
+	const wchar_t * p = src;
+	const wchar_t * end = src + srcSize;
+	unsigned char * out = reinterpret_cast<unsigned char *>(dst);
+
+	while (p < end)
+	{
+		size_t ascii = NarrowAscii(p, size_t(end - p), out);
+		p += ascii;
+		out += ascii;
+
+		while (p < end)
+		{
+			unsigned int code = static_cast<unsigned int>(*p);
+			if (sizeof(wchar_t) == 2)
+				code &= 0xFFFF;
+			if (code < 0x80)
+			{
+				*out++ = static_cast<unsigned char>(code);
+				p++;
+				continue;
+			}
+
+			p += ReadWide(p, end, code);
+			out += WriteUtf8(code, out);
+			break;
+		}
+	}
+	return size_t(out - reinterpret_cast<unsigned char *>(dst));
+}
+
+size_t Utf8::maxEncodedSize(size_t srcSize)
+{
+	// UTF-16  4 ֽڵַռ wchar_tÿ wchar_t  3 ֽ
+	return srcSize * (sizeof(wchar_t) == 2 ? 3 : 4);
+}
+
+bool Utf8::isValid(const char * src, size_t srcSize)
+{
+	const unsigned char * p = reinterpret_cast<const unsigned char *>(src);
+	const unsigned char * end = p + srcSize;
+	bool valid = true;
+
+	while (p < end && valid)
+	{
+		p += SkipAscii(p, size_t(end - p));
+		while (p < end && *p < 0x80)
+			p++;
+
+		if (p < end)
+		{
+			unsigned int code;
+			p += DecodeOne(p, end, code, valid);
+		}
+	}
+	return valid;
+}
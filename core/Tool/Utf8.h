@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+
+
+// UTF-8 ַ֮ת
+// wchar_t Ϊ 16 λʱַ UTF-16 Ϊ 32 λʱ UTF-32 
+//  ASCII ַ֧ SSE2 ʱÿδ 16 Ч滻Ϊ U+FFFD
+// ļ Windowsƽ̨ϱ
+class Utf8
+{
+public:
+	//  UTF-8 Ϊַд wchar_t 
+	// dst Ҫ srcSize  wchar_t Ŀռ
+	static size_t decode(
+		const char * src,
+		size_t srcSize,
+		wchar_t * dst
+	);
+
+	// ַΪ UTF-8дֽ
+	// dst Ҫ maxEncodedSize(srcSize) ֽڵĿռ
+	static size_t encode(
+		const wchar_t * src,
+		size_t srcSize,
+		char * dst
+	);
+
+	//  srcSize  wchar_t Ҫֽ
+	static size_t maxEncodedSize(
+		size_t srcSize
+	);
+
+	// жǷΪЧ UTF-8롢ͳ U+10FFFF ַ
+	static bool isValid(
+		const char * src,
+		size_t srcSize
+	);
+};
@@ -9,7 +9,6 @@ e2d::ETransition::ETransition(float duration)
 	, m_pPrevScene(nullptr)
 	, m_pNextScene(nullptr)
 {
-	SetInterval(m_nAnimationInterval, 15LL);
 }
 
 bool e2d::ETransition::isEnding()
@@ -30,7 +29,7 @@ bool e2d::ETransition::_isDelayEnough()
 	{
 		// ¼¼ʱ
 		m_tLast.QuadPart += m_nAnimationInterval.QuadPart;
-		m_fDuration += static_cast<float>(ToMilliseconds(m_nAnimationInterval.QuadPart));
+		m_fDuration += ToMillisecondsFloat(m_nAnimationInterval.QuadPart);
 		// 㶯
 		m_fRateOfProgress = m_fDuration / m_fTotalDuration;
 		return true;
@@ -47,6 +46,7 @@ void e2d::ETransition::_stop()
 void e2d::ETransition::_setTarget(EScene * prev, EScene * next)
 {
 	m_tLast = GetNow();
+	m_nAnimationInterval = GetAnimationStep();
 	m_pPrevScene = prev;
 	m_pNextScene = next;
 	_init();
@@ -9,7 +9,7 @@
 static HINSTANCE s_hInstance = nullptr;
 
 LRESULT WINAPI _MciPlayerProc(HWND hWnd, UINT Msg, WPARAM wParam, LPARAM lParam);
-static bool ExtractResource(LPCTSTR strDstFile, LPCTSTR strResType, LPCTSTR strResName);
+static bool WriteTempFile(LPCTSTR strDstFile, const void * pData, DWORD dwSize);
 
 
 MciPlayer::MciPlayer() 
@@ -98,14 +98,29 @@ bool MciPlayer::open(const e2d::EString & pResouceName, const e2d::EString & pRe
 	// Բڵļ
 	if (pResouceName.isEmpty() || pResouceType.isEmpty() || musicExtension.isEmpty()) return false;
 
+	// ԴļСԴڴ桢õԴС
+	HRSRC	hRes = ::FindResource(NULL, pResouceName, pResouceType);
+	HGLOBAL	hMem = hRes ? ::LoadResource(NULL, hRes) : NULL;
+	DWORD	dwSize = hRes ? ::SizeofResource(NULL, hRes) : 0;
+
+	if (!hMem || !dwSize)
+		return false;
+
+	return open(::LockResource(hMem), dwSize, musicExtension, uId);
+}
+
+bool MciPlayer::open(const void * pData, size_t nSize, const e2d::EString & musicExtension, UINT uId)
+{
+	if (!pData || !nSize || nSize > MAXDWORD || musicExtension.isEmpty()) return false;
+
 	// ȡʱļĿ¼
 	e2d::EString tempFileName = e2d::EFileUtils::getTempPath();
 
 	// ʱļļ
 	tempFileName = tempFileName + L"\\" + uId + L"." + musicExtension;
 
-	// ԴΪʱļ
-	if (ExtractResource(tempFileName, pResouceType, pResouceName))
+	// MCI ֻܴļֱдʱļ
+	if (WriteTempFile(tempFileName, pData, static_cast<DWORD>(nSize)))
 	{
 		return open(tempFileName, uId);
 	}
@@ -216,24 +231,19 @@ void MciPlayer::_sendCommand(int nCommand, DWORD_PTR param1, DWORD_PTR parma2)
 
 
 
-bool ExtractResource(LPCTSTR strDstFile, LPCTSTR strResType, LPCTSTR strResName)
+bool WriteTempFile(LPCTSTR strDstFile, const void * pData, DWORD dwSize)
 {
 	// ļ
 	HANDLE hFile = ::CreateFile(strDstFile, GENERIC_WRITE, NULL, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_TEMPORARY, NULL);
 	if (hFile == INVALID_HANDLE_VALUE)
 		return false;
 
-	// ԴļСԴڴ桢õԴС
-	HRSRC	hRes = ::FindResource(NULL, strResName, strResType);
-	HGLOBAL	hMem = ::LoadResource(NULL, hRes);
-	DWORD	dwSize = ::SizeofResource(NULL, hRes);
-
 	// дļ
 	DWORD dwWrite = 0;  	// дֽ
-	::WriteFile(hFile, hMem, dwSize, &dwWrite, NULL);
+	BOOL bResult = ::WriteFile(hFile, pData, dwSize, &dwWrite, NULL);
 	::CloseHandle(hFile);
 
-	return true;
+	return bResult && dwWrite == dwSize;
 }
 
 LRESULT WINAPI _MciPlayerProc(HWND hWnd, UINT Msg, WPARAM wParam, LPARAM lParam)
@@ -9,6 +9,7 @@ public:
 	void close();
 	bool open(const e2d::EString & pFileName, UINT uId);
 	bool open(const e2d::EString & pResouceName, const e2d::EString & pResouceType, const e2d::EString & musicExtension, UINT uId);
+	bool open(const void * pData, size_t nSize, const e2d::EString & musicExtension, UINT uId);
 	void play(int repeatTimes);
 	void pause();
 	void resume();
@@ -0,0 +1,107 @@
+#include "RenderFrame.h"
+#include "winbase.h"
+#include "..\enodes.h"
+
+// е֡δͼ߳ȡ
+static const LONG NEW_FRAME = 0x4;
+// 
+static const LONG FRAME_INDEX = 0x3;
+
+
+e2d::ERenderFrame::ERenderFrame()
+	: m_nClearColor(0)
+	, m_nDevice(0)
+	, m_nCount(0)
+{
+}
+
+e2d::ERenderFrame::~ERenderFrame()
+{
+	clear();
+}
+
+e2d::ERenderItem & e2d::ERenderFrame::add(ERenderItem::TYPE type, const D2D1::Matrix3x2F & transform)
+{
+	if (m_nCount == m_vItems.size())
+	{
+		m_vItems.push_back(ERenderItem());
+	}
+
+	ERenderItem & item = m_vItems[m_nCount++];
+	item.m_eType = type;
+	item.m_Transform = transform;
+	item.m_fOpacity = 1;
+	item.m_nColor = 0;
+	item.m_pNode = nullptr;
+	item.m_pBitmap = nullptr;
+	item.m_pTextFormat = nullptr;
+	item.m_pTextLayout = nullptr;
+	item.m_pGeometry = nullptr;
+	return item;
+}
+
+void e2d::ERenderFrame::clear()
+{
+	for (size_t i = 0; i < m_nCount; i++)
+	{
+		ERenderItem & item = m_vItems[i];
+		SafeRelease(&item.m_pNode);
+		SafeReleaseInterface(&item.m_pBitmap);
+		SafeReleaseInterface(&item.m_pTextFormat);
+		SafeReleaseInterface(&item.m_pTextLayout);
+		SafeReleaseInterface(&item.m_pGeometry);
+	}
+	m_nCount = 0;
+}
+
+size_t e2d::ERenderFrame::getCount() const
+{
+	return m_nCount;
+}
+
+const e2d::ERenderItem & e2d::ERenderFrame::getItem(size_t i) const
+{
+	return m_vItems[i];
+}
+
+
+e2d::ERenderFrameQueue::ERenderFrameQueue()
+	: m_nWrite(0)
+	, m_nReady(1)
+	, m_nRead(2)
+{
+}
+
+e2d::ERenderFrame * e2d::ERenderFrameQueue::getWriteFrame()
+{
+	return &m_Frames[m_nWrite];
+}
+
+bool e2d::ERenderFrameQueue::publish()
+{
+	// 뽻ۣȡصĻٱͼ̷߳
+	LONG nOld = InterlockedExchange(&m_nReady, m_nWrite | NEW_FRAME);
+	m_nWrite = nOld & FRAME_INDEX;
+	m_Frames[m_nWrite].clear();
+	return (nOld & NEW_FRAME) == 0;
+}
+
+e2d::ERenderFrame * e2d::ERenderFrameQueue::acquire()
+{
+	if ((m_nReady & NEW_FRAME) == 0)
+	{
+		return nullptr;
+	}
+	// ֻлͼ̻߳ǣԽһȡµ֡
+	m_nRead = InterlockedExchange(&m_nReady, m_nRead) & FRAME_INDEX;
+	return &m_Frames[m_nRead];
+}
+
+void e2d::ERenderFrameQueue::clear()
+{
+	for (int i = 0; i < 3; i++)
+	{
+		m_Frames[i].clear();
+	}
+	m_nReady &= FRAME_INDEX;
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include "..\ecommon.h"
+#include <string>
+#include <vector>
+
+
+// ̻߳ʱ̼߳¼ÿһ֡Ļݣͼֻ߳ȡ¼µ
+// ¼ĶԴãڻ̻߳ʱͷ
+
+namespace e2d
+{
+
+class ENode;
+
+// һλ
+struct ERenderItem
+{
+	enum TYPE
+	{
+		NODE,		/* ڻͼִ߳нڵ _render  */
+		BITMAP,		/* λͼ */
+		TEXT,		/*  */
+		TEXT_LAYOUT,	/* ԭŰ */
+		GEOMETRY	/* Ƽ״ */
+	};
+
+	TYPE				m_eType;
+	D2D1::Matrix3x2F	m_Transform;
+	float				m_fOpacity;
+	UINT32				m_nColor;
+	D2D1_RECT_F			m_Rect;			/*  */
+	D2D1_RECT_F			m_SrcRect;		/* λͼԴ */
+	ENode *				m_pNode;
+	ID2D1Bitmap *		m_pBitmap;
+	IDWriteTextFormat *	m_pTextFormat;
+	IDWriteTextLayout *	m_pTextLayout;
+	ID2D1Geometry *		m_pGeometry;
+	std::wstring		m_sText;
+};
+
+
+// һ֡Ļ
+class ERenderFrame
+{
+public:
+	ERenderFrame();
+
+	~ERenderFrame();
+
+	// һλƣصĶָΪ
+	ERenderItem & add(
+		ERenderItem::TYPE type,
+		const D2D1::Matrix3x2F & transform
+	);
+
+	// ͷãջ
+	void clear();
+
+	// ȡƴ
+	size_t getCount() const;
+
+	// ȡ i λ
+	const ERenderItem & getItem(
+		size_t i
+	) const;
+
+public:
+	UINT32	m_nClearColor;
+	LONG	m_nDevice;		/* ¼ʱȾĿţȾĿؽ֮ǰ֡ */
+
+private:
+	// ݵַֻȳԱڴ֮֡ظʹ
+	std::vector<ERenderItem> m_vItems;
+	size_t m_nCount;
+};
+
+
+// ֡
+// ̺߳ͻͼ̸߳һύ֡
+// ˫֡ı߽һԭӽȡκһصȴһ
+class ERenderFrameQueue
+{
+public:
+	ERenderFrameQueue();
+
+	// ȡ߳ڼ¼֡
+	ERenderFrame * getWriteFrame();
+
+	// ύ¼ɵ֡һͼ̲߳ʹõĻ
+	//  false ʾһύ֡δƾͱ滻
+	bool publish();
+
+	// ͼ̻߳ȡύ֡ûµ֡ʱؿ
+	ERenderFrame * acquire();
+
+	// лͼֹ߳ͣã
+	void clear();
+
+private:
+	ERenderFrame	m_Frames[3];
+	LONG			m_nWrite;
+	volatile LONG	m_nReady;
+	LONG			m_nRead;
+};
+
+}
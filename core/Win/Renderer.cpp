@@ -0,0 +1,162 @@
+#include "Renderer.h"
+#include "winbase.h"
+
+
+static e2d::ED2DRenderer s_D2DRenderer;
+static e2d::ESoftwareRenderer * s_pSoftwareRenderer = nullptr;
+
+
+void e2d::ED2DRenderer::beginDraw()
+{
+	GetRenderTarget()->BeginDraw();
+}
+
+HRESULT e2d::ED2DRenderer::endDraw()
+{
+	return GetRenderTarget()->EndDraw();
+}
+
+void e2d::ED2DRenderer::clear(UINT32 color)
+{
+	GetRenderTarget()->Clear(D2D1::ColorF(color));
+}
+
+void e2d::ED2DRenderer::setTransform(const D2D1::Matrix3x2F & matrix)
+{
+	GetRenderTarget()->SetTransform(matrix);
+}
+
+void e2d::ED2DRenderer::pushClip(const D2D1_RECT_F & rect)
+{
+	GetRenderTarget()->SetTransform(D2D1::Matrix3x2F::Identity());
+	GetRenderTarget()->PushAxisAlignedClip(rect, D2D1_ANTIALIAS_MODE_ALIASED);
+}
+
+void e2d::ED2DRenderer::popClip()
+{
+	GetRenderTarget()->PopAxisAlignedClip();
+}
+
+void e2d::ED2DRenderer::drawTexture(ETexture * texture, const D2D1_RECT_F & destRect, float opacity, const D2D1_RECT_F & srcRect)
+{
+	ID2D1Bitmap * pBitmap = texture ? texture->_getBitmap() : nullptr;
+	if (pBitmap)
+	{
+		GetRenderTarget()->DrawBitmap(
+			pBitmap,
+			destRect,
+			opacity,
+			D2D1_BITMAP_INTERPOLATION_MODE_LINEAR,
+			srcRect
+		);
+	}
+}
+
+void e2d::ED2DRenderer::drawTextureBatch(ETexture * texture, const D2D1_RECT_F * destRects, const D2D1_RECT_F * srcRects, UINT32 count, float opacity)
+{
+	ID2D1Bitmap * pBitmap = texture ? texture->_getBitmap() : nullptr;
+	if (pBitmap)
+	{
+		for (UINT32 i = 0; i < count; i++)
+		{
+			GetRenderTarget()->DrawBitmap(
+				pBitmap,
+				destRects[i],
+				opacity,
+				D2D1_BITMAP_INTERPOLATION_MODE_LINEAR,
+				srcRects[i]
+			);
+		}
+	}
+}
+
+void e2d::ED2DRenderer::drawText(const wchar_t * text, UINT32 length, IDWriteTextFormat * format, const D2D1_RECT_F & rect, UINT32 color, float opacity)
+{
+	GetSolidColorBrush()->SetColor(D2D1::ColorF(color, opacity));
+	GetRenderTarget()->DrawTextW(
+		text,
+		length,
+		format,
+		rect,
+		GetSolidColorBrush()
+	);
+}
+
+void e2d::ED2DRenderer::drawTextLayout(IDWriteTextLayout * layout, UINT32 color, float opacity)
+{
+	GetSolidColorBrush()->SetColor(D2D1::ColorF(color, opacity));
+	GetRenderTarget()->DrawTextLayout(
+		D2D1::Point2F(0, 0),
+		layout,
+		GetSolidColorBrush()
+	);
+}
+
+void e2d::ED2DRenderer::drawGeometry(ID2D1Geometry * geometry, UINT32 color, float opacity)
+{
+	GetSolidColorBrush()->SetColor(D2D1::ColorF(color, opacity));
+	GetRenderTarget()->DrawGeometry(geometry, GetSolidColorBrush());
+}
+
+void e2d::ED2DRenderer::fillRect(const D2D1_RECT_F & rect, UINT32 color, float opacity)
+{
+	GetSolidColorBrush()->SetColor(D2D1::ColorF(color, opacity));
+	GetRenderTarget()->FillRectangle(rect, GetSolidColorBrush());
+}
+
+void e2d::ED2DRenderer::drawRect(const D2D1_RECT_F & rect, UINT32 color, float opacity)
+{
+	GetSolidColorBrush()->SetColor(D2D1::ColorF(color, opacity));
+	GetRenderTarget()->DrawRectangle(rect, GetSolidColorBrush());
+}
+
+D2D1_SIZE_F e2d::ED2DRenderer::getSize()
+{
+	return GetRenderTarget()->GetSize();
+}
+
+void e2d::ED2DRenderer::resize(UINT32 width, UINT32 height)
+{
+	GetRenderTarget()->Resize(D2D1::SizeU(width, height));
+}
+
+
+e2d::ERenderer * GetRenderer()
+{
+	if (s_pSoftwareRenderer)
+	{
+		return s_pSoftwareRenderer;
+	}
+	return &s_D2DRenderer;
+}
+
+void SetSoftwareRenderer(bool bSoftware)
+{
+	if (bSoftware && !s_pSoftwareRenderer)
+	{
+		s_pSoftwareRenderer = new e2d::ESoftwareRenderer();
+	}
+	else if (!bSoftware && s_pSoftwareRenderer)
+	{
+		delete s_pSoftwareRenderer;
+		s_pSoftwareRenderer = nullptr;
+
+		// ڼ䴰ڴСѸı
+		if (GetHWnd())
+		{
+			RECT rc;
+			GetClientRect(GetHWnd(), &rc);
+			s_D2DRenderer.resize(rc.right - rc.left, rc.bottom - rc.top);
+		}
+	}
+}
+
+bool IsSoftwareRenderer()
+{
+	return s_pSoftwareRenderer != nullptr;
+}
+
+e2d::ESoftwareRenderer * GetSoftwareRenderer()
+{
+	return s_pSoftwareRenderer;
+}
@@ -0,0 +1,221 @@
+#pragma once
+#include "..\ecommon.h"
+#include "..\Tool\SoftRaster.h"
+#include <map>
+#include <string>
+
+
+// ڵ㡢״ EApp ͨͼӿڻƻ棬ֱӵ Direct2D
+// ED2DRenderer ƵڵȾĿ꣬ESoftwareRenderer ʹ CPU Ƶڴ
+
+namespace e2d
+{
+
+// ͼӿ
+class ERenderer
+{
+public:
+	virtual ~ERenderer() {}
+
+	// ʼһ֡
+	virtual void beginDraw() = 0;
+
+	// ƣ Direct2D Ĵ
+	virtual HRESULT endDraw() = 0;
+
+	// ʹɫջ棨ü
+	virtual void clear(
+		UINT32 color
+	) = 0;
+
+	// ֮ʹõı任
+	virtual void setTransform(
+		const D2D1::Matrix3x2F & matrix
+	) = 0;
+
+	// òü򣨲ܱ任Ӱ죩
+	virtual void pushClip(
+		const D2D1_RECT_F & rect
+	) = 0;
+
+	// ȡü
+	virtual void popClip() = 0;
+
+	//  srcRect 
+	virtual void drawTexture(
+		ETexture * texture,
+		const D2D1_RECT_F & destRect,
+		float opacity,
+		const D2D1_RECT_F & srcRect
+	) = 0;
+
+	// ͬһĶdestRects  srcRects  count 
+	virtual void drawTextureBatch(
+		ETexture * texture,
+		const D2D1_RECT_F * destRects,
+		const D2D1_RECT_F * srcRects,
+		UINT32 count,
+		float opacity
+	) = 0;
+
+	// 
+	virtual void drawText(
+		const wchar_t * text,
+		UINT32 length,
+		IDWriteTextFormat * format,
+		const D2D1_RECT_F & rect,
+		UINT32 color,
+		float opacity
+	) = 0;
+
+	// ԭŰ
+	virtual void drawTextLayout(
+		IDWriteTextLayout * layout,
+		UINT32 color,
+		float opacity
+	) = 0;
+
+	// Ƽ״
+	virtual void drawGeometry(
+		ID2D1Geometry * geometry,
+		UINT32 color,
+		float opacity
+	) = 0;
+
+	// 
+	virtual void fillRect(
+		const D2D1_RECT_F & rect,
+		UINT32 color,
+		float opacity
+	) = 0;
+
+	// ƾεı߿
+	virtual void drawRect(
+		const D2D1_RECT_F & rect,
+		UINT32 color,
+		float opacity
+	) = 0;
+
+	// ȡС
+	virtual D2D1_SIZE_F getSize() = 0;
+
+	// ޸ĻСأ
+	virtual void resize(
+		UINT32 width,
+		UINT32 height
+	) = 0;
+};
+
+
+// ʹ Direct2D Ƶ
+class ED2DRenderer :
+	public ERenderer
+{
+public:
+	virtual void beginDraw() override;
+	virtual HRESULT endDraw() override;
+	virtual void clear(UINT32 color) override;
+	virtual void setTransform(const D2D1::Matrix3x2F & matrix) override;
+	virtual void pushClip(const D2D1_RECT_F & rect) override;
+	virtual void popClip() override;
+	virtual void drawTexture(ETexture * texture, const D2D1_RECT_F & destRect, float opacity, const D2D1_RECT_F & srcRect) override;
+	virtual void drawTextureBatch(ETexture * texture, const D2D1_RECT_F * destRects, const D2D1_RECT_F * srcRects, UINT32 count, float opacity) override;
+	virtual void drawText(const wchar_t * text, UINT32 length, IDWriteTextFormat * format, const D2D1_RECT_F & rect, UINT32 color, float opacity) override;
+	virtual void drawTextLayout(IDWriteTextLayout * layout, UINT32 color, float opacity) override;
+	virtual void drawGeometry(ID2D1Geometry * geometry, UINT32 color, float opacity) override;
+	virtual void fillRect(const D2D1_RECT_F & rect, UINT32 color, float opacity) override;
+	virtual void drawRect(const D2D1_RECT_F & rect, UINT32 color, float opacity) override;
+	virtual D2D1_SIZE_F getSize() override;
+	virtual void resize(UINT32 width, UINT32 height) override;
+};
+
+
+// ʹ CPU Ƶڴе BGRA ͼԤ alpha
+// дʱÿ֡󽫻渴Ƶ
+class ESoftwareRenderer :
+	public ERenderer
+{
+public:
+	ESoftwareRenderer();
+
+	virtual ~ESoftwareRenderer();
+
+	virtual void beginDraw() override;
+	virtual HRESULT endDraw() override;
+	virtual void clear(UINT32 color) override;
+	virtual void setTransform(const D2D1::Matrix3x2F & matrix) override;
+	virtual void pushClip(const D2D1_RECT_F & rect) override;
+	virtual void popClip() override;
+	virtual void drawTexture(ETexture * texture, const D2D1_RECT_F & destRect, float opacity, const D2D1_RECT_F & srcRect) override;
+	virtual void drawTextureBatch(ETexture * texture, const D2D1_RECT_F * destRects, const D2D1_RECT_F * srcRects, UINT32 count, float opacity) override;
+	virtual void drawText(const wchar_t * text, UINT32 length, IDWriteTextFormat * format, const D2D1_RECT_F & rect, UINT32 color, float opacity) override;
+	virtual void drawTextLayout(IDWriteTextLayout * layout, UINT32 color, float opacity) override;
+	virtual void drawGeometry(ID2D1Geometry * geometry, UINT32 color, float opacity) override;
+	virtual void fillRect(const D2D1_RECT_F & rect, UINT32 color, float opacity) override;
+	virtual void drawRect(const D2D1_RECT_F & rect, UINT32 color, float opacity) override;
+	virtual D2D1_SIZE_F getSize() override;
+	virtual void resize(UINT32 width, UINT32 height) override;
+
+	// ȡ
+	const SoftRaster & getRaster() const;
+
+	// ͷŻͼ
+	void clearTextCache();
+
+private:
+	// ־ DirectWrite դͼ
+	struct TextImage
+	{
+		std::vector<unsigned int>	pixels;
+		int							width;
+		int							height;
+		UINT32						frame;		/* һλƵ֡ */
+		IDWriteTextLayout *			layout;		/* ŰãʱΪ */
+	};
+
+	// һͼ
+	TextImage * _findTextImage(
+		const std::wstring & key
+	);
+
+	// դֲ棬layout Ϊʱʹ text  format Ű
+	TextImage * _createTextImage(
+		const std::wstring & key,
+		IDWriteTextLayout * layout,
+		const wchar_t * text,
+		UINT32 length,
+		IDWriteTextFormat * format,
+		int width,
+		int height,
+		UINT32 color
+	);
+
+	// ͼ
+	void _drawTextImage(
+		const TextImage * pText,
+		float x,
+		float y,
+		float opacity
+	);
+
+private:
+	SoftRaster	m_Raster;
+	bool		m_bClipped;
+	UINT32		m_nFrame;
+	std::map<std::wstring, TextImage>	m_mTextCache;
+};
+
+}
+
+
+// ȡǰʹõĻͼӿ
+e2d::ERenderer * GetRenderer();
+
+// лƻ Direct2D 
+void SetSoftwareRenderer(bool bSoftware);
+
+// Ƿʹ
+bool IsSoftwareRenderer();
+
+// ȡͼӿڣδʹʱΪ
+e2d::ESoftwareRenderer * GetSoftwareRenderer();
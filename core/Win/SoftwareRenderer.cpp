@@ -0,0 +1,462 @@
+#include "Renderer.h"
+#include "winbase.h"
+#include <cmath>
+
+// ͼ߳
+static const int MAX_TEXT_SIZE = 4096;
+// ͼ񳬹ô֡δʱͷ
+static const UINT32 TEXT_CACHE_FRAMES = 60;
+
+
+// ״Ϊ߶
+class GeometryLineSink :
+	public ID2D1SimplifiedGeometrySink
+{
+public:
+	GeometryLineSink(SoftRaster * raster, unsigned int color)
+		: m_pRaster(raster)
+		, m_nColor(color)
+	{
+		m_Start = m_Last = D2D1::Point2F();
+	}
+
+	STDMETHOD_(ULONG, AddRef)()
+	{
+		return 1;
+	}
+
+	STDMETHOD_(ULONG, Release)()
+	{
+		return 1;
+	}
+
+	STDMETHOD(QueryInterface)(REFIID riid, void ** ppvObject)
+	{
+		if (riid == __uuidof(ID2D1SimplifiedGeometrySink) || riid == __uuidof(IUnknown))
+		{
+			*ppvObject = this;
+			return S_OK;
+		}
+		*ppvObject = nullptr;
+		return E_NOINTERFACE;
+	}
+
+	STDMETHOD_(void, SetFillMode)(D2D1_FILL_MODE fillMode)
+	{
+	}
+
+	STDMETHOD_(void, SetSegmentFlags)(D2D1_PATH_SEGMENT vertexFlags)
+	{
+	}
+
+	STDMETHOD_(void, BeginFigure)(D2D1_POINT_2F startPoint, D2D1_FIGURE_BEGIN figureBegin)
+	{
+		m_Start = m_Last = startPoint;
+	}
+
+	STDMETHOD_(void, AddLines)(const D2D1_POINT_2F * points, UINT32 pointsCount)
+	{
+		for (UINT32 i = 0; i < pointsCount; i++)
+		{
+			_lineTo(points[i]);
+		}
+	}
+
+	STDMETHOD_(void, AddBeziers)(const D2D1_BEZIER_SEGMENT * beziers, UINT32 beziersCount)
+	{
+		// ʱѽչΪ߶ΣֻӶ˵
+		for (UINT32 i = 0; i < beziersCount; i++)
+		{
+			_lineTo(beziers[i].point3);
+		}
+	}
+
+	STDMETHOD_(void, EndFigure)(D2D1_FIGURE_END figureEnd)
+	{
+		if (figureEnd == D2D1_FIGURE_END_CLOSED)
+		{
+			_lineTo(m_Start);
+		}
+	}
+
+	STDMETHOD(Close)()
+	{
+		return S_OK;
+	}
+
+private:
+	void _lineTo(const D2D1_POINT_2F & point)
+	{
+		m_pRaster->drawLine(m_Last.x, m_Last.y, point.x, point.y, m_nColor);
+		m_Last = point;
+	}
+
+private:
+	SoftRaster *	m_pRaster;
+	unsigned int	m_nColor;
+	D2D1_POINT_2F	m_Start;
+	D2D1_POINT_2F	m_Last;
+};
+
+
+// ȡ뻭ı
+static float GetDpiScale()
+{
+	if (!GetHWnd())
+		return 1;
+
+	FLOAT dpiX, dpiY;
+	GetFactory()->GetDesktopDpi(&dpiX, &dpiY);
+	return dpiX / 96.f;
+}
+
+
+e2d::ESoftwareRenderer::ESoftwareRenderer()
+	: m_bClipped(false)
+	, m_nFrame(0)
+{
+	if (GetHWnd())
+	{
+		RECT rc;
+		GetClientRect(GetHWnd(), &rc);
+		resize(rc.right - rc.left, rc.bottom - rc.top);
+	}
+}
+
+e2d::ESoftwareRenderer::~ESoftwareRenderer()
+{
+	clearTextCache();
+}
+
+void e2d::ESoftwareRenderer::beginDraw()
+{
+	m_nFrame++;
+	m_bClipped = false;
+	m_Raster.resetClip();
+	setTransform(D2D1::Matrix3x2F::Identity());
+}
+
+HRESULT e2d::ESoftwareRenderer::endDraw()
+{
+	// ͷŽϳʱδƵͼ
+	for (auto iter = m_mTextCache.begin(); iter != m_mTextCache.end();)
+	{
+		if (m_nFrame - iter->second.frame > TEXT_CACHE_FRAMES)
+		{
+			SafeReleaseInterface(&iter->second.layout);
+			m_mTextCache.erase(iter++);
+		}
+		else
+			iter++;
+	}
+
+	// 渴Ƶ
+	HWND hWnd = GetHWnd();
+	if (hWnd && m_Raster.getPixels())
+	{
+		RECT rc;
+		GetClientRect(hWnd, &rc);
+
+		BITMAPINFO bmi = { 0 };
+		bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+		bmi.bmiHeader.biWidth = m_Raster.getWidth();
+		bmi.bmiHeader.biHeight = -m_Raster.getHeight();
+		bmi.bmiHeader.biPlanes = 1;
+		bmi.bmiHeader.biBitCount = 32;
+		bmi.bmiHeader.biCompression = BI_RGB;
+
+		HDC hdc = GetDC(hWnd);
+		StretchDIBits(
+			hdc,
+			0, 0, rc.right - rc.left, rc.bottom - rc.top,
+			0, 0, m_Raster.getWidth(), m_Raster.getHeight(),
+			m_Raster.getPixels(),
+			&bmi,
+			DIB_RGB_COLORS,
+			SRCCOPY
+		);
+		ReleaseDC(hWnd, hdc);
+	}
+	return S_OK;
+}
+
+void e2d::ESoftwareRenderer::clear(UINT32 color)
+{
+	m_Raster.clear(0xFF000000 | (color & 0xFFFFFF));
+}
+
+void e2d::ESoftwareRenderer::setTransform(const D2D1::Matrix3x2F & matrix)
+{
+	const float m[6] = { matrix._11, matrix._12, matrix._21, matrix._22, matrix._31, matrix._32 };
+	m_Raster.setTransform(m);
+}
+
+void e2d::ESoftwareRenderer::pushClip(const D2D1_RECT_F & rect)
+{
+	//  Direct2D ķǿݲüֻͬڵ
+	m_Raster.setClip(
+		static_cast<int>(floor(rect.left + 0.5f)),
+		static_cast<int>(floor(rect.top + 0.5f)),
+		static_cast<int>(floor(rect.right + 0.5f)),
+		static_cast<int>(floor(rect.bottom + 0.5f))
+	);
+	m_bClipped = true;
+}
+
+void e2d::ESoftwareRenderer::popClip()
+{
+	m_Raster.resetClip();
+	m_bClipped = false;
+}
+
+void e2d::ESoftwareRenderer::drawTexture(ETexture * texture, const D2D1_RECT_F & destRect, float opacity, const D2D1_RECT_F & srcRect)
+{
+	const UINT32 * pPixels = nullptr;
+	UINT32 width, height;
+	if (!texture || !texture->_getPixels(&pPixels, width, height))
+		return;
+
+	SoftRaster::Image image = { pPixels, int(width), int(height), int(width) };
+	const float dest[4] = { destRect.left, destRect.top, destRect.right, destRect.bottom };
+	const float src[4] = { srcRect.left, srcRect.top, srcRect.right, srcRect.bottom };
+	m_Raster.drawImage(image, dest, src, opacity);
+}
+
+void e2d::ESoftwareRenderer::drawTextureBatch(ETexture * texture, const D2D1_RECT_F * destRects, const D2D1_RECT_F * srcRects, UINT32 count, float opacity)
+{
+	const UINT32 * pPixels = nullptr;
+	UINT32 width, height;
+	if (!texture || !texture->_getPixels(&pPixels, width, height))
+		return;
+
+	SoftRaster::Image image = { pPixels, int(width), int(height), int(width) };
+	for (UINT32 i = 0; i < count; i++)
+	{
+		const float dest[4] = { destRects[i].left, destRects[i].top, destRects[i].right, destRects[i].bottom };
+		const float src[4] = { srcRects[i].left, srcRects[i].top, srcRects[i].right, srcRects[i].bottom };
+		m_Raster.drawImage(image, dest, src, opacity);
+	}
+}
+
+void e2d::ESoftwareRenderer::drawText(const wchar_t * text, UINT32 length, IDWriteTextFormat * format, const D2D1_RECT_F & rect, UINT32 color, float opacity)
+{
+	int width = static_cast<int>(ceil(rect.right - rect.left));
+	int height = static_cast<int>(ceil(rect.bottom - rect.top));
+	if (!text || length == 0 || !format || width <= 0 || height <= 0)
+		return;
+
+	// ݡʽСɫͬʱʹͬһͼ
+	std::wstring key(text, length);
+	key += L'\0';
+	key += std::to_wstring(static_cast<unsigned long long>(reinterpret_cast<size_t>(format)));
+	key += L',';
+	key += std::to_wstring(static_cast<unsigned long long>(width));
+	key += L',';
+	key += std::to_wstring(static_cast<unsigned long long>(height));
+	key += L',';
+	key += std::to_wstring(static_cast<unsigned long long>(color));
+
+	const TextImage * pText = _findTextImage(key);
+	if (!pText)
+	{
+		pText = _createTextImage(key, nullptr, text, length, format, width, height, color);
+	}
+	_drawTextImage(pText, rect.left, rect.top, opacity);
+}
+
+void e2d::ESoftwareRenderer::drawTextLayout(IDWriteTextLayout * layout, UINT32 color, float opacity)
+{
+	if (!layout)
+		return;
+
+	// ŰãŰĵַᱻ
+	std::wstring key = L"layout:";
+	key += std::to_wstring(static_cast<unsigned long long>(reinterpret_cast<size_t>(layout)));
+	key += L',';
+	key += std::to_wstring(static_cast<unsigned long long>(color));
+
+	const TextImage * pText = _findTextImage(key);
+	if (!pText)
+	{
+		DWRITE_TEXT_METRICS metrics;
+		if (FAILED(layout->GetMetrics(&metrics)))
+			return;
+
+		int width = static_cast<int>(ceil(max(metrics.left, 0.f) + max(metrics.widthIncludingTrailingWhitespace, metrics.layoutWidth)));
+		int height = static_cast<int>(ceil(max(metrics.top, 0.f) + metrics.height));
+		if (width <= 0 || height <= 0)
+			return;
+
+		pText = _createTextImage(key, layout, nullptr, 0, nullptr, width, height, color);
+	}
+	_drawTextImage(pText, 0, 0, opacity);
+}
+
+void e2d::ESoftwareRenderer::drawGeometry(ID2D1Geometry * geometry, UINT32 color, float opacity)
+{
+	if (!geometry)
+		return;
+
+	// չΪ߶κλ
+	GeometryLineSink sink(&m_Raster, SoftRaster::premultiply(color, opacity));
+	geometry->Simplify(D2D1_GEOMETRY_SIMPLIFICATION_OPTION_LINES, NULL, &sink);
+}
+
+void e2d::ESoftwareRenderer::fillRect(const D2D1_RECT_F & rect, UINT32 color, float opacity)
+{
+	m_Raster.fillRect(rect.left, rect.top, rect.right, rect.bottom, SoftRaster::premultiply(color, opacity));
+}
+
+void e2d::ESoftwareRenderer::drawRect(const D2D1_RECT_F & rect, UINT32 color, float opacity)
+{
+	unsigned int pixel = SoftRaster::premultiply(color, opacity);
+	m_Raster.drawLine(rect.left, rect.top, rect.right, rect.top, pixel);
+	m_Raster.drawLine(rect.right, rect.top, rect.right, rect.bottom, pixel);
+	m_Raster.drawLine(rect.right, rect.bottom, rect.left, rect.bottom, pixel);
+	m_Raster.drawLine(rect.left, rect.bottom, rect.left, rect.top, pixel);
+}
+
+D2D1_SIZE_F e2d::ESoftwareRenderer::getSize()
+{
+	return D2D1::SizeF(float(m_Raster.getWidth()), float(m_Raster.getHeight()));
+}
+
+void e2d::ESoftwareRenderer::resize(UINT32 width, UINT32 height)
+{
+	//  Direct2D ͬ 1/96 ӢΪλ
+	float scale = GetDpiScale();
+	m_Raster.resize(
+		static_cast<int>(ceil(width / scale)),
+		static_cast<int>(ceil(height / scale))
+	);
+}
+
+const SoftRaster & e2d::ESoftwareRenderer::getRaster() const
+{
+	return m_Raster;
+}
+
+void e2d::ESoftwareRenderer::clearTextCache()
+{
+	for (auto iter = m_mTextCache.begin(); iter != m_mTextCache.end(); iter++)
+	{
+		SafeReleaseInterface(&iter->second.layout);
+	}
+	m_mTextCache.clear();
+}
+
+e2d::ESoftwareRenderer::TextImage * e2d::ESoftwareRenderer::_findTextImage(const std::wstring & key)
+{
+	auto iter = m_mTextCache.find(key);
+	if (iter == m_mTextCache.end())
+		return nullptr;
+
+	iter->second.frame = m_nFrame;
+	return &iter->second;
+}
+
+e2d::ESoftwareRenderer::TextImage * e2d::ESoftwareRenderer::_createTextImage(
+	const std::wstring & key,
+	IDWriteTextLayout * layout,
+	const wchar_t * text,
+	UINT32 length,
+	IDWriteTextFormat * format,
+	int width,
+	int height,
+	UINT32 color
+)
+{
+	width = min(width, MAX_TEXT_SIZE);
+	height = min(height, MAX_TEXT_SIZE);
+
+	// ʹ Direct2D ȾĿ꽫ֻƵ WIC λͼ
+	IWICBitmap * pWicBitmap = nullptr;
+	ID2D1RenderTarget * pTarget = nullptr;
+	ID2D1SolidColorBrush * pBrush = nullptr;
+	std::vector<unsigned int> pixels;
+
+	HRESULT hr = GetImagingFactory()->CreateBitmap(
+		width,
+		height,
+		GUID_WICPixelFormat32bppPBGRA,
+		WICBitmapCacheOnLoad,
+		&pWicBitmap
+	);
+
+	if (SUCCEEDED(hr))
+	{
+		hr = GetFactory()->CreateWicBitmapRenderTarget(
+			pWicBitmap,
+			D2D1::RenderTargetProperties(
+				D2D1_RENDER_TARGET_TYPE_SOFTWARE,
+				D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED),
+				96.f,
+				96.f
+			),
+			&pTarget
+		);
+	}
+
+	if (SUCCEEDED(hr))
+	{
+		hr = pTarget->CreateSolidColorBrush(D2D1::ColorF(color), &pBrush);
+	}
+
+	if (SUCCEEDED(hr))
+	{
+		// ͸ϲʹ ClearType
+		pTarget->SetTextAntialiasMode(D2D1_TEXT_ANTIALIAS_MODE_GRAYSCALE);
+		pTarget->BeginDraw();
+		pTarget->Clear(D2D1::ColorF(0, 0));
+		if (layout)
+		{
+			pTarget->DrawTextLayout(D2D1::Point2F(0, 0), layout, pBrush);
+		}
+		else
+		{
+			pTarget->DrawTextW(text, length, format, D2D1::RectF(0, 0, float(width), float(height)), pBrush);
+		}
+		hr = pTarget->EndDraw();
+	}
+
+	if (SUCCEEDED(hr))
+	{
+		pixels.resize(size_t(width) * height);
+		hr = pWicBitmap->CopyPixels(
+			NULL,
+			width * 4,
+			width * height * 4,
+			reinterpret_cast<BYTE*>(&pixels[0])
+		);
+	}
+
+	SafeReleaseInterface(&pBrush);
+	SafeReleaseInterface(&pTarget);
+	SafeReleaseInterface(&pWicBitmap);
+
+	if (FAILED(hr))
+		return nullptr;
+
+	TextImage & cached = m_mTextCache[key];
+	cached.pixels.swap(pixels);
+	cached.width = width;
+	cached.height = height;
+	cached.frame = m_nFrame;
+	cached.layout = layout;
+	if (layout)
+	{
+		layout->AddRef();
+	}
+	return &cached;
+}
+
+void e2d::ESoftwareRenderer::_drawTextImage(const TextImage * pText, float x, float y, float opacity)
+{
+	if (!pText)
+		return;
+
+	SoftRaster::Image image = { &pText->pixels[0], pText->width, pText->height, pText->width };
+	const float dest[4] = { x, y, x + pText->width, y + pText->height };
+	const float src[4] = { 0, 0, float(pText->width), float(pText->height) };
+	m_Raster.drawImage(image, dest, src, opacity);
+}
@@ -0,0 +1,74 @@
+#include "WinFrameClock.h"
+#include "winbase.h"
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+
+WinFrameClock::WinFrameClock()
+	: m_hTimer(NULL)
+	, m_bTimerFailed(false)
+{
+}
+
+WinFrameClock::~WinFrameClock()
+{
+	if (m_hTimer)
+	{
+		::CloseHandle(m_hTimer);
+	}
+}
+
+long long WinFrameClock::now()
+{
+	LARGE_INTEGER tNow;
+	::QueryPerformanceCounter(&tNow);
+	return tNow.QuadPart;
+}
+
+long long WinFrameClock::frequency()
+{
+	return GetFreq().QuadPart;
+}
+
+void WinFrameClock::sleep(long long ticks)
+{
+	// Sleep ľ timeBeginPeriod õϵͳʱӾ
+	::Sleep(static_cast<DWORD>(ToMilliseconds(ticks)));
+}
+
+bool WinFrameClock::waitTimer(long long ticks)
+{
+	if (!m_hTimer && !m_bTimerFailed)
+	{
+		// ߾ȶʱҪ Windows 10 1803 ϵϵͳ
+		m_hTimer = ::CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+		m_bTimerFailed = (m_hTimer == NULL);
+	}
+
+	if (!m_hTimer)
+	{
+		return false;
+	}
+
+	// ȴʱ 100 Ϊλʾʱ
+	LARGE_INTEGER dueTime;
+	dueTime.QuadPart = -static_cast<LONGLONG>(ticks * 10000000.0 / GetFreq().QuadPart);
+	if (dueTime.QuadPart == 0)
+	{
+		return true;
+	}
+
+	if (!::SetWaitableTimer(m_hTimer, &dueTime, 0, NULL, NULL, FALSE))
+	{
+		return false;
+	}
+	::WaitForSingleObject(m_hTimer, INFINITE);
+	return true;
+}
+
+void WinFrameClock::spin()
+{
+	YieldProcessor();
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "..\emacros.h"
+#include "..\Tool\FramePacer.h"
+
+
+// ʹ QueryPerformanceCounter ʱ֡ʿʱ
+class WinFrameClock :
+	public FrameClock
+{
+public:
+	WinFrameClock();
+
+	virtual ~WinFrameClock();
+
+	virtual long long now();
+
+	virtual long long frequency();
+
+	virtual void sleep(
+		long long ticks
+	);
+
+	virtual bool waitTimer(
+		long long ticks
+	);
+
+	virtual void spin();
+
+private:
+	HANDLE	m_hTimer;
+	bool	m_bTimerFailed;
+};
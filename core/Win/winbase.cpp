@@ -9,6 +9,8 @@ static IWICImagingFactory * s_pIWICFactory = nullptr;
 static IDWriteFactory * s_pDWriteFactory = nullptr;
 static LARGE_INTEGER s_tNow;
 static LARGE_INTEGER s_tFreq;
+static LARGE_INTEGER s_tAnimationStep;
+static bool s_bMultiThreaded = false;
 
 
 HWND &GetHWnd()
@@ -24,13 +26,32 @@ ID2D1Factory * &GetFactory()
 		HRESULT hr = S_OK;
 
 		// һ Direct2D 
-		hr = D2D1CreateFactory(D2D1_FACTORY_TYPE_SINGLE_THREADED, &s_pDirect2dFactory);
+		hr = D2D1CreateFactory(
+			s_bMultiThreaded ? D2D1_FACTORY_TYPE_MULTI_THREADED : D2D1_FACTORY_TYPE_SINGLE_THREADED,
+			&s_pDirect2dFactory
+		);
 
 		ASSERT(SUCCEEDED(hr), "Create Device Independent Resources Failed!");
 	}
 	return s_pDirect2dFactory;
 }
 
+bool SetFactoryMultiThreaded(bool bMultiThreaded)
+{
+	// ޸
+	if (s_pDirect2dFactory)
+	{
+		return s_bMultiThreaded == bMultiThreaded;
+	}
+	s_bMultiThreaded = bMultiThreaded;
+	return true;
+}
+
+bool IsFactoryMultiThreaded()
+{
+	return s_bMultiThreaded;
+}
+
 ID2D1HwndRenderTarget * &GetRenderTarget()
 {
 	if (!s_pRenderTarget)
@@ -51,7 +72,8 @@ ID2D1HwndRenderTarget * &GetRenderTarget()
 			D2D1::RenderTargetProperties(),
 			D2D1::HwndRenderTargetProperties(
 				GetHWnd(), 
-				size),
+				size,
+				D2D1_PRESENT_OPTIONS_RETAIN_CONTENTS),
 			&s_pRenderTarget
 		);
 		
@@ -125,11 +147,31 @@ bool IsIntervalFull(const LARGE_INTEGER& tLast, const LARGE_INTEGER& tInterval)
 	return (s_tNow.QuadPart - tLast.QuadPart) >= tInterval.QuadPart;
 }
 
+bool IsIntervalFull(LONGLONG nNow, const LARGE_INTEGER& tLast, const LARGE_INTEGER& tInterval)
+{
+	return (nNow - tLast.QuadPart) >= tInterval.QuadPart;
+}
+
 LONGLONG ToMilliseconds(LONGLONG tLast)
 {
 	return tLast * 1000LL / GetFreq().QuadPart;
 }
 
+float ToMillisecondsFloat(LONGLONG nTicks)
+{
+	return static_cast<float>(nTicks * 1000.0 / GetFreq().QuadPart);
+}
+
+LARGE_INTEGER &GetAnimationStep()
+{
+	if (s_tAnimationStep.QuadPart == 0)
+	{
+		// ͳлĬÿ 15 ƽһ
+		SetInterval(s_tAnimationStep, 15LL);
+	}
+	return s_tAnimationStep;
+}
+
 void SetInterval(LARGE_INTEGER& nInterval, LONGLONG nIntervalMS)
 {
 	nInterval.QuadPart = static_cast<LONGLONG>(GetFreq().QuadPart * nIntervalMS / 1000.0);
@@ -12,6 +12,10 @@ HWND &GetHWnd();
 
 ID2D1Factory * &GetFactory();
 
+bool SetFactoryMultiThreaded(bool bMultiThreaded);
+
+bool IsFactoryMultiThreaded();
+
 ID2D1HwndRenderTarget * &GetRenderTarget();
 
 ID2D1SolidColorBrush * &GetSolidColorBrush();
@@ -26,8 +30,15 @@ LARGE_INTEGER &GetNow();
 
 bool IsIntervalFull(const LARGE_INTEGER& tLast, const LARGE_INTEGER& tInterval);
 
+// жϴ tLast  nNow ʱǷﵽ tInterval
+bool IsIntervalFull(LONGLONG nNow, const LARGE_INTEGER& tLast, const LARGE_INTEGER& tInterval);
+
 LONGLONG ToMilliseconds(LONGLONG tLast);
 
+float ToMillisecondsFloat(LONGLONG nTicks);
+
+LARGE_INTEGER &GetAnimationStep();
+
 void SetInterval(LARGE_INTEGER& nInterval, LONGLONG nIntervalMS);
 
 
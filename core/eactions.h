@@ -75,6 +75,9 @@ protected:
 	// öʱ
 	virtual void _resetTime();
 
+	// ȡĿڵıʱ䣬ûĿʱΪȫʱ
+	LONGLONG _getNow();
+
 protected:
 	bool		m_bRunning;
 	bool		m_bEnding;
@@ -1,6 +1,7 @@
 #pragma once
 #include "emacros.h"
 #include "ecommon.h"
+#include "Tool\GameClock.h"
 
 
 // Base Classes
@@ -15,9 +16,25 @@ class EListenerMouse;
 class EListenerKeyboard;
 class EAction;
 class ETransition;
+class ERenderFrame;
 
 class EApp
 {
+public:
+	// ȴһ֡ķʽ
+	enum FRAME_WAIT
+	{
+		SLEEP_SPIN,		/* ̣߳Լ 2 æȴ */
+		WAITABLE_TIMER	/* ʹø߾ȶʱԼ 0.5 æȴ */
+	};
+
+	// ƻķʽ
+	enum RENDER_MODE
+	{
+		RENDER_DIRECT2D,	/* ʹ Direct2D Ƶ */
+		RENDER_SOFTWARE		/* ʹ CPU Ƶڴ棬дʱƵ */
+	};
+
 public:
 	// ȡʵ
 	static EApp * getInstance();
@@ -33,6 +50,23 @@ public:
 	// 
 	static int run();
 
+	// ʼ޴еĻʹƣСΪ width x height
+	//  init ֮ͨ runHeadless Ϸ
+	static void initHeadless(
+		UINT32 width,
+		UINT32 height
+	);
+
+	// ڡȴʱӾִ frames ֡Ϸ߼ʱл
+	// ÿ֡ʱǰ dt 룬Ϊ 0 ʱʹ߼²֡
+	// render Ϊ true ʹʱÿ֡ƵڴУ getFramePixels ȡ
+	//  quit ʱǰ
+	static EHeadlessStats runHeadless(
+		UINT32 frames,
+		float dt = 0,
+		bool render = false
+	);
+
 	// ͣϷ
 	static void pause();
 
@@ -129,6 +163,139 @@ public:
 		UINT32 fps
 	);
 
+	// Ƿֻػ滭з仯
+	// 󣬽ڵλá͸ȡݻʾ״̬ıʱػ
+	static void setDirtyRectEnable(
+		bool enable
+	);
+
+	// Ƿֻػ滭з仯
+	static bool isDirtyRectEnable();
+
+	// ʾÿ֡ػ򣨵ã
+	static void setDirtyRectVisiable(
+		bool visiable
+	);
+
+	// Ƿ
+	// ûжʱҪʱȴ治ʱл
+	static void setRenderOnDemand(
+		bool enable
+	);
+
+	// Ƿ
+	static bool isRenderOnDemand();
+
+	// ȡȴܺ
+	static LONGLONG getIdleDuration();
+
+	// ȡƻܺ
+	static LONGLONG getRenderDuration();
+
+	// ȡѻƵĻ֡
+	static UINT32 getRenderedFrames();
+
+	// ȡƵ֡ûб仯ͼ߳ƣ
+	static UINT32 getSkippedFrames();
+
+	// ǷʹöĻͼ̣߳ʱ init ǰ
+	// ̸߳Ϸ¼ÿ֡Ļݣͼ߳ͬʱһ֡
+	// ֡ʱӽºͻнϳһ֮
+	// Զڵ _render ڻͼִ߳УִʱӦ޸Ľڵ
+	static void setRenderThreadEnable(
+		bool enable
+	);
+
+	// ǷʹöĻͼ߳
+	static bool isRenderThreadEnable();
+
+	// ûƻķʽĬΪ RENDER_DIRECT2D
+	// ƲʹԿɶȡرȶԣʺûԿĻв
+	// ʱʹûͼ̣߳ʹ
+	static void setRenderMode(
+		RENDER_MODE mode
+	);
+
+	// ȡƻķʽ
+	static RENDER_MODE getRenderMode();
+
+	// һ֡ƵĻ棨Ԥ alpha  BGRA أУ
+	// δʹʱ false
+	static bool getFramePixels(
+		std::vector<UINT32> & pixels,
+		UINT32 & width,
+		UINT32 & height
+	);
+
+	// һ֡ƵĻοȶԣһֵͨ tolerance 
+	// Сͬδʹʱнϴ
+	static size_t compareFramePixels(
+		const std::vector<UINT32> & reference,
+		UINT32 tolerance = 0
+	);
+
+	// ù̶߼Ƶʣ/룩
+	// Ϸ߼̶£水 setFPS õ֡ʻƣڵı任θֵ֮
+	// Ϊ 0 ʱÿ֡һ߼Ĭϣ
+	static void setUpdateRate(
+		UINT32 rate
+	);
+
+	// ȡ̶߼Ƶʣδʱ 0
+	static UINT32 getUpdateRate();
+
+	// õȴһ֡ķʽ
+	// ĬΪ SLEEP_SPINϵͳָ֧߾ȶʱʱ WAITABLE_TIMER ͬ SLEEP_SPIN
+	static void setFrameWaitMode(
+		FRAME_WAIT mode
+	);
+
+	// ûʱಹĸ´
+	// ĬΪ 0ֱӶ֡
+	static void setFrameCatchUpLimit(
+		UINT32 frames
+	);
+
+	// ȡ 240 ֡֡ʱͳ
+	static EFrameStats getFrameStats();
+
+	// ȡ֡ʱİٷλ룩 99 ʾ 99% ֡ʱ
+	static float getFrameTimePercentile(
+		float percent
+	);
+
+	// ȡ 240 ֡֡ʱֲ
+	//  i Ϊ֡ʱ [i * 0.5, (i + 1) * 0.5) ڵ֡һи֡
+	static std::vector<UINT32> getFrameTimeHistogram();
+
+	// ֡ʱͳ
+	static void clearFrameStats();
+
+	// ʼ¼ÿ֡ͰϢ߼ʱƽ
+	// ¼طڼ俪İƲȴ
+	static void startRecording();
+
+	// ֹͣ¼¼浽ļ
+	static bool stopRecording(
+		const EString & fileName
+	);
+
+	// Ƿڼ¼
+	static bool isRecording();
+
+	// ȡ¼ļʼط
+	// طڼʵյͰϢÿַ֡¼Ϣ߼ʱ䰴¼ƽǰ
+	// ¼ָС뿪ʼ¼ʱͬϷ״̬¿ʼط
+	static bool startReplay(
+		const EString & fileName
+	);
+
+	// ֹͣط
+	static void stopReplay();
+
+	// Ƿط
+	static bool isReplaying();
+
 public:
 	// дڴڼʱִ
 	virtual bool onActivate();
@@ -146,12 +313,44 @@ private:
 
 	void _update();
 
-	void _render();
+	// ַ֡յͰϢطʱɼ¼еϢ
+	// bFixedStep Ϊ true ʱ߼ʱ _updateFixedStep ƽطʱֱñ֡߼ʱ
+	void _dispatchMessages(
+		bool bFixedStep
+	);
+
+	// һ֡߼½¼֡Ϣ߼ʱƽ
+	void _endFrame();
+
+	bool _render();
 
 	void _enterNextScene();
 
+	// ̶Ϸ
+	void _updateFixedStep();
+
+	// ȡһҪµʱ䣨ʱ-1 ʾ
+	LONGLONG _getNextUpdateDelay();
+
 	void _updateTime();
 
+	// ͼ߳
+	void _startRenderThread();
+
+	// ֹͣͼ߳
+	void _stopRenderThread();
+
+	// ¼ǰĻݣͼ̻߳
+	void _submitFrame();
+
+	// ͼ̷߳ȾĿ궪ʧʱؽ豸Դ
+	void _handleDeviceLost();
+
+	// ͼ߳
+	static DWORD WINAPI _renderThreadProc(
+		LPVOID lpParam
+	);
+
 	static LRESULT CALLBACK WndProc(
 		HWND hWnd,
 		UINT message,
@@ -172,6 +371,16 @@ private:
 	EScene * m_pNextScene;
 	EWindowStyle m_WindowStyle;
 	ETransition * m_pTransition;
+	bool	m_bDirtyRectEnable;
+	bool	m_bDirtyRectVisiable;
+	bool	m_bFullRedrawNeeded;
+	bool	m_bRenderOnDemand;
+	bool	m_bRenderThread;
+	LONGLONG m_nUpdateStep;
+	LONGLONG m_nAccumulator;
+	LARGE_INTEGER m_tLastStep;
+	LARGE_INTEGER m_tLastUpdate;
+	std::vector<D2D1_RECT_F> m_vDirtyRectOverlay;
 };
 
 
@@ -179,6 +388,7 @@ class EScene :
 	public EObject
 {
 	friend EApp;
+	friend ENode;
 
 public:
 	EScene();
@@ -243,15 +453,57 @@ public:
 		bool visiable
 	);
 
+	// óʱű 0.5 ΪĬΪ 1
+	// еĶͶʱźʱУǵǰʱʱֹͣ
+	void setTimeScale(
+		float scale
+	);
+
+	// ȡʱű
+	float getTimeScale() const;
+
+	// ͣʱ
+	void setTimePaused(
+		bool paused
+	);
+
+	// ʱǷͣ
+	bool isTimePaused() const;
+
+	// ȡΪǰеܺźʱ㣩
+	LONGLONG getTime() const;
+
 protected:
-	// Ⱦ
-	void _render();
+	// ƽʱӣdelta Ϊһ֡ļʱ
+	void _advanceTime(
+		LONGLONG delta
+	);
+
+	// Ⱦ棬clip ΪʱֻȾཻĽڵ
+	void _render(
+		const D2D1_RECT_F * clip = nullptr
+	);
+
+	// Ҫػ
+	void _addDirtyRect(
+		const D2D1_RECT_F & rect
+	);
+
+	// нڵ㷢仯
+	void _updateDirtyRects();
+
+	// ¼Ļ
+	void _snapshot(
+		ERenderFrame & frame
+	);
 
 protected:
 	bool m_bSortNeeded;
 	bool m_bWillSave;
 	bool m_bGeometryVisiable;
 	ENode * m_pRoot;
+	std::vector<D2D1_RECT_F> m_vDirtyRects;
+	GameClock m_Clock;
 };
 
 }
\ No newline at end of file
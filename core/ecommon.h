@@ -1,8 +1,10 @@
 #pragma once
 #include "emacros.h"
+#include "Tool\GlyphAtlas.h"
 #include <vector>
 #include <functional>
 #include <sstream>
+#include <type_traits>
 
 namespace e2d
 {
@@ -129,6 +131,42 @@ struct EWindowStyle
 	}
 };
 
+// ֡ʱͳƣ룩
+struct EFrameStats
+{
+	UINT32 m_nFrames;	/* ͳƵ֡ */
+	float m_fAverage;	/* ƽ֡ʱ */
+	float m_fMin;		/* ֡ʱ */
+	float m_fMax;		/* ֡ʱ */
+	float m_fJitter;	/* ֡ʱı׼ */
+
+	EFrameStats()
+	{
+		m_nFrames = 0;
+		m_fAverage = 0;
+		m_fMin = 0;
+		m_fMax = 0;
+		m_fJitter = 0;
+	}
+};
+
+// ޴еͳ
+struct EHeadlessStats
+{
+	UINT32 m_nFrames;			/* ִе֡ */
+	float m_fSimulatedTime;		/* ģϷʱ룩 */
+	float m_fWallTime;			/* ʵʺʱ룩 */
+	float m_fFramesPerSecond;	/* ÿʵִе֡ */
+
+	EHeadlessStats()
+	{
+		m_nFrames = 0;
+		m_fSimulatedTime = 0;
+		m_fWallTime = 0;
+		m_fFramesPerSecond = 0;
+	}
+};
+
 // ַ
 class EString
 {
@@ -138,21 +176,40 @@ public:
 	EString(const wchar_t *);
 	EString(const EString &);
 	EString(const std::wstring &);
-	EString(EString &&);
+	EString(EString &&) E2D_NOEXCEPT;
+
+	// ַǰ count ַ
+	EString(
+		const wchar_t * str,
+		int count
+	);
+
+	//  UTF-8 ַ죬 EString ĺҲֱӴ UTF-8 ַ
+	EString(
+		const char * utf8
+	);
+
+	// ַʹ nullptr ڿַ UTF-8 ַĹ캯֮
+	EString(std::nullptr_t);
 
 	~EString();
 
 	EString& operator=(const wchar_t *);
 	EString& operator=(const EString &);
 	EString& operator=(const std::wstring &);
+	EString& operator=(EString &&) E2D_NOEXCEPT;
+	EString& operator=(const char *);
+	EString& operator=(std::nullptr_t);
 
 	bool operator==(const wchar_t *);
 	bool operator==(const EString &);
 	bool operator==(const std::wstring &);
+	bool operator==(const char *);
 
 	bool operator!=(const wchar_t *);
 	bool operator!=(const EString &);
 	bool operator!=(const std::wstring &);
+	bool operator!=(const char *);
 
 	wchar_t &operator[](int);
 
@@ -160,6 +217,7 @@ public:
 	EString operator+(const wchar_t *);
 	EString operator+(const EString &);
 	EString operator+(const std::wstring &);
+	EString operator+(const char *);
 
 	template<typename T>
 	EString operator+(const T value)
@@ -174,6 +232,8 @@ public:
 	EString &operator +=(const wchar_t *);
 	EString &operator +=(const EString &);
 	EString &operator +=(const std::wstring &);
+	EString &operator +=(int);
+	EString &operator +=(const char *);
 
 	template<typename T>
 	EString &operator +=(const T value)
@@ -195,10 +255,11 @@ public:
 	friend EString operator+(const wchar_t*, const EString &);
 	friend EString operator+(const EString &, const EString &);
 	friend EString operator+(const std::wstring &, const EString &);
+	friend EString operator+(const char *, const EString &);
 	template<typename T>
 	friend EString operator+(const T &value, const EString &str)
 	{
-		return std::move((EString::parse(value) + str2));
+		return EString::parse(value) + str;
 	}
 
 	friend std::wistream &operator>>(std::wistream &, EString &);
@@ -233,6 +294,12 @@ public:
 	// ַ
 	EString &append(const EString &str);
 
+	// ַǰ count ַ
+	EString &append(
+		const wchar_t *str,
+		int count
+	);
+
 	// ַ
 	template<typename T>
 	EString &append(const T &value)
@@ -240,9 +307,53 @@ public:
 		return (*this) += value;
 	}
 
+	//  width ַʱ fill 루fill Ϊ '0' ʱڸ֮
+	// ַַռ㹻ʱڴ
+	EString &appendInt(
+		long long value,
+		int width = 0,
+		wchar_t fill = L' '
+	);
+
+	// ӱ precision λС0 ~ 64ĸ swprintf  "%.*f" ͬwidth  fill ͬ appendInt
+	EString &appendFloat(
+		double value,
+		int precision = 2,
+		int width = 0,
+		wchar_t fill = L' '
+	);
+
+	// Ԥܱ capacity ַĿռ䣬֮󳤶Ȳ capacity ƴӲٷڴ
+	void reserve(
+		int capacity
+	);
+
+	// ȡ·ڴʱַܱ
+	int capacity() const { return _capacity; }
+
+	// ַѷĿռ
+	void clear();
+
 	// ȡַɢֵ
 	unsigned int hash() const;
 
+	// תΪ UTF-8 ַЧĴ滻Ϊ U+FFFD
+	std::string toUtf8() const;
+
+	//  UTF-8 ַתΪ EStringlength Ϊ -1 ʱȡ '\0' ΪֹЧ滻Ϊ U+FFFD
+	static EString fromUtf8(
+		const char * str,
+		int length = -1
+	);
+
+	//  UTF-8 ַתΪ EString
+	static EString fromUtf8(
+		const std::string & str
+	);
+
+	// תΪַ
+	static EString parse(int value);
+
 	// ģתΪַ
 	template<typename T>
 	static EString parse(const T value)
@@ -256,9 +367,78 @@ public:
 		return std::move(str);
 	}
 
+private:
+	// ȵֱַӱڶڲڴ
+	enum { LOCAL_CAPACITY = 15 };
+
+	// ַǷ񱣴ڶڲ
+	bool _isLocal() const { return _string == _local; }
+
+	// ռ䵽ܱ capacity ַԭ
+	void _grow(int capacity);
+
+	// ַ滻Ϊ str ǰ count ַ
+	void _assign(const wchar_t *str, int count);
+
+	// һַƶݣstr Ϊַ
+	// ַƵڲַתȨڴ
+	void _moveFrom(EString &str) E2D_NOEXCEPT;
+
+	//  UTF-8 ַǰ length ֽڽӵĩβ
+	void _appendUtf8(const char *utf8, int length);
+
 private:
 	wchar_t *_string;
 	int _size;
+	int _capacity;
+	wchar_t _local[LOCAL_CAPACITY + 1];
+};
+
+// ʱֻв׳쳣ƶŻᱻʹãḴÿַ
+#ifdef E2D_HAS_NOEXCEPT
+static_assert(std::is_nothrow_move_constructible<EString>::value, "EString must be nothrow move constructible");
+static_assert(std::is_nothrow_move_assignable<EString>::value, "EString must be nothrow move assignable");
+#endif
+
+// 
+// ͬƹȫƱеͬһָָֻ
+// ȽֻȽָ룬ɢֵڼƱʱһ
+// Ʊеڳڼ䲻ɾʱƴӳƣ "enemy" + idһֱռڴ棬
+// ̶ĶӦʹ޵ļƣƶֱӱָ
+class EName
+{
+public:
+	// Ʊеһ
+	struct Entry;
+
+public:
+	// 
+	EName();
+
+	// ַƱ
+	explicit EName(
+		const EString & str
+	);
+
+	// ѼƱƣʱؿƣ޸ƱҲڴ
+	static EName find(
+		const EString & str
+	);
+
+	// Ƿǿ
+	bool isEmpty() const;
+
+	// ȡƵɢֵ EString::hash ͬ
+	unsigned int hash() const;
+
+	// ȡƵַ
+	const EString & toString() const;
+
+	bool operator==(const EName & name) const;
+	bool operator!=(const EName & name) const;
+
+private:
+	const Entry * m_pEntry;
 };
 
 // ɫ
@@ -437,6 +617,8 @@ public:
 };
 
 
+struct EInputEvent;
+
 // Ϣ
 class EMouseMsg
 {
@@ -487,16 +669,21 @@ public:
 	// ȡǰϢ
 	static MOUSE_MSG getMsg();
 
+	// ȡڷַϢ
+	static const EInputEvent & getEvent();
+
 public:
-	static UINT s_nMsg;
-	static WPARAM s_wParam;
-	static LPARAM s_lParam;
+	static EInputEvent s_Event;
 };
 
 
+class EMsgManager;
+
 // Ϣ
 class EKeyboardMsg
 {
+	friend EMsgManager;
+
 public:
 	// Ϣͼ
 	enum KEYBOARD_MSG
@@ -543,10 +730,21 @@ public:
 	static DWORD getCount();
 
 	// ȡض״̬
+	// ״̬ÿַ֡Ϣǰɱ֡յİϢͳһ£ͬһ֡ڲѯĽֲ
 	static bool isKeyDown(
 		KEY key
 	);
 
+	// Ƿڱ֡£סʱظϢ
+	static bool wasPressedThisFrame(
+		KEY key
+	);
+
+	// Ƿڱ̧֡
+	static bool wasReleasedThisFrame(
+		KEY key
+	);
+
 	// ȡСд״̬
 	static bool isCapitalLockOn();
 
@@ -556,10 +754,54 @@ public:
 	// ȡ״̬
 	static bool isScrollLockOn();
 
+	// ȡڷַİϢ
+	static const EInputEvent & getEvent();
+
+private:
+	// ʼµһ֡һ֡İº̧״̬
+	static void _beginFrame();
+
+	// ݰϢ°״̬
+	// ʧȥղ̧ϢWM_KILLFOCUS ϢΪа̧
+	static void _updateKeyState(
+		const EInputEvent & event
+	);
+
 public:
-	static UINT s_nMsg;
-	static WPARAM s_wParam;
-	static LPARAM s_lParam;
+	static EInputEvent s_Event;
+};
+
+
+// Ϣ
+// յͰϢȴʱУÿ֡Ϸǰͳһַ
+struct EInputEvent
+{
+	UINT		m_nMsg;		/* Ϣ */
+	WPARAM		m_wParam;	/* Ϣ */
+	LPARAM		m_lParam;
+	LONGLONG	m_nTime;	/* յϢʱ䣨ʱڣ */
+	UINT		m_nCount;	/* ϲƶϢϢΪ 1 */
+
+	EInputEvent()
+	{
+		m_nMsg = 0;
+		m_wParam = 0;
+		m_lParam = 0;
+		m_nTime = 0;
+		m_nCount = 0;
+	}
+
+	// ǷϢ
+	bool isMouseMsg() const;
+
+	// ȡ
+	EPoint getPos() const;
+
+	// ȡֵ
+	int getWheelDelta() const;
+
+	// ȡֵ
+	EKeyboardMsg::KEY getKeyValue() const;
 };
 
 
@@ -619,10 +861,13 @@ private:
 
 class EText;
 
+class EBitmapFont;
+
 class EFont :
 	public EObject
 {
 	friend EText;
+	friend EBitmapFont;
 
 public:
 	EFont();
@@ -674,11 +919,14 @@ public:
 		bool value
 	);
 
+	// ͷŻָʽʹõĸʽڲʹúͷ
+	static void clearCache();
+
 protected:
-	// ָʽ
+	// ȡõָʽ
 	void _initTextFormat();
 
-	// ȡָʽ
+	// ȡָʽ EFont ã޸ģ
 	IDWriteTextFormat * _getTextFormat();
 
 protected:
@@ -688,16 +936,28 @@ protected:
 	UINT32		m_Color;
 	bool		m_bItalic;
 	bool		m_bRecreateNeeded;
+	UINT		m_nPackGeneration;
 	IDWriteTextFormat * m_pTextFormat;
 };
 
 
 class ESprite;
+class ESpriteFrame;
+class EBitmapText;
+class EApp;
+class ED2DRenderer;
+class ESoftwareRenderer;
+struct ETextureEntry;
 
 class ETexture :
 	public EObject
 {
 	friend ESprite;
+	friend ESpriteFrame;
+	friend EBitmapText;
+	friend EApp;
+	friend ED2DRenderer;
+	friend ESoftwareRenderer;
 
 public:
 	// һյ
@@ -714,6 +974,13 @@ public:
 		LPCTSTR resourceType
 	);
 
+	// ڴеش
+	ETexture(
+		const UINT32 * pixels,
+		UINT32 width,
+		UINT32 height
+	);
+
 	virtual ~ETexture();
 
 	// ӱļжȡԴ
@@ -727,6 +994,13 @@ public:
 		LPCTSTR resourceType
 	);
 
+	// ڴеأԤ alpha  BGRAÿ width أر
+	void loadFromMemory(
+		const UINT32 * pixels,
+		UINT32 width,
+		UINT32 height
+	);
+
 	// ȡԴͼƬ
 	virtual float getSourceWidth() const;
 
@@ -736,6 +1010,9 @@ public:
 	// ȡԴͼƬС
 	virtual ESize getSourceSize() const;
 
+	// ȡ֡Ԥļ֡
+	int getFrameCount() const;
+
 	// ԤԴ
 	static bool preload(
 		const EString & fileName
@@ -750,11 +1027,56 @@ public:
 	// ջ
 	static void clearCache();
 
+	// ڴޣֽڣΪ 0 ʱ
+	static void setCacheBudget(
+		size_t bytes
+	);
+
+	// ȡڴޣֽڣ
+	static size_t getCacheBudget();
+
+	// ȡ浱ǰռõڴ棨ֽڣ
+	static size_t getCacheMemory();
+
+	// ȡд
+	static size_t getCacheHits();
+
+	// ȡδд
+	static size_t getCacheMisses();
+
+	// ȡ̭
+	static size_t getCacheEvictions();
+
 protected:
+	// ȡλͼλͼѱͷʱ¼
 	ID2D1Bitmap * _getBitmap();
 
+	// ȡʹõأѱͷʱ¼
+	bool _getPixels(
+		const UINT32 ** ppPixels,
+		UINT32 & width,
+		UINT32 & height
+	);
+
+	// µĻ
+	void _setEntry(
+		ETextureEntry * entry
+	);
+
+	// ͷλͼȾĿؽʱã
+	static void _discardBitmaps();
+
+	// ȡ֡
+	bool _getFrame(
+		int index,
+		float & x,
+		float & y,
+		float & width,
+		float & height
+	) const;
+
 protected:
-	ID2D1Bitmap * m_pBitmap;
+	ETextureEntry * m_pEntry;
 };
 
 
@@ -783,6 +1105,12 @@ public:
 		LPCTSTR resourceType
 	);
 
+	// Ԥļе֡
+	ESpriteFrame(
+		ETexture * texture,
+		int frameIndex
+	);
+
 	// յľ֡
 	ESpriteFrame(
 		ETexture * texture,
@@ -844,6 +1172,62 @@ protected:
 	ETexture * m_pTexture;
 };
 
+
+// λͼ壬ִԤȻƺεͼлƣʺÿ֡ڱ仯
+class EBitmapFont :
+	public EObject
+{
+	friend EBitmapText;
+
+public:
+	// ȡ BMFont ıʽļ.fntͼҳͼƬ·ļ
+	EBitmapFont(
+		const EString & fntFileName
+	);
+
+	// ʹʱͼcharacters еַԤɣַ״ʹʱ
+	// ΰʱʽɫ
+	EBitmapFont(
+		EFont * font,
+		const EString & characters = L""
+	);
+
+	virtual ~EBitmapFont();
+
+	// ȡи
+	float getLineHeight() const;
+
+	// ȡͼҳ
+	int getPageCount() const;
+
+	// ԤַеΣʱɵͼ
+	void prepare(
+		const EString & characters
+	);
+
+protected:
+	// ȡ BMFont ļ
+	bool _loadFromFile(
+		const EString & fntFileName
+	);
+
+	// ȱٵβͼҳ
+	void _rasterize(
+		const std::vector<unsigned int> & codes
+	);
+
+	// ȡͼҳ
+	ETexture * _getPage(
+		int page
+	) const;
+
+protected:
+	GlyphAtlas	m_Atlas;
+	EFont *		m_pFont;		/* ʱʹõ壬ȡΪ */
+	std::vector<ETexture*> m_vPages;
+	std::vector<std::vector<UINT32>> m_vPagePixels;	/* ʱɵͼҳ */
+};
+
 class ENode;
 
 // ʱصΪöʱõĴ 0 ʼ
@@ -855,9 +1239,15 @@ typedef std::function<void()> BUTTON_CLICK_CALLBACK;
 // Ϣص
 typedef std::function<void()> KEY_LISTENER_CALLBACK;
 
+// ϢصΪڷַİϢ
+typedef std::function<void(const EInputEvent & event)> KEY_EVENT_LISTENER_CALLBACK;
+
 // Ϣص
 typedef std::function<void()> MOUSE_LISTENER_CALLBACK;
 
+// ϢصΪڷַϢ
+typedef KEY_EVENT_LISTENER_CALLBACK  MOUSE_EVENT_LISTENER_CALLBACK;
+
 // ϢصΪλã
 typedef std::function<void(EPoint mousePos)> MOUSE_CLICK_LISTENER_CALLBACK;
 
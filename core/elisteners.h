@@ -32,13 +32,13 @@ public:
 	void stop();
 
 	// ȡ
-	EString getName() const;
+	const EString & getName() const;
 
 	// ȡڽڵ
 	ENode * getParentNode() const;
 
 	// ü
-	void setName(
+	virtual void setName(
 		const EString &name
 	);
 
@@ -70,7 +70,7 @@ protected:
 	virtual bool _isReady() const;
 
 protected:
-	EString		m_sName;
+	EName		m_Name;
 	bool		m_bRunning;
 	bool		m_bAlways;
 	bool		m_bSwallow;
@@ -105,6 +105,25 @@ public:
 		const MOUSE_LISTENER_CALLBACK &callback
 	);
 
+	// ýϢĻصڼصִ֮
+	void setEventCallback(
+		const MOUSE_EVENT_LISTENER_CALLBACK &callback
+	);
+
+	// ü
+	virtual void setName(
+		const EString &name
+	) override;
+
+	// üֻλڽڵʱϢ
+	// 뿪ڵ󻹻յһϢڽڵϰ̧֮ǰϢҲյ
+	void setHitTest(
+		bool bHitTest
+	);
+
+	// ǷֻλڽڵʱϢ
+	bool isHitTest() const;
+
 	// 󶨼
 	virtual void bindWith(
 		EScene * pParentScene
@@ -120,7 +139,9 @@ protected:
 	virtual void _callOn() override;
 
 protected:
+	bool m_bHitTest;
 	MOUSE_LISTENER_CALLBACK m_Callback;
+	MOUSE_EVENT_LISTENER_CALLBACK m_EventCallback;
 };
 
 
@@ -290,6 +311,16 @@ public:
 		const KEY_LISTENER_CALLBACK &callback
 	);
 
+	// ýϢĻصڼصִ֮
+	void setEventCallback(
+		const KEY_EVENT_LISTENER_CALLBACK &callback
+	);
+
+	// ü
+	virtual void setName(
+		const EString &name
+	) override;
+
 	// 󶨼
 	virtual void bindWith(
 		EScene * pParentScene
@@ -306,6 +337,7 @@ protected:
 
 protected:
 	KEY_LISTENER_CALLBACK m_Callback;
+	KEY_EVENT_LISTENER_CALLBACK m_EventCallback;
 };
 
 
@@ -364,6 +396,11 @@ public:
 		const PHYSICS_LISTENER_CALLBACK &callback
 	);
 
+	// ü
+	virtual void setName(
+		const EString &name
+	) override;
+
 	// 볡
 	virtual void bindWith(
 		EScene * pParentScene
@@ -60,6 +60,15 @@
 #define DEPRECATED_ATTRIBUTE __declspec(deprecated)
 
 
+// VS2015 ֮ǰı֧ noexcept
+#if defined(_MSC_VER) && _MSC_VER < 1900
+#define E2D_NOEXCEPT
+#else
+#define E2D_NOEXCEPT noexcept
+#define E2D_HAS_NOEXCEPT
+#endif
+
+
 template<typename T>
 inline void SafeDelete(T** p) { if (*p) { delete *p; *p = nullptr; } }
 
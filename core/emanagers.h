@@ -42,6 +42,8 @@ class EMsgManager
 	friend EApp;
 	friend EScene;
 	friend ENode;
+	friend EListenerMouse;
+	friend EListenerKeyboard;
 
 public:
 	// Ϣ
@@ -150,10 +152,45 @@ public:
 	// ֹͣаϢ
 	static void stopAllKeyboardListeners();
 
+	// ǷϲƶϢĬϺϲ
+	// ϲʱÿƶϢַֻһϲʱ˳ַÿһԵõ켣
+	static void setMouseMoveCoalesced(
+		bool bCoalesced
+	);
+
+	// ǷϲƶϢ
+	static bool isMouseMoveCoalesced();
+
 private:
 	// м
 	static void _clearManager();
 
+	// յ򰴼ϢϢ
+	static void _postMessage(
+		UINT message,
+		WPARAM wParam,
+		LPARAM lParam
+	);
+
+	// ϢԭϢУϢϲطż¼Ϣ
+	static void _postMessage(
+		const EInputEvent & event
+	);
+
+	// ȡеϢ
+	static void _getMessages(
+		std::vector<EInputEvent> & events
+	);
+
+	// ʼµһ֡ݶеİϢ°״̬
+	static void _updateKeyStates();
+
+	// ˳ַеϢ
+	static void _dispatchMessages();
+
+	// еϢ
+	static void _clearMessages();
+
 	// ڽڵϵϢ
 	static void _clearAllMouseListenersBindedWith(
 		ENode * pParentNode
@@ -164,18 +201,48 @@ private:
 		ENode * pParentNode
 	);
 
+	// ͬϢ
+	static void _findMouseListeners(
+		const EString & name,
+		std::vector<EListenerMouse*> & listeners
+	);
+
+	// ͬİϢ
+	static void _findKeyboardListeners(
+		const EString & name,
+		std::vector<EListenerKeyboard*> & listeners
+	);
+
+	// ޸Ѱ󶨵Ϣƣ
+	static void _renameListener(
+		EListenerMouse * listener,
+		const EString & name
+	);
+
+	// ޸Ѱ󶨵İϢƣ
+	static void _renameListener(
+		EListenerKeyboard * listener,
+		const EString & name
+	);
+
+	//  HitTest Ըı󣬸ڵķַб
+	static void _updateRoute(
+		EListenerMouse * listener
+	);
+
+	// ӷַбƳϢ
+	static void _removeRoute(
+		EListenerMouse * listener
+	);
+
 	// Ϣ
 	static void MouseProc(
-		UINT message,
-		WPARAM wParam,
-		LPARAM lParam
+		const EInputEvent & event
 	);
 
 	// Ϣ
 	static void KeyboardProc(
-		UINT message,
-		WPARAM wParam,
-		LPARAM lParam
+		const EInputEvent & event
 	);
 };
 
@@ -186,6 +253,7 @@ class ETimerManager
 	friend EApp;
 	friend EScene;
 	friend ENode;
+	friend ETimer;
 
 public:
 	// 󶨶ʱ
@@ -253,6 +321,21 @@ private:
 	// öʱ״̬
 	static void _resetAllTimers();
 
+	// ͬĶʱ
+	static void _findTimers(
+		const EString & name,
+		std::vector<ETimer*> & timers
+	);
+
+	// ޸Ѱ󶨵Ķʱƣ
+	static void _renameTimer(
+		ETimer * timer,
+		const EString & name
+	);
+
+	// ȡһʱʱ䣨ʱûҪĶʱʱ -1
+	static LONGLONG _getNextTimerDelay();
+
 	// ʱִг
 	static void TimerProc();
 };
@@ -307,6 +390,9 @@ private:
 	// ж״̬
 	static void _resetAllActions();
 
+	// ǰǷеĶ
+	static bool _hasRunningActions();
+
 	// ִг
 	static void ActionProc();
 };
@@ -318,6 +404,7 @@ class EPhysicsManager
 	friend EScene;
 	friend ENode;
 	friend EGeometry;
+	friend EListenerPhysics;
 
 public:
 	// 볡
@@ -387,6 +474,18 @@ private:
 		EGeometry * geometry
 	);
 
+	// ͬļ
+	static void _findListeners(
+		const EString & name,
+		std::vector<EListenerPhysics*> & listeners
+	);
+
+	// ޸Ѱ󶨵ļƣ
+	static void _renameListener(
+		EListenerPhysics * listener,
+		const EString & name
+	);
+
 	// հڽڵϵм
 	static void _clearAllListenersBindedWith(
 		ENode * pParentNode
@@ -12,6 +12,11 @@ class EButtonToggle;
 class EGeometry;
 class EMenu;
 class ETransition;
+class ERenderFrame;
+struct ERenderItem;
+class ETimer;
+class ETimerManager;
+class EMsgManager;
 
 class ENode :
 	public EObject
@@ -21,6 +26,11 @@ class ENode :
 	friend EButtonToggle;
 	friend EGeometry;
 	friend ETransition;
+	friend EApp;
+	friend EAction;
+	friend ETimer;
+	friend ETimerManager;
+	friend EMsgManager;
 
 public:
 	ENode();
@@ -43,6 +53,9 @@ public:
 	// ȡڵ
 	virtual EString getName() const;
 
+	// ȡڵƱеȽʱҪȽַ
+	const EName & getNameAtom() const;
+
 	// ȡڵͼ˳
 	virtual int getOrder() const;
 
@@ -308,6 +321,23 @@ public:
 		EPoint point
 	);
 
+	// ýڵ㼰ӽڵʱű 0.5 ΪĬΪ 1
+	// ڵϵĶͶʱڵʱԸñ
+	void setTimeScale(
+		float scale
+	);
+
+	// ȡڵʱű
+	float getTimeScale() const;
+
+	// ͣڵ㼰ӽڵʱ䣬ͣʱڵϵĶͶʱֹͣ
+	void setTimePaused(
+		bool paused
+	);
+
+	// ڵʱǷͣ
+	bool isTimePaused() const;
+
 	// ޸ĽڵĬĵλ
 	static void setDefaultPiovt(
 		float defaultPiovtX,
@@ -353,6 +383,27 @@ protected:
 	// ½ڵ͸
 	static void _updateOpacity(ENode * node);
 
+	// ǽڵҪ¼任
+	void _setTransformNeeded();
+
+	// ǽڵ㼰丸ڵİΧҪ¼
+	void _setBoundingBoxNeeded();
+
+	// ڵ㼰ӽڵڴеİΧ
+	void _updateBoundingBox();
+
+	// жϴеĵǷڽڵľڣӽڵ㣩
+	bool _containsPoint(
+		const EPoint & point
+	);
+
+	// ˳ϵ²ҵڵĿɼڵ
+	// ҵʱ truepath μýڵ㼰ڵ㣨ֱڵ㣩
+	bool _pick(
+		const EPoint & point,
+		std::vector<ENode*> & path
+	);
+
 	// ýڵ
 	virtual void _setWidth(
 		float width
@@ -374,9 +425,76 @@ protected:
 		float height
 	);
 
+	// ǽڵʾѸı
+	void _setDirty();
+
+	// ȡڵڽڵϵеķΧĬΪڵ
+	// ݳڵСĽڵҪд򳬳ھֲػʱᱻ©
+	virtual D2D1_RECT_F _getDrawnBounds();
+
+	// ڵڴеʾıʱΪҪػ
+	void _updateDirtyRect(
+		bool visiable
+	);
+
+	// ڵ㼰ӽڵһλƵΪҪػ
+	void _clearDrawnRect();
+
+	// ȾʱĲüĽڵ㲻Ⱦ
+	static void _setRenderClip(
+		const D2D1_RECT_F * clip
+	);
+
+	// ڵ㼰ӽڵ㵱ǰı任
+	void _saveTransform();
+
+	// ȡȾʱʹõı任ϴαľ͵ǰֵ֮
+	D2D1::Matrix3x2F _getRenderTransform() const;
+
+	// ڵı任Ϊֵ
+	static void _saveTransforms(
+		ENode * root
+	);
+
+	// ȾʱĲֵΪ 1 ʱʹõǰı任
+	static void _setInterpolation(
+		float alpha
+	);
+
+	// ¼ڵ㼰ӽڵĻݣڻͼ߳л
+	void _snapshot(
+		ERenderFrame & frame
+	);
+
+	// ¼ڵĻݣĬڻͼִ߳ _render 
+	virtual void _record(
+		ERenderFrame & frame
+	);
+
+	// ¼ڵ㼰ӽڵļ״
+	void _snapshotGeometry(
+		ERenderFrame & frame
+	);
+
+	// ڻͼִ߳һλ
+	static void _renderItem(
+		const ERenderItem & item
+	);
+
+	// ȡڵıʱ䣨ʱڣͶʱԴ˼ʱ
+	LONGLONG _getLocalTime();
+
+	// ȡڵ㣨򳡾ȫʱӣĵǰʱ
+	LONGLONG _getParentTime();
+
+	// ȡڵʱȫʱӵٶȣʱֹͣʱΪ 0
+	float _getGlobalTimeScale() const;
+
+	// ҽӵµĸڵ򳡾󣬴䵱ǰʱ俪ʼ
+	void _attachTime();
+
 protected:
-	EString		m_sName;
-	size_t		m_nHashName;
+	EName		m_Name;
 	EPoint		m_Pos;
 	ESize		m_Size;
 	float		m_fScaleX;
@@ -393,11 +511,20 @@ protected:
 	bool		m_bDisplayedInScene;
 	bool		m_bSortChildrenNeeded;
 	bool		m_bTransformNeeded;
+	bool		m_bInverseNeeded;
+	bool		m_bBoundingBoxNeeded;
+	bool		m_bDirty;
+	D2D1_RECT_F	m_DrawnRect;
+	D2D1_RECT_F	m_BoundingBox;	/* ڵ㼰ӽڵڴеİΧ */
 	EGeometry * m_pGeometry;
 	EScene *	m_pParentScene;
 	ENode *		m_pParent;
 	D2D1::Matrix3x2F	m_MatriInitial;
 	D2D1::Matrix3x2F	m_MatriFinal;
+	D2D1::Matrix3x2F	m_MatriPrevious;
+	D2D1::Matrix3x2F	m_MatriInverse;
+	UINT		m_nSavedTransform;
+	GameClock	m_Clock;
 	std::vector<ENode*>		m_vChildren;
 };
 
@@ -493,6 +620,11 @@ protected:
 	// Ⱦ
 	virtual void _render() override;
 
+	// ¼λͼ
+	virtual void _record(
+		ERenderFrame & frame
+	) override;
+
 protected:
 	float	m_fSourceClipX;
 	float	m_fSourceClipY;
@@ -566,6 +698,14 @@ protected:
 	// Ⱦ
 	virtual void _render() override;
 
+	// ¼
+	virtual void _record(
+		ERenderFrame & frame
+	) override;
+
+	// ȡֵĻƷΧıʻ
+	virtual D2D1_RECT_F _getDrawnBounds() override;
+
 	// ֲ
 	void _initTextLayout();
 
@@ -574,6 +714,67 @@ protected:
 	bool	m_bWordWrapping;
 	float	m_fWordWrappingWidth;
 	EFont * m_pFont;
+	IDWriteTextLayout * m_pTextLayout;
+	IDWriteTextFormat * m_pLayoutFormat;	/* Űʱʹõ TextFormat */
+};
+
+
+// ʹλͼƵ֣޸ʱֻΣ DirectWrite 
+class EBitmapText :
+	public ENode
+{
+public:
+	EBitmapText();
+
+	EBitmapText(
+		EBitmapFont * font
+	);
+
+	EBitmapText(
+		const EString & text,
+		EBitmapFont * font
+	);
+
+	virtual ~EBitmapText();
+
+	// ȡı
+	EString getText() const;
+
+	// ȡ
+	EBitmapFont * getFont() const;
+
+	// ıʱɵȱٵ
+	void setText(
+		const EString & text
+	);
+
+	// 
+	void setFont(
+		EBitmapFont * font
+	);
+
+protected:
+	// Ⱦ
+	virtual void _render() override;
+
+	// ¼
+	virtual void _record(
+		ERenderFrame & frame
+	) override;
+
+	// 
+	void _initLayout();
+
+	// ȡεĻƷΧ
+	virtual D2D1_RECT_F _getDrawnBounds() override;
+
+protected:
+	EString			m_sText;
+	EBitmapFont *	m_pFont;
+	std::vector<GlyphAtlas::Quad>	m_vQuads;
+	std::vector<D2D1_RECT_F>		m_vDestRects;
+	std::vector<D2D1_RECT_F>		m_vSrcRects;
+	std::vector<std::pair<int, UINT32>>	m_vPageRuns;	/* ÿڵͼҳ */
 };
 
 
@@ -43,7 +43,7 @@ public:
 	void stop();
 
 	// ȡʱ
-	EString getName() const;
+	const EString & getName() const;
 
 	// ȡʱڽڵ
 	ENode * getParentNode() const;
@@ -90,8 +90,11 @@ protected:
 	// жǷﵽִ״̬
 	bool _isReady();
 
+	// ȡ󶨽ڵıʱ䣬δʱΪȫʱ
+	LONGLONG _getNow();
+
 protected:
-	EString			m_sName;
+	EName			m_Name;
 	bool			m_bRunning;
 	bool			m_bAtOnce;
 	int				m_nRunTimes;
@@ -167,6 +170,29 @@ public:
 };
 
 
+class EPackUtils
+{
+public:
+	// Դ֮ ETextureEFontEMusicUtils ȴԴжȡļ
+	static bool mount(
+		const EString & packFilePath
+	);
+
+	// жԴ
+	static void unmount(
+		const EString & packFilePath
+	);
+
+	// жԴ
+	static void unmountAll();
+
+	// жѹصԴǷڸļ
+	static bool exists(
+		const EString & fileName
+	);
+};
+
+
 class ERandom
 {
 public:
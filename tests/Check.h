@@ -0,0 +1,18 @@
+#pragma once
+#include <cstdio>
+
+
+// õļ꣬ʧʱλòmain  CHECK_RESULT() Ϊ˳
+static int s_nCheckFailures = 0;
+
+#define CHECK(expr) \
+	do { \
+		if (!(expr)) \
+		{ \
+			std::printf("%s(%d): CHECK failed: %s\n", __FILE__, __LINE__, #expr); \
+			s_nCheckFailures++; \
+		} \
+	} while (0)
+
+#define CHECK_RESULT() \
+	(std::printf(s_nCheckFailures ? "%d check(s) failed\n" : "all checks passed\n", s_nCheckFailures), s_nCheckFailures ? 1 : 0)
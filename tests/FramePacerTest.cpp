@@ -0,0 +1,303 @@
+#include "FramePacer.h"
+#include "Check.h"
+#include <cmath>
+#include <vector>
+
+
+// ʱӣʱ䵥λΪ΢룬ֻ֡ʿƵùæȴʱǰ
+// ͶʱʵʱԳʱģϵͳȵ
+class FakeClock :
+	public FrameClock
+{
+public:
+	FakeClock()
+		: time(0)
+		, oversleep(0)
+		, timerOvershoot(0)
+		, timerSupported(true)
+		, spinStep(10)
+		, spins(0)
+	{
+	}
+
+	virtual long long now() { return time; }
+
+	virtual long long frequency() { return 1000000; }
+
+	virtual void sleep(long long ticks)
+	{
+		sleeps.push_back(ticks);
+		time += ticks + oversleep;
+	}
+
+	virtual bool waitTimer(long long ticks)
+	{
+		timerWaits.push_back(ticks);
+		if (!timerSupported)
+			return false;
+		time += ticks + timerOvershoot;
+		return true;
+	}
+
+	virtual void spin()
+	{
+		spins++;
+		time += spinStep;
+	}
+
+	// ü¼
+	void clearLog()
+	{
+		sleeps.clear();
+		timerWaits.clear();
+		spins = 0;
+	}
+
+public:
+	long long time;
+	long long oversleep;
+	long long timerOvershoot;
+	bool timerSupported;
+	long long spinStep;
+	std::vector<long long> sleeps;
+	std::vector<long long> timerWaits;
+	int spins;
+};
+
+static bool Near(double a, double b)
+{
+	return std::fabs(a - b) < 1e-9;
+}
+
+
+// ׼ʱʼֻ֡һΣʱ޲֡һ֡ԭĽ
+static void TestCatchUp()
+{
+	const unsigned int limits[] = { 0, 1, 5 };
+	const unsigned int expected[] = { 1, 2, 3 };
+	for (int i = 0; i < 3; i++)
+	{
+		FakeClock clock;
+		FramePacer pacer(&clock);
+		pacer.setInterval(10000);
+		pacer.setCatchUpLimit(limits[i]);
+		CHECK(pacer.getCatchUpLimit() == limits[i]);
+
+		CHECK(pacer.beginFrame() == 1);
+		CHECK(pacer.getRemaining() == 10000);
+
+		//  2.5 ֡
+		clock.time = 35000;
+		CHECK(pacer.beginFrame() == expected[i]);
+		CHECK(pacer.getRemaining() == 5000);
+
+		// ǡ׼ʱ
+		clock.time = 40000;
+		CHECK(pacer.beginFrame() == 1);
+		CHECK(pacer.getRemaining() == 10000);
+	}
+
+	// ܶʱҲֻޣ֮뵽
+	FakeClock clock;
+	FramePacer pacer(&clock);
+	pacer.setInterval(10000);
+	pacer.setCatchUpLimit(3);
+	pacer.beginFrame();
+	clock.time = 1000000 + 2500;
+	CHECK(pacer.beginFrame() == 4);
+	CHECK(pacer.getRemaining() == 7500);
+
+	// reset һ֡ʼ
+	clock.time += 100;
+	pacer.reset();
+	CHECK(pacer.getRemaining() == 0);
+	CHECK(pacer.beginFrame() == 1);
+	CHECK(pacer.getRemaining() == 10000);
+
+	// Ϊ 0 ʱ֡
+	pacer.setInterval(-5);
+	CHECK(pacer.getInterval() == 0);
+	clock.time += 123456;
+	CHECK(pacer.beginFrame() == 1);
+	CHECK(pacer.getRemaining() == 0);
+}
+
+// ʼһ֡ȴصȴʱһ֡ʼʱʱ
+static long long WaitOneFrame(FakeClock & clock, FramePacer & pacer)
+{
+	pacer.beginFrame();
+	long long target = clock.time + pacer.getInterval();
+	clock.clearLog();
+	pacer.wait();
+	return clock.time - target;
+}
+
+static void TestWaitSleepSpin()
+{
+	FakeClock clock;
+	FramePacer pacer(&clock);
+	pacer.setInterval(10000);
+	CHECK(pacer.getWaitMode() == FramePacer::WAIT_SLEEP_SPIN);
+
+	// Ĭ 2 æȴ 0.5 æȴ
+	clock.oversleep = 500;
+	long long late = WaitOneFrame(clock, pacer);
+	CHECK(late >= 0 && late < clock.spinStep);
+	CHECK(clock.sleeps.size() == 1 && clock.sleeps[0] == 8000);
+	CHECK(clock.timerWaits.empty());
+	CHECK(clock.spins == 150);
+
+	// 𳬳һ֡Ŀʼʱ䣬ֱӷ
+	clock.oversleep = 5000;
+	late = WaitOneFrame(clock, pacer);
+	CHECK(late == 3000);
+	CHECK(clock.sleeps.size() == 1 && clock.spins == 0);
+
+	// æȴʱ䣬׼ȷĹһ
+	clock.oversleep = 0;
+	pacer.reset();
+	pacer.setSpinTime(0);
+	late = WaitOneFrame(clock, pacer);
+	CHECK(late == 0);
+	CHECK(clock.sleeps.size() == 1 && clock.sleeps[0] == 10000 && clock.spins == 0);
+
+	// æȴʱ䳬֡ʱֻæȴ
+	pacer.setSpinTime(20000);
+	late = WaitOneFrame(clock, pacer);
+	CHECK(late == 0);
+	CHECK(clock.sleeps.empty() && clock.spins == 1000);
+
+	// ѵһ֡Ŀʼʱʱȴ
+	pacer.beginFrame();
+	clock.time += 20000;
+	clock.clearLog();
+	pacer.wait();
+	CHECK(clock.sleeps.empty() && clock.spins == 0);
+}
+
+static void TestWaitTimer()
+{
+	FakeClock clock;
+	FramePacer pacer(&clock);
+	pacer.setInterval(10000);
+	pacer.setWaitMode(FramePacer::WAIT_TIMER);
+	CHECK(pacer.getWaitMode() == FramePacer::WAIT_TIMER);
+
+	// ߾ȶʱֻ 0.5 æȴ
+	clock.timerOvershoot = 100;
+	long long late = WaitOneFrame(clock, pacer);
+	CHECK(late >= 0 && late < clock.spinStep);
+	CHECK(clock.timerWaits.size() == 1 && clock.timerWaits[0] == 9500);
+	CHECK(clock.sleeps.empty());
+	CHECK(clock.spins == 40);
+
+	// ָ֧߾ȶʱʱ֮ͨٳԶʱ
+	clock.timerSupported = false;
+	clock.oversleep = 500;
+	late = WaitOneFrame(clock, pacer);
+	CHECK(late >= 0 && late < clock.spinStep);
+	CHECK(clock.timerWaits.size() == 1);
+	CHECK(clock.sleeps.size() == 1 && clock.sleeps[0] == 8000);
+
+	late = WaitOneFrame(clock, pacer);
+	CHECK(late >= 0 && late < clock.spinStep);
+	CHECK(clock.timerWaits.empty() && clock.sleeps.size() == 1);
+
+	// õȴʽٴγԶʱ
+	clock.timerSupported = true;
+	pacer.setWaitMode(FramePacer::WAIT_TIMER);
+	late = WaitOneFrame(clock, pacer);
+	CHECK(late >= 0 && late < clock.spinStep);
+	CHECK(clock.timerWaits.size() == 1 && clock.sleeps.empty());
+}
+
+// ָ֡ʱ䣨΢룩ʼ֡
+static void RunFrames(FakeClock & clock, FramePacer & pacer, long long frameTime, int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		clock.time += frameTime;
+		pacer.beginFrame();
+	}
+}
+
+static unsigned int HistogramTotal(const FramePacer & pacer)
+{
+	unsigned int total = 0;
+	for (unsigned int i = 0; i < FramePacer::BUCKET_COUNT; i++)
+	{
+		total += pacer.getHistogram()[i];
+	}
+	return total;
+}
+
+static void TestStats()
+{
+	FakeClock clock;
+	FramePacer pacer(&clock);
+
+	FramePacer::Stats stats;
+	pacer.getStats(stats);
+	CHECK(stats.frames == 0 && pacer.getPercentile(50) == 0);
+
+	// һ֡ûһ֡ͳ
+	pacer.beginFrame();
+	RunFrames(clock, pacer, 16000, 90);
+	RunFrames(clock, pacer, 33000, 10);
+
+	pacer.getStats(stats);
+	CHECK(stats.frames == 100);
+	CHECK(Near(stats.average, 17.7));
+	CHECK(Near(stats.minimum, 16.0));
+	CHECK(Near(stats.maximum, 33.0));
+	CHECK(Near(stats.jitter, 5.1));
+
+	const unsigned int * histogram = pacer.getHistogram();
+	CHECK(histogram[16000 / FramePacer::BUCKET_WIDTH] == 90);
+	CHECK(histogram[33000 / FramePacer::BUCKET_WIDTH] == 10);
+	CHECK(HistogramTotal(pacer) == 100);
+
+	// ٷλȡϽ
+	CHECK(Near(pacer.getPercentile(0), 16.5));
+	CHECK(Near(pacer.getPercentile(50), 16.5));
+	CHECK(Near(pacer.getPercentile(90), 16.5));
+	CHECK(Near(pacer.getPercentile(91), 33.5));
+	CHECK(Near(pacer.getPercentile(100), 33.5));
+	CHECK(Near(pacer.getPercentile(150), 33.5));
+
+	// һ֡ʱ䣬ٷλΪʵʵֵ
+	RunFrames(clock, pacer, 250000, 1);
+	CHECK(histogram[FramePacer::BUCKET_COUNT - 1] == 1);
+	CHECK(Near(pacer.getPercentile(100), 250.0));
+	CHECK(Near(pacer.getPercentile(99), 33.5));
+
+	// reset ļͳ
+	clock.time += 5000000;
+	pacer.reset();
+	pacer.beginFrame();
+	pacer.getStats(stats);
+	CHECK(stats.frames == 101);
+
+	// ֻ SAMPLE_COUNT ֡Ƴڵ֡ͬʱӷֲɾ
+	RunFrames(clock, pacer, 10000, FramePacer::SAMPLE_COUNT);
+	pacer.getStats(stats);
+	CHECK(stats.frames == FramePacer::SAMPLE_COUNT);
+	CHECK(Near(stats.average, 10.0) && Near(stats.jitter, 0.0));
+	CHECK(histogram[10000 / FramePacer::BUCKET_WIDTH] == FramePacer::SAMPLE_COUNT);
+	CHECK(HistogramTotal(pacer) == FramePacer::SAMPLE_COUNT);
+	CHECK(Near(pacer.getPercentile(100), 10.5));
+
+	pacer.clearStats();
+	pacer.getStats(stats);
+	CHECK(stats.frames == 0 && HistogramTotal(pacer) == 0);
+}
+
+
+int main()
+{
+	TestCatchUp();
+	TestWaitSleepSpin();
+	TestWaitTimer();
+	TestStats();
+	return CHECK_RESULT();
+}
@@ -0,0 +1,156 @@
+#include "GameClock.h"
+#include "Check.h"
+
+
+static void TestAdvance()
+{
+	GameClock clock;
+	CHECK(clock.getTime() == 0 && clock.getTimeScale() == 1 && !clock.isPaused());
+
+	CHECK(clock.advance(100) == 100);
+	CHECK(clock.getTime() == 100 && clock.getDelta() == 100);
+
+	// ʱ䲻ᵹ
+	CHECK(clock.advance(-50) == 0);
+	CHECK(clock.getTime() == 100 && clock.getDelta() == 0);
+
+	clock.reset(1000);
+	CHECK(clock.getTime() == 1000 && clock.getDelta() == 0);
+}
+
+static void TestScale()
+{
+	GameClock clock;
+	clock.setTimeScale(0.5f);
+	CHECK(clock.getTimeScale() == 0.5f && clock.getEffectiveScale() == 0.5f);
+
+	// һڵĲۼƵ´ƽ
+	CHECK(clock.advance(3) == 1);
+	CHECK(clock.advance(3) == 2);
+	CHECK(clock.advance(1) == 0);
+	CHECK(clock.advance(1) == 1);
+	CHECK(clock.getTime() == 4);
+
+	// ƽܺһƽͬ
+	GameClock fast;
+	fast.setTimeScale(2.75f);
+	long long total = 0;
+	for (int i = 0; i < 1000; i++)
+	{
+		total += fast.advance(17);
+	}
+	CHECK(total == 17 * 1000 * 11 / 4);
+	CHECK(fast.getTime() == total);
+
+	// űΪ 0 ʱֹͣ
+	clock.setTimeScale(-1.0f);
+	CHECK(clock.getTimeScale() == 0);
+	CHECK(clock.advance(1000) == 0);
+	CHECK(clock.getTime() == 4);
+}
+
+static void TestPause()
+{
+	GameClock clock;
+	clock.setTimeScale(2.0f);
+	clock.advance(10);
+
+	clock.setPaused(true);
+	CHECK(clock.isPaused() && clock.getEffectiveScale() == 0);
+	CHECK(clock.advance(1000) == 0);
+	CHECK(clock.getTime() == 20);
+
+	// 󱣳ԭű
+	clock.setPaused(false);
+	CHECK(clock.getEffectiveScale() == 2.0f);
+	CHECK(clock.advance(10) == 20);
+	CHECK(clock.getTime() == 40);
+}
+
+// ʱ֡ƽڵʱӸ泡ӽڵʱӸڵ
+static void TestNestedClocks()
+{
+	GameClock scene, node, child;
+	node.attach(scene.getTime());
+	child.attach(node.getTime());
+
+	node.setTimeScale(2.0f);
+	child.setTimeScale(0.5f);
+
+	for (int i = 0; i < 10; i++)
+	{
+		scene.advance(100);
+		child.follow(node.follow(scene.getTime()));
+	}
+	CHECK(scene.getTime() == 1000);
+	CHECK(node.getTime() == 2000);
+	CHECK(child.getTime() == 1000);
+
+	// ͣʱнڵ㶼ֹͣ
+	scene.setPaused(true);
+	scene.advance(100);
+	child.follow(node.follow(scene.getTime()));
+	CHECK(node.getTime() == 2000 && child.getTime() == 1000);
+	scene.setPaused(false);
+
+	// ڵͣʱӽڵҲֹͣճƽ
+	node.follow(scene.getTime());
+	node.setPaused(true);
+	scene.advance(100);
+	child.follow(node.follow(scene.getTime()));
+	CHECK(scene.getTime() == 1100);
+	CHECK(node.getTime() == 2000 && child.getTime() == 1000);
+
+	// ӵǰʱ俪ʼƽͣڼʱ䲻
+	node.setPaused(false);
+	scene.advance(100);
+	child.follow(node.follow(scene.getTime()));
+	CHECK(node.getTime() == 2200 && child.getTime() == 1100);
+
+	// ҽӵһʱʱ
+	GameClock other;
+	other.reset(50000);
+	child.attach(other.getTime());
+	CHECK(child.follow(other.getTime()) == 1100);
+	other.advance(100);
+	CHECK(child.follow(other.getTime()) == 1150);
+}
+
+// ڵֻҪʱ棬޸űǰȸһΣ֡ͬ
+static void TestLazyFollow()
+{
+	GameClock scene, eager, lazy;
+	eager.setTimeScale(0.25f);
+	lazy.setTimeScale(0.25f);
+
+	for (int i = 0; i < 100; i++)
+	{
+		scene.advance(17);
+		eager.follow(scene.getTime());
+	}
+	lazy.follow(scene.getTime());
+	eager.setTimeScale(3.0f);
+	lazy.setTimeScale(3.0f);
+
+	for (int i = 0; i < 100; i++)
+	{
+		scene.advance(17);
+		eager.follow(scene.getTime());
+	}
+	CHECK(lazy.follow(scene.getTime()) == eager.getTime());
+	CHECK(eager.getTime() == 1700 / 4 + 1700 * 3);
+
+	// ʱ䲻ʱظ治ƽ
+	CHECK(lazy.follow(scene.getTime()) == eager.getTime());
+}
+
+
+int main()
+{
+	TestAdvance();
+	TestScale();
+	TestPause();
+	TestNestedClocks();
+	TestLazyFollow();
+	return CHECK_RESULT();
+}
@@ -0,0 +1,214 @@
+#include "InputLog.h"
+#include "Check.h"
+#include <climits>
+#include <random>
+#include <vector>
+
+
+static bool SameEvent(const InputLog::Event & a, const InputLog::Event & b)
+{
+	return a.message == b.message && a.wParam == b.wParam && a.lParam == b.lParam && a.time == b.time && a.count == b.count;
+}
+
+static InputLog::Event MakeEvent(unsigned int message, unsigned long long wParam, long long lParam, long long time, unsigned int count)
+{
+	InputLog::Event event = { message, wParam, lParam, time, count };
+	return event;
+}
+
+// ֡ļ¼frames ÿ֡Ϣdeltas ÿ֡ʱƽ
+static void Record(InputLog & log, std::vector<std::vector<InputLog::Event> > & frames, std::vector<long long> & deltas)
+{
+	std::mt19937_64 rng(6);
+	log.reset(10000000);
+
+	for (int i = 0; i < 300; i++)
+	{
+		std::vector<InputLog::Event> events;
+		int count = i % 4 == 0 ? 0 : static_cast<int>(rng() % 6);
+		for (int j = 0; j < count; j++)
+		{
+			// Ϣ lParam а꣬Ϣ wParam Ϊֵ
+			long long lParam = static_cast<long long>(rng() % 0x10000) | (static_cast<long long>(rng() % 0x10000) << 16);
+			events.push_back(MakeEvent(0x200 + static_cast<unsigned int>(rng() % 16), rng() % 256, lParam, static_cast<long long>(rng() % 200000), 1 + static_cast<unsigned int>(rng() % 3)));
+		}
+		long long delta = 166667 + static_cast<long long>(rng() % 1000) - 500;
+		log.addFrame(delta, events.empty() ? nullptr : &events[0], events.size());
+		frames.push_back(events);
+		deltas.push_back(delta);
+	}
+
+	// ˵ֵ
+	std::vector<InputLog::Event> extremes;
+	extremes.push_back(MakeEvent(UINT_MAX, ULLONG_MAX, LLONG_MIN, LLONG_MAX, UINT_MAX));
+	extremes.push_back(MakeEvent(0, 0, -1, LLONG_MIN, 0));
+	log.addFrame(-12345, &extremes[0], extremes.size());
+	frames.push_back(extremes);
+	deltas.push_back(-12345);
+}
+
+static void TestRoundTrip()
+{
+	InputLog log;
+	std::vector<std::vector<InputLog::Event> > frames;
+	std::vector<long long> deltas;
+	Record(log, frames, deltas);
+	CHECK(log.getFrameCount() == frames.size());
+
+	// ͨÿϢֻռٵֽ
+	size_t eventCount = 0;
+	for (size_t i = 0; i < frames.size(); i++)
+		eventCount += frames[i].size();
+	CHECK(log.getData().size() < InputLog::HEADER_SIZE + frames.size() * 5 + eventCount * 14 + 64);
+
+	std::vector<unsigned char> data = log.getData();
+	InputLog replay;
+	CHECK(replay.load(&data[0], data.size()));
+	CHECK(replay.getFrequency() == 10000000);
+
+	long long delta;
+	std::vector<InputLog::Event> events;
+	for (size_t i = 0; i < frames.size(); i++)
+	{
+		CHECK(!replay.isEnd());
+		if (!replay.readFrame(delta, events))
+		{
+			CHECK(false);
+			return;
+		}
+		CHECK(delta == deltas[i]);
+		CHECK(events.size() == frames[i].size());
+		for (size_t j = 0; j < events.size() && j < frames[i].size(); j++)
+		{
+			CHECK(SameEvent(events[j], frames[i][j]));
+		}
+	}
+	CHECK(replay.isEnd());
+	CHECK(replay.getFrameCount() == frames.size());
+	CHECK(!replay.readFrame(delta, events) && events.empty());
+
+	// û֡ļ¼
+	InputLog empty;
+	empty.reset(1000);
+	CHECK(replay.load(&empty.getData()[0], empty.getData().size()));
+	CHECK(replay.isEnd() && replay.getFrequency() == 1000);
+}
+
+// ȡ֡سɹȡ֡𻵵֡ʱ failed Ϊ true
+static size_t ReadAll(InputLog & log, bool & failed)
+{
+	size_t frames = 0;
+	long long delta;
+	std::vector<InputLog::Event> events;
+	failed = false;
+	while (!log.isEnd())
+	{
+		if (!log.readFrame(delta, events))
+		{
+			failed = true;
+			break;
+		}
+		frames++;
+	}
+	return frames;
+}
+
+static void TestTruncated()
+{
+	InputLog log;
+	std::vector<std::vector<InputLog::Event> > frames;
+	std::vector<long long> deltas;
+	Record(log, frames, deltas);
+	const std::vector<unsigned char> & data = log.getData();
+
+	// ¼ÿ֡λ
+	std::vector<size_t> boundaries;
+	{
+		InputLog reader;
+		reader.load(&data[0], data.size());
+		long long delta;
+		std::vector<InputLog::Event> events;
+		InputLog prefix;
+		prefix.reset(log.getFrequency());
+		for (size_t i = 0; i < frames.size(); i++)
+		{
+			reader.readFrame(delta, events);
+			prefix.addFrame(delta, events.empty() ? nullptr : &events[0], events.size());
+			boundaries.push_back(prefix.getData().size());
+		}
+	}
+	CHECK(boundaries.back() == data.size());
+
+	// ļͷʱ޷ȡ
+	InputLog replay;
+	for (size_t size = 0; size < InputLog::HEADER_SIZE; size++)
+	{
+		CHECK(!replay.load(&data[0], size));
+	}
+	CHECK(!replay.load(nullptr, data.size()));
+
+	// ֡мضʱ֮ǰ֡ճȡضϵ֡ȡʧܣϢ
+	size_t frame = 0;
+	for (size_t size = InputLog::HEADER_SIZE; size < data.size(); size++)
+	{
+		while (frame < boundaries.size() && boundaries[frame] <= size)
+			frame++;
+		// ǡ֡ı߽Ͻضʱ޷֣൱ڽ϶̵ļ¼
+		bool atBoundary = size == InputLog::HEADER_SIZE || (frame > 0 && boundaries[frame - 1] == size);
+
+		CHECK(replay.load(&data[0], size));
+		bool failed;
+		size_t read = ReadAll(replay, failed);
+		if (read != frame || failed == atBoundary)
+		{
+			std::printf("log truncated to %u bytes: read %u frames, failed %d\n", (unsigned int)size, (unsigned int)read, failed);
+			CHECK(false);
+			break;
+		}
+	}
+}
+
+static void TestCorruptHeader()
+{
+	InputLog log;
+	log.reset(1000);
+	log.addFrame(1, nullptr, 0);
+	std::vector<unsigned char> data = log.getData();
+
+	InputLog replay;
+	CHECK(replay.load(&data[0], data.size()));
+
+	const size_t offsets[] = { 0, 3, 4, 5, 15 };
+	for (size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); i++)
+	{
+		std::vector<unsigned char> corrupt = data;
+		corrupt[offsets[i]] ^= 0x80;
+		CHECK(!replay.load(&corrupt[0], corrupt.size()));
+		CHECK(replay.isEnd() && replay.getFrequency() == 0);
+	}
+
+	// ƵʱΪ
+	std::vector<unsigned char> zero = data;
+	for (size_t i = 8; i < 16; i++)
+		zero[i] = 0;
+	CHECK(!replay.load(&zero[0], zero.size()));
+
+	// 䳤 64 λ
+	std::vector<unsigned char> overlong(data.begin(), data.begin() + InputLog::HEADER_SIZE);
+	overlong.insert(overlong.end(), 11, 0xFF);
+	overlong.push_back(0x01);
+	overlong.push_back(0x00);
+	CHECK(replay.load(&overlong[0], overlong.size()));
+	long long delta;
+	std::vector<InputLog::Event> events;
+	CHECK(!replay.readFrame(delta, events));
+}
+
+
+int main()
+{
+	TestRoundTrip();
+	TestTruncated();
+	TestCorruptHeader();
+	return CHECK_RESULT();
+}
@@ -0,0 +1,71 @@
+#include "easy2d.h"
+#include "Check.h"
+
+using namespace e2d;
+
+
+// ָСĽڵ
+class BoxNode :
+	public ENode
+{
+public:
+	BoxNode(float width, float height)
+	{
+		_setSize(width, height);
+	}
+};
+
+
+// ʱӵڵΧ֮ӽڵҲܱ
+static void TestChildAddedOutsideBoundingBox()
+{
+	BoxNode * parent = new BoxNode(100, 100);
+	parent->retain();
+
+	// ȼһΰΧУʹ䱻
+	CHECK(parent->isPointIn(EPoint(50, 50)));
+	CHECK(!parent->isPointIn(EPoint(250, 250)));
+
+	BoxNode * child = new BoxNode(50, 50);
+	child->setPos(200, 200);
+	parent->addChild(child);
+
+	CHECK(parent->isPointIn(EPoint(225, 225)));
+	CHECK(child->isPointIn(EPoint(225, 225)));
+	CHECK(!parent->isPointIn(EPoint(175, 175)));
+
+	// ӽڵӽڵʱͬЧ
+	BoxNode * grandChild = new BoxNode(10, 10);
+	grandChild->setPos(100, 0);
+	child->addChild(grandChild);
+	CHECK(parent->isPointIn(EPoint(305, 205)));
+
+	// ɾӽڵڸڵ
+	parent->removeChild(child);
+	CHECK(!parent->isPointIn(EPoint(225, 225)));
+
+	parent->release();
+}
+
+// ƶӽڵ󣬸ڵİΧ֮
+static void TestChildMoved()
+{
+	BoxNode * parent = new BoxNode(100, 100);
+	parent->retain();
+	BoxNode * child = new BoxNode(20, 20);
+	parent->addChild(child);
+
+	CHECK(parent->isPointIn(EPoint(10, 10)));
+	child->setPos(300, 0);
+	CHECK(parent->isPointIn(EPoint(310, 10)));
+
+	parent->release();
+}
+
+
+int main()
+{
+	TestChildAddedOutsideBoundingBox();
+	TestChildMoved();
+	return CHECK_RESULT();
+}
@@ -0,0 +1,196 @@
+#include "NumberFormat.h"
+#include "Check.h"
+#include <climits>
+#include <cmath>
+#include <chrono>
+#include <cwchar>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+//  std::to_wstring Ƚĸʽ
+static bool SameAsToWString(long long value)
+{
+	wchar_t buffer[NumberFormat::INT_BUFFER_SIZE];
+	size_t count = NumberFormat::formatInt(value, buffer);
+	return std::wstring(buffer, count) == std::to_wstring(value) && buffer[count] == 0;
+}
+
+//  swprintf Ƚϸĸʽ
+static bool SameAsSwprintf(double value, int precision)
+{
+	wchar_t expected[NumberFormat::FLOAT_BUFFER_SIZE];
+	swprintf(expected, NumberFormat::FLOAT_BUFFER_SIZE, L"%.*f", precision, value);
+
+	wchar_t buffer[NumberFormat::FLOAT_BUFFER_SIZE];
+	size_t count = NumberFormat::formatFloat(value, precision, buffer);
+	bool same = std::wstring(buffer, count) == expected && buffer[count] == 0;
+	if (!same)
+	{
+		std::printf("%.17g with %d digits: got %ls, expected %ls\n", value, precision, buffer, expected);
+	}
+	return same;
+}
+
+static void TestInts()
+{
+	const long long samples[] = {
+		0, 1, -1, 9, 10, 99, 100, -100, 12345, 2147483647LL, -2147483647LL - 1,
+		999999999999999999LL, LLONG_MAX, LLONG_MIN
+	};
+	for (size_t i = 0; i < sizeof(samples) / sizeof(samples[0]); i++)
+	{
+		CHECK(SameAsToWString(samples[i]));
+	}
+
+	std::mt19937_64 rng(1);
+	for (int i = 0; i < 100000; i++)
+	{
+		long long value = static_cast<long long>(rng());
+		// λҪǵ
+		value >>= rng() % 64;
+		CHECK(SameAsToWString(value));
+	}
+}
+
+static void TestFloats()
+{
+	const double inf = std::numeric_limits<double>::infinity();
+	const double samples[] = {
+		0.0, -0.0, 1.0, -1.0, 0.5, 1.5, 2.5, -2.5, 0.125, 0.375, 1.005, 2.675, 0.1, 0.2, 0.3,
+		3.14159265358979, -0.001, 59.999, 99.995, 1e-10, 123456789.987654321,
+		4503599627370495.5, 4503599627370496.0, 9007199254740993.0, 1e19, 9.2233720368547758e18,
+		1.8446744073709552e19, 1e30, -1e300, 1.7976931348623157e308, 5e-324, inf, -inf
+	};
+	for (size_t i = 0; i < sizeof(samples) / sizeof(samples[0]); i++)
+	{
+		for (int precision = 0; precision <= 12; precision++)
+		{
+			CHECK(SameAsSwprintf(samples[i], precision));
+		}
+	}
+
+	// Сλ swprintf 
+	CHECK(SameAsSwprintf(0.1, 20));
+	CHECK(SameAsSwprintf(-2.0 / 3.0, NumberFormat::MAX_PRECISION));
+
+	// ƽ̨ nan дֻͬ
+	wchar_t buffer[NumberFormat::FLOAT_BUFFER_SIZE];
+	size_t count = NumberFormat::formatFloat(std::nan(""), 2, buffer);
+	CHECK(count >= 3 && std::wstring(buffer, count).find(L"nan") != std::wstring::npos);
+
+	std::mt19937_64 rng(2);
+	std::uniform_real_distribution<double> mantissa(-1.0, 1.0);
+	for (int i = 0; i < 200000; i++)
+	{
+		// ǴӺСתΧĸ
+		double value = std::ldexp(mantissa(rng), static_cast<int>(rng() % 90) - 30);
+		CHECK(SameAsSwprintf(value, static_cast<int>(rng() % 10)));
+	}
+
+	// ǡмֵ
+	for (int i = -2000; i <= 2000; i++)
+	{
+		CHECK(SameAsSwprintf(i / 8.0, 2));
+		CHECK(SameAsSwprintf(i / 2.0, 0));
+	}
+}
+
+// ʱؾ΢
+class Stopwatch
+{
+public:
+	Stopwatch() : m_tStart(std::chrono::steady_clock::now()) {}
+
+	double elapsed() const
+	{
+		return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - m_tStart).count();
+	}
+
+private:
+	std::chrono::steady_clock::time_point m_tStart;
+};
+
+// ֹŻļ
+static volatile size_t s_nSink = 0;
+
+static const int FORMAT_COUNT = 100000;
+
+// ԭ EString::parse ÿֹһַ
+static std::wstring StreamInt(long long value)
+{
+	std::wostringstream ss;
+	ss << value;
+	return ss.str();
+}
+
+static std::wstring StreamFloat(double value, int precision)
+{
+	std::wostringstream ss;
+	ss << std::fixed << std::setprecision(precision) << value;
+	return ss.str();
+}
+
+// ַĽͬԸ
+static void TestAgainstStream()
+{
+	std::mt19937_64 rng(3);
+	std::vector<long long> ints(FORMAT_COUNT);
+	std::vector<double> floats(FORMAT_COUNT);
+	for (int i = 0; i < FORMAT_COUNT; i++)
+	{
+		ints[i] = static_cast<long long>(rng()) >> (rng() % 64);
+		floats[i] = std::ldexp(static_cast<double>(static_cast<long long>(rng() >> 11)), -static_cast<int>(rng() % 40));
+	}
+
+	wchar_t buffer[NumberFormat::FLOAT_BUFFER_SIZE];
+	size_t mismatches = 0;
+	for (int i = 0; i < 1000; i++)
+	{
+		size_t count = NumberFormat::formatInt(ints[i], buffer);
+		mismatches += std::wstring(buffer, count) != StreamInt(ints[i]);
+		count = NumberFormat::formatFloat(floats[i], 2, buffer);
+		mismatches += std::wstring(buffer, count) != StreamFloat(floats[i], 2);
+	}
+	CHECK(mismatches == 0);
+
+	Stopwatch intWatch;
+	for (int i = 0; i < FORMAT_COUNT; i++)
+		s_nSink += NumberFormat::formatInt(ints[i], buffer);
+	double intTime = intWatch.elapsed();
+
+	Stopwatch intStreamWatch;
+	for (int i = 0; i < FORMAT_COUNT; i++)
+		s_nSink += StreamInt(ints[i]).length();
+	double intStreamTime = intStreamWatch.elapsed();
+
+	Stopwatch floatWatch;
+	for (int i = 0; i < FORMAT_COUNT; i++)
+		s_nSink += NumberFormat::formatFloat(floats[i], 2, buffer);
+	double floatTime = floatWatch.elapsed();
+
+	Stopwatch floatStreamWatch;
+	for (int i = 0; i < FORMAT_COUNT; i++)
+		s_nSink += StreamFloat(floats[i], 2).length();
+	double floatStreamTime = floatStreamWatch.elapsed();
+
+	std::printf("%d values (us): int %.0f, int stream %.0f, float %.0f, float stream %.0f\n",
+		FORMAT_COUNT, intTime, intStreamTime, floatTime, floatStreamTime);
+
+	// ַҲڴ
+	CHECK(intTime < intStreamTime);
+	CHECK(floatTime < floatStreamTime);
+}
+
+
+int main()
+{
+	TestInts();
+	TestFloats();
+	TestAgainstStream();
+	return CHECK_RESULT();
+}
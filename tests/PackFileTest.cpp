@@ -0,0 +1,282 @@
+#include "PackFile.h"
+#include "Lz4.h"
+#include "Check.h"
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+
+// ѹٽѹԭʼͬ
+static bool Lz4RoundTrip(const std::vector<unsigned char> & data)
+{
+	std::vector<unsigned char> compressed;
+	Lz4::compress(data.empty() ? nullptr : &data[0], data.size(), compressed);
+
+	std::vector<unsigned char> decompressed(data.size() + 1, 0xCC);
+	const unsigned char * src = compressed.empty() ? nullptr : &compressed[0];
+	if (!Lz4::decompress(src, compressed.size(), &decompressed[0], data.size()))
+		return false;
+	// д dstSize ֮
+	if (decompressed[data.size()] != 0xCC)
+		return false;
+	decompressed.pop_back();
+	return decompressed == data;
+}
+
+static void TestLz4()
+{
+	std::mt19937 rng(3);
+
+	CHECK(Lz4RoundTrip(std::vector<unsigned char>()));
+	CHECK(Lz4RoundTrip(std::vector<unsigned char>(1, 'a')));
+	CHECK(Lz4RoundTrip(std::vector<unsigned char>(100000, 0)));
+
+	// ֳȵݡظݣƥص߻ϵ
+	for (size_t size = 1; size < 3000; size += 1 + size / 4)
+	{
+		std::vector<unsigned char> random(size), periodic(size), mixed(size);
+		for (size_t i = 0; i < size; i++)
+		{
+			random[i] = static_cast<unsigned char>(rng());
+			periodic[i] = static_cast<unsigned char>("abc"[i % 3]);
+			mixed[i] = (i / 64) % 2 ? random[i] : static_cast<unsigned char>(i / 64);
+		}
+		CHECK(Lz4RoundTrip(random));
+		CHECK(Lz4RoundTrip(periodic));
+		CHECK(Lz4RoundTrip(mixed));
+	}
+
+	// ظѹԱС
+	std::vector<unsigned char> text;
+	for (int i = 0; i < 1000; i++)
+	{
+		const char line[] = "image/background.png\n";
+		text.insert(text.end(), line, line + sizeof(line) - 1);
+	}
+	std::vector<unsigned char> compressed;
+	Lz4::compress(&text[0], text.size(), compressed);
+	CHECK(compressed.size() < text.size() / 10);
+
+	// ѹСݱضϡƥƫΪ 0 򳬳ʱʧ
+	std::vector<unsigned char> out(text.size() + 1);
+	CHECK(!Lz4::decompress(&compressed[0], compressed.size(), &out[0], text.size() + 1));
+	CHECK(!Lz4::decompress(&compressed[0], compressed.size(), &out[0], text.size() - 1));
+	for (size_t size = 0; size < compressed.size(); size++)
+	{
+		if (Lz4::decompress(&compressed[0], size, &out[0], text.size()))
+		{
+			std::printf("truncated LZ4 data of %u bytes accepted\n", (unsigned int)size);
+			CHECK(false);
+			break;
+		}
+	}
+	const unsigned char zeroOffset[] = { 0x10, 'a', 0x00, 0x00 };
+	CHECK(!Lz4::decompress(zeroOffset, sizeof(zeroOffset), &out[0], 5));
+	const unsigned char farOffset[] = { 0x10, 'a', 0x02, 0x00 };
+	CHECK(!Lz4::decompress(farOffset, sizeof(farOffset), &out[0], 5));
+
+	// ޸ѹʱֻʧܻõݣԽ
+	for (int i = 0; i < 2000; i++)
+	{
+		std::vector<unsigned char> corrupt = compressed;
+		corrupt[rng() % corrupt.size()] = static_cast<unsigned char>(rng());
+		Lz4::decompress(&corrupt[0], corrupt.size(), &out[0], text.size());
+	}
+}
+
+
+// õԴ
+struct PackContent
+{
+	std::vector<std::string> names;
+	std::vector<std::vector<unsigned char> > data;
+	std::vector<unsigned char> file;
+	PackFile::View view;
+};
+
+static bool BuildPack(PackContent & pack, size_t count)
+{
+	std::mt19937 rng(4);
+	for (size_t i = 0; i < count; i++)
+	{
+		char name[64];
+		std::snprintf(name, sizeof(name), "Images\\Level%u/Tile%u.png", (unsigned int)(i % 7), (unsigned int)i);
+		pack.names.push_back(name);
+
+		// һļѹһݣһΪ
+		std::vector<unsigned char> data(i % 5 == 4 ? 0 : 100 + i * 13);
+		for (size_t j = 0; j < data.size(); j++)
+		{
+			data[j] = i % 2 ? static_cast<unsigned char>(rng()) : static_cast<unsigned char>(j / 16);
+		}
+		pack.data.push_back(data);
+	}
+
+	std::vector<PackFile::Input> inputs;
+	for (size_t i = 0; i < count; i++)
+	{
+		PackFile::Input input;
+		input.name = pack.names[i];
+		input.data = pack.data[i].empty() ? nullptr : &pack.data[i][0];
+		input.size = pack.data[i].size();
+		input.compress = true;
+		inputs.push_back(input);
+	}
+
+	return PackFile::build(inputs, pack.file) && PackFile::parse(&pack.file[0], pack.file.size(), pack.view);
+}
+
+// ļȡ
+static bool Extract(const PackContent & pack, const char * name, std::vector<unsigned char> & data)
+{
+	PackFile::Entry entry;
+	if (!PackFile::find(pack.view, name, entry))
+		return false;
+	if (PackFile::getData(pack.view, entry) - pack.view.file != (long long)entry.offset || entry.offset % PackFile::ALIGNMENT != 0)
+		return false;
+
+	data.assign(size_t(entry.size), 0);
+	return PackFile::extract(pack.view, entry, data.empty() ? nullptr : &data[0], data.size());
+}
+
+static void TestPackLookup()
+{
+	PackContent pack;
+	CHECK(BuildPack(pack, 200));
+	CHECK(pack.view.entryCount == 200);
+
+	bool anyCompressed = false;
+	for (unsigned int i = 0; i < pack.view.entryCount; i++)
+	{
+		PackFile::Entry entry;
+		CHECK(PackFile::getEntry(pack.view, i, entry));
+		anyCompressed = anyCompressed || PackFile::isCompressed(entry);
+	}
+	CHECK(anyCompressed);
+
+	PackFile::Entry entry;
+	CHECK(!PackFile::getEntry(pack.view, pack.view.entryCount, entry));
+
+	for (size_t i = 0; i < pack.names.size(); i++)
+	{
+		std::vector<unsigned char> data;
+		if (!Extract(pack, pack.names[i].c_str(), data) || data != pack.data[i])
+		{
+			std::printf("lookup of %s failed\n", pack.names[i].c_str());
+			CHECK(false);
+		}
+	}
+
+	// ƲִСд'\'  '/' ͬԿͷ "./"  "/"
+	std::vector<unsigned char> data;
+	CHECK(Extract(pack, "images/level1/tile1.png", data) && data == pack.data[1]);
+	CHECK(Extract(pack, "./IMAGES\\LEVEL2\\TILE2.PNG", data) && data == pack.data[2]);
+	CHECK(Extract(pack, "/Images/Level3/Tile3.png", data) && data == pack.data[3]);
+	CHECK(PackFile::normalizeName(".\\Images\\a.png") == "Images/a.png");
+	CHECK(PackFile::hashName("A/B", 3) == PackFile::hashName("./a\\b", 5));
+
+	CHECK(!PackFile::find(pack.view, "Images/Level1/Tile2.png", entry));
+	CHECK(!PackFile::find(pack.view, "Images/Level1/Tile1.pn", entry));
+	CHECK(!PackFile::find(pack.view, "", entry));
+	CHECK(!PackFile::find(pack.view, nullptr, entry));
+
+	// յԴɺͽ
+	PackContent empty;
+	CHECK(BuildPack(empty, 0));
+	CHECK(empty.view.entryCount == 0 && !PackFile::find(empty.view, "a", entry));
+}
+
+static void TestPackBuildErrors()
+{
+	std::vector<unsigned char> file;
+	std::vector<PackFile::Input> inputs(2);
+	inputs[0].name = "a.txt";
+	inputs[0].data = "a";
+	inputs[0].size = 1;
+	inputs[0].compress = false;
+	inputs[1] = inputs[0];
+
+	// 淶ļ
+	inputs[1].name = "./A.TXT";
+	CHECK(!PackFile::build(inputs, file));
+	// ļ
+	inputs[1].name = "/";
+	CHECK(!PackFile::build(inputs, file));
+	inputs[1].name = "b.txt";
+	CHECK(PackFile::build(inputs, file));
+}
+
+// ޸ԴеһݺӦʧ
+static bool RejectsPatched(std::vector<unsigned char> file, size_t offset, unsigned long long value, size_t bytes)
+{
+	for (size_t i = 0; i < bytes; i++)
+	{
+		file[offset + i] = static_cast<unsigned char>(value >> (i * 8));
+	}
+	PackFile::View view;
+	return !PackFile::parse(&file[0], file.size(), view);
+}
+
+static void TestCorruptPacks()
+{
+	PackContent pack;
+	CHECK(BuildPack(pack, 6));
+	const std::vector<unsigned char> & file = pack.file;
+
+	// ضϵԴ
+	for (size_t size = 0; size < file.size(); size++)
+	{
+		PackFile::View view;
+		if (PackFile::parse(&file[0], size, view))
+		{
+			std::printf("truncated pack of %u bytes accepted\n", (unsigned int)size);
+			CHECK(false);
+			break;
+		}
+	}
+
+	const size_t entry = PackFile::HEADER_SIZE;
+	const size_t second = entry + PackFile::ENTRY_SIZE;
+	CHECK(RejectsPatched(file, 0, 0x50443246, 4));					/* ļʶ */
+	CHECK(RejectsPatched(file, 4, 2, 2));							/* 汾 */
+	CHECK(RejectsPatched(file, 8, 0x10000000, 4));					/* Ŀļ */
+	CHECK(RejectsPatched(file, 12, entry, 4));						/* ƱĿ¼ص */
+	CHECK(RejectsPatched(file, 16, 0x7FFFFFFF, 4));					/* Ʊļ */
+	CHECK(RejectsPatched(file, entry, 12345, 8));					/* ϣֵƲ */
+	CHECK(RejectsPatched(file, entry + 8, file.size() + 16, 8));	/* ƫƳļ */
+	CHECK(RejectsPatched(file, entry + 8, 0, 8));					/* ƫλĿ¼ */
+	CHECK(RejectsPatched(file, entry + 16, file.size(), 8));		/* ݴСļ */
+	CHECK(RejectsPatched(file, entry + 32, 0x7FFFFFFF, 4));			/* ƳƱ */
+	CHECK(RejectsPatched(file, entry + 36, 0xFFFF, 2));				/* ƳȳƱ */
+
+	// δѹĿ洢СļСͬƫƱ
+	PackFile::Entry first;
+	CHECK(PackFile::getEntry(pack.view, 0, first));
+	size_t stored = (size_t)first.storedSize;
+	if (!PackFile::isCompressed(first))
+	{
+		CHECK(RejectsPatched(file, entry + 24, stored + 1, 8));
+	}
+	CHECK(RejectsPatched(file, entry + 8, first.offset + 1, 8));
+
+	// Ŀ˳ʱֲһʧЧҲҪܾ
+	std::vector<unsigned char> swapped = file;
+	std::swap_ranges(swapped.begin() + entry, swapped.begin() + second, swapped.begin() + second);
+	PackFile::View view;
+	CHECK(!PackFile::parse(&swapped[0], swapped.size(), view));
+
+	// ѹСʱȡʧ
+	std::vector<unsigned char> data(size_t(first.size) + 1);
+	CHECK(!PackFile::extract(pack.view, first, &data[0], data.size()));
+}
+
+
+int main()
+{
+	TestLz4();
+	TestPackLookup();
+	TestPackBuildErrors();
+	TestCorruptPacks();
+	return CHECK_RESULT();
+}
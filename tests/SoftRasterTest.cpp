@@ -0,0 +1,264 @@
+#include "SoftRaster.h"
+#include "Check.h"
+#include <random>
+#include <vector>
+
+//  SOFTRASTER_NO_SSE2 ʱصʵ֣ SSE2 ʵ
+// ߶水ĽȽϣ˽ȫͬ
+
+
+// һأdst = src * op / 256 + dst * (255 - srcAlpha * op / 256) / 255룩
+static unsigned int ReferenceBlend(unsigned int d, unsigned int s, unsigned int op)
+{
+	unsigned int a = ((s >> 24) * op) >> 8;
+	unsigned int result = 0;
+	for (int shift = 0; shift < 32; shift += 8)
+	{
+		unsigned int sc = (((s >> shift) & 0xFF) * op) >> 8;
+		unsigned int dc = (((d >> shift) & 0xFF) * (255 - a) + 127) / 255;
+		unsigned int c = sc + dc;
+		result |= (c > 255 ? 255 : c) << shift;
+	}
+	return result;
+}
+
+static unsigned int Pixel(const SoftRaster & raster, int x, int y)
+{
+	return raster.getPixels()[y * raster.getWidth() + x];
+}
+
+//  [left, right) x [top, bottom) ڵΪ insideΪ outside
+static bool RegionIs(const SoftRaster & raster, int left, int top, int right, int bottom, unsigned int inside, unsigned int outside)
+{
+	for (int y = 0; y < raster.getHeight(); y++)
+	{
+		for (int x = 0; x < raster.getWidth(); x++)
+		{
+			bool in = x >= left && x < right && y >= top && y < bottom;
+			if (Pixel(raster, x, y) != (in ? inside : outside))
+			{
+				std::printf("pixel (%d, %d) is %08X\n", x, y, Pixel(raster, x, y));
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+
+static void TestPremultiply()
+{
+	CHECK(SoftRaster::premultiply(0xFF8040, 1.0f) == 0xFFFF8040);
+	CHECK(SoftRaster::premultiply(0xFF8040, 0.5f) == 0x80804020);
+	CHECK(SoftRaster::premultiply(0xFF8040, 0.0f) == 0x00000000);
+	CHECK(SoftRaster::premultiply(0xFFFFFF, 2.0f) == 0xFFFFFFFF);
+}
+
+static void TestFill()
+{
+	const unsigned int black = 0xFF000000;
+	const unsigned int red = 0xFFFF0000;
+
+	SoftRaster raster;
+	raster.resize(13, 6);
+	CHECK(raster.getWidth() == 13 && raster.getHeight() == 6);
+	CHECK(RegionIs(raster, 0, 0, 0, 0, 0, 0));
+
+	raster.clear(black);
+	raster.fillRect(2, 1, 11, 4, red);
+	CHECK(RegionIs(raster, 2, 1, 11, 4, red, black));
+
+	// ͸ɫ뱳ϣ 13 ͬʱÿ 4 صĲֺʣ
+	const unsigned int white = 0xFFFFFFFF;
+	const unsigned int blue = SoftRaster::premultiply(0x0000FF, 0.5f);
+	raster.clear(white);
+	raster.fillRect(0, 0, 13, 6, blue);
+	CHECK(blue == 0x80000080);
+	CHECK(RegionIs(raster, 0, 0, 13, 6, 0xFF7F7FFF, 0));
+	CHECK(ReferenceBlend(white, blue, 256) == 0xFF7F7FFF);
+
+	// ֻ޸Ĳüڵ
+	raster.clear(black);
+	raster.setClip(3, 2, 7, 100);
+	raster.fillRect(0, 0, 13, 6, red);
+	raster.resetClip();
+	CHECK(RegionIs(raster, 3, 2, 7, 6, red, black));
+
+	raster.clear(black);
+	raster.setClip(3, 2, 7, 5);
+	raster.clear(red);
+	raster.resetClip();
+	CHECK(RegionIs(raster, 3, 2, 7, 5, red, black));
+
+	// ȫ͸ɫͿվβ
+	raster.clear(black);
+	raster.fillRect(0, 0, 13, 6, 0);
+	raster.fillRect(5, 5, 5, 6, red);
+	raster.fillRect(6, 3, 2, 4, red);
+	CHECK(RegionIs(raster, 0, 0, 0, 0, 0, black));
+}
+
+static void TestLine()
+{
+	const unsigned int green = 0xFF00FF00;
+
+	SoftRaster raster;
+	raster.resize(8, 8);
+	raster.drawLine(1, 2.5f, 6, 2.5f, green);
+	CHECK(RegionIs(raster, 1, 2, 7, 3, green, 0));
+
+	raster.resize(8, 8);
+	raster.drawLine(4.5f, 0, 4.5f, 20, green);
+	CHECK(RegionIs(raster, 4, 0, 5, 8, green, 0));
+
+	// Խϵÿһǡһ
+	raster.resize(8, 8);
+	raster.drawLine(0.5f, 0.5f, 7.5f, 7.5f, green);
+	for (int i = 0; i < 8; i++)
+	{
+		CHECK(Pixel(raster, i, i) == green);
+	}
+	const unsigned int * pixels = raster.getPixels();
+	size_t set = 0;
+	for (int i = 0; i < 64; i++)
+	{
+		set += pixels[i] != 0;
+	}
+	CHECK(set == 8);
+}
+
+static void TestTransform()
+{
+	const unsigned int red = 0xFFFF0000;
+
+	// ת 90 Ȳƽƣx' = 4 - yy' = x
+	SoftRaster raster;
+	raster.resize(6, 6);
+	const float rotate[6] = { 0, 1, -1, 0, 4, 0 };
+	raster.setTransform(rotate);
+	raster.fillRect(0, 0, 2, 1, red);
+	CHECK(RegionIs(raster, 3, 0, 4, 2, red, 0));
+
+	// ı任
+	raster.resize(6, 6);
+	const float flat[6] = { 1, 0, 0, 0, 0, 0 };
+	raster.setTransform(flat);
+	raster.fillRect(0, 0, 6, 6, red);
+	CHECK(RegionIs(raster, 0, 0, 0, 0, 0, 0));
+
+	// Ŵ 2x2 ͼ
+	const unsigned int source[4] = { 0xFF000001, 0xFF000002, 0xFF000003, 0xFF000004 };
+	SoftRaster::Image image = { source, 2, 2, 2 };
+	const float dest[4] = { 0, 0, 2, 2 };
+	const float src[4] = { 0, 0, 2, 2 };
+	const float scale[6] = { 2, 0, 0, 2, 1, 1 };
+	raster.resize(6, 6);
+	raster.setTransform(scale);
+	raster.drawImage(image, dest, src, 1.0f);
+	for (int y = 0; y < 6; y++)
+	{
+		for (int x = 0; x < 6; x++)
+		{
+			bool in = x >= 1 && x < 5 && y >= 1 && y < 5;
+			unsigned int expected = in ? source[((y - 1) / 2) * 2 + (x - 1) / 2] : 0;
+			CHECK(Pixel(raster, x, y) == expected);
+		}
+	}
+}
+
+// Դͼͻ棬ÿϽ붨ͬ
+static void TestBlendMatchesReference()
+{
+	std::mt19937 rng(5);
+	const int width = 37;
+	const int height = 9;
+
+	std::vector<unsigned int> source(width * height);
+	for (size_t i = 0; i < source.size(); i++)
+	{
+		// Ԥ alpha أɫͨ alpha
+		unsigned int a = rng() % 4 == 0 ? (rng() % 2) * 255 : rng() % 256;
+		unsigned int pixel = a << 24;
+		for (int shift = 0; shift < 24; shift += 8)
+			pixel |= (a ? rng() % (a + 1) : 0) << shift;
+		source[i] = pixel;
+	}
+	SoftRaster::Image image = { &source[0], width, height, width };
+
+	const float opacities[] = { 1.0f, 0.75f, 0.5f, 0.2f, 1.0f / 256 };
+	for (size_t k = 0; k < sizeof(opacities) / sizeof(opacities[0]); k++)
+	{
+		SoftRaster raster;
+		raster.resize(width, height);
+		std::vector<unsigned int> background(width * height);
+		for (size_t i = 0; i < background.size(); i++)
+		{
+			background[i] = rng();
+			background[i] |= 0xFF000000;
+		}
+		for (int y = 0; y < height; y++)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				raster.setClip(x, y, x + 1, y + 1);
+				raster.clear(background[y * width + x]);
+			}
+		}
+		raster.resetClip();
+
+		// ƽأÿеԴ
+		const float dest[4] = { 0, 0, float(width), float(height) };
+		const float src[4] = { 0, 0, float(width), float(height) };
+		raster.drawImage(image, dest, src, opacities[k]);
+
+		unsigned int op = static_cast<unsigned int>(opacities[k] * 256 + 0.5f);
+		size_t mismatches = 0;
+		for (size_t i = 0; i < source.size(); i++)
+		{
+			mismatches += raster.getPixels()[i] != ReferenceBlend(background[i], source[i], op);
+		}
+		CHECK(mismatches == 0);
+
+		// ͬһɫϵһ
+		unsigned int color = SoftRaster::premultiply(rng() & 0xFFFFFF, opacities[k] * 0.9f);
+		std::vector<unsigned int> before(raster.getPixels(), raster.getPixels() + source.size());
+		raster.fillRect(0, 0, float(width), float(height), color);
+		mismatches = 0;
+		for (size_t i = 0; i < source.size(); i++)
+		{
+			mismatches += raster.getPixels()[i] != ReferenceBlend(before[i], color, 256);
+		}
+		CHECK(mismatches == 0);
+	}
+}
+
+static void TestCompare()
+{
+	const unsigned int a[7] = { 0xFF000000, 0xFF101010, 0x80808080, 0, 0x01020304, 0xFFFFFFFF, 0x10203040 };
+	unsigned int b[7];
+	for (int i = 0; i < 7; i++)
+		b[i] = a[i];
+
+	CHECK(SoftRaster::compare(a, b, 7, 0) == 0);
+
+	b[1] = 0xFF101013;	/*  3 */
+	b[5] = 0xFFFFF0FF;	/*  15 */
+	b[6] = 0x10203041;	/*  1λʣ */
+	CHECK(SoftRaster::compare(a, b, 7, 0) == 3);
+	CHECK(SoftRaster::compare(a, b, 7, 2) == 2);
+	CHECK(SoftRaster::compare(a, b, 7, 3) == 1);
+	CHECK(SoftRaster::compare(a, b, 7, 15) == 0);
+	CHECK(SoftRaster::compare(a, b, 4, 0) == 1);
+}
+
+
+int main()
+{
+	TestPremultiply();
+	TestFill();
+	TestLine();
+	TestTransform();
+	TestBlendMatchesReference();
+	TestCompare();
+	return CHECK_RESULT();
+}
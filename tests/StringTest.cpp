@@ -0,0 +1,147 @@
+#include "easy2d.h"
+#include "Check.h"
+#include <chrono>
+#include <utility>
+#include <vector>
+
+using namespace e2d;
+
+
+// ʱؾ΢
+class Stopwatch
+{
+public:
+	Stopwatch() : m_tStart(std::chrono::steady_clock::now()) {}
+
+	double elapsed() const
+	{
+		return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - m_tStart).count();
+	}
+
+private:
+	std::chrono::steady_clock::time_point m_tStart;
+};
+
+// ֹŻļ
+static volatile int s_nSink = 0;
+
+static const int COPY_COUNT = 200000;
+
+
+//  COUNT ַغʱ΢룩
+static double TimeCopy(const EString & source)
+{
+	std::vector<EString> copies(64);
+	Stopwatch watch;
+	for (int i = 0; i < COPY_COUNT; i++)
+	{
+		EString & target = copies[i & 63];
+		target = source;
+		s_nSink += target.length();
+	}
+	return watch.elapsed();
+}
+
+// ַ֮ƶ COUNT Σغʱ΢룩
+static double TimeMove(const EString & source)
+{
+	EString a(source), b;
+	Stopwatch watch;
+	for (int i = 0; i < COPY_COUNT / 2; i++)
+	{
+		b = std::move(a);
+		a = std::move(b);
+		s_nSink += a.length();
+	}
+	double time = watch.elapsed();
+	CHECK(a == source && b.isEmpty());
+	return time;
+}
+
+// ַ COUNT ΣÿζҪغʱ΢룩
+static double TimeConstruct(const EString & source)
+{
+	Stopwatch watch;
+	for (int i = 0; i < COPY_COUNT; i++)
+	{
+		EString copy(source);
+		s_nSink += copy.length();
+	}
+	return watch.elapsed();
+}
+
+
+// ַڶڲƶԭַΪ
+static void TestShortStrings()
+{
+	EString empty;
+	CHECK(empty.isEmpty() && empty.length() == 0 && empty.capacity() >= 15);
+
+	EString shortText(L"short name");
+	EString longText(L"a string that is too long to be stored inside the object");
+	CHECK(shortText.capacity() == 15);
+	CHECK(longText.capacity() >= longText.length());
+
+	EString copy(shortText);
+	CHECK(copy == shortText && (const wchar_t *)copy != (const wchar_t *)shortText);
+
+	// ַƶʱתȨַƵ¶ڲ
+	const wchar_t * buffer = longText;
+	EString moved(std::move(longText));
+	CHECK((const wchar_t *)moved == buffer && longText.isEmpty());
+
+	EString movedShort(std::move(copy));
+	CHECK(movedShort == L"short name" && copy.isEmpty());
+
+	// ƶֵ߶Լʹ
+	copy = std::move(movedShort);
+	movedShort += L"!";
+	CHECK(copy == L"short name" && movedShort == L"!");
+
+	//  vector ʱַ
+	std::vector<EString> strings;
+	for (int i = 0; i < 100; i++)
+	{
+		strings.push_back(i % 2 ? shortText : moved);
+	}
+	for (int i = 0; i < 100; i++)
+	{
+		CHECK(strings[i] == (i % 2 ? shortText : moved));
+	}
+}
+
+// ַĸƺƶڴ棬ӦԿҪڴĳַ
+static void TestCopyAndMoveTiming()
+{
+	EString shortText(L"node_name_01");
+	EString longText(L"a string that is too long to be stored inside the object");
+
+	// Ԥ
+	TimeCopy(shortText);
+	TimeConstruct(longText);
+
+	double shortCopy = TimeCopy(shortText);
+	double shortConstruct = TimeConstruct(shortText);
+	double shortMove = TimeMove(shortText);
+	double longCopy = TimeCopy(longText);
+	double longConstruct = TimeConstruct(longText);
+	double longMove = TimeMove(longText);
+
+	std::printf("%d operations (us): short copy %.0f, short construct %.0f, short move %.0f, "
+		"long copy %.0f, long construct %.0f, long move %.0f\n",
+		COPY_COUNT, shortCopy, shortConstruct, shortMove, longCopy, longConstruct, longMove);
+
+	// ַĹÿζҪڴ棬ַĹ졢ƺƶҪ
+	CHECK(shortConstruct < longConstruct);
+	CHECK(shortMove < longConstruct);
+	// ַƶֻתָ
+	CHECK(longMove < longConstruct);
+}
+
+
+int main()
+{
+	TestShortStrings();
+	TestCopyAndMoveTiming();
+	return CHECK_RESULT();
+}
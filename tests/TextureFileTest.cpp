@@ -0,0 +1,162 @@
+#include "TextureFile.h"
+#include "Check.h"
+#include <cstring>
+#include <random>
+#include <vector>
+
+
+//  BGRA أnoisy Ϊ false ʱѹĽ䣬Ϊ true ʱ
+static std::vector<unsigned char> MakePixels(unsigned int width, unsigned int height, unsigned int stride, bool noisy)
+{
+	std::vector<unsigned char> pixels(size_t(stride) * height);
+	std::mt19937 rng(width * 31 + height);
+	for (unsigned int y = 0; y < height; y++)
+	{
+		for (unsigned int x = 0; x < stride; x++)
+		{
+			pixels[size_t(y) * stride + x] = noisy ? static_cast<unsigned char>(rng()) : static_cast<unsigned char>((x / 4 + y) & 0xFF);
+		}
+	}
+	return pixels;
+}
+
+// ٽ룬ļͷ֡ͬ
+static bool RoundTrip(unsigned int width, unsigned int height, unsigned int stride, bool noisy, bool compress, bool expectCompressed)
+{
+	std::vector<unsigned char> pixels = MakePixels(width, height, stride, noisy);
+	std::vector<TextureFile::Frame> frames;
+	TextureFile::Frame frame = { 0, 0, width, height };
+	frames.push_back(frame);
+	TextureFile::Frame corner = { width / 2, height / 2, width - width / 2, height - height / 2 };
+	frames.push_back(corner);
+
+	std::vector<unsigned char> file;
+	if (!TextureFile::encode(width, height, stride, &pixels[0], frames, compress, file))
+		return false;
+
+	TextureFile::View view;
+	if (!TextureFile::isTextureFile(&file[0], file.size()) || !TextureFile::parse(&file[0], file.size(), view))
+		return false;
+
+	if (view.header.width != width || view.header.height != height || view.header.stride != stride)
+		return false;
+	if (view.header.dataOffset % 16 != 0)
+		return false;
+	if (TextureFile::isCompressed(view) != expectCompressed)
+		return false;
+	if (view.frames.size() != frames.size())
+		return false;
+	for (size_t i = 0; i < frames.size(); i++)
+	{
+		if (memcmp(&view.frames[i], &frames[i], sizeof(TextureFile::Frame)) != 0)
+			return false;
+	}
+
+	std::vector<unsigned char> decoded(TextureFile::getPixelSize(view));
+	if (decoded.size() != pixels.size() || !TextureFile::decode(view, &decoded[0], decoded.size()))
+		return false;
+	return decoded == pixels;
+}
+
+static void TestRoundTrip()
+{
+	// ͼƬѹСΪ LZ4 
+	CHECK(RoundTrip(64, 64, 256, false, true, true));
+	CHECK(RoundTrip(37, 11, 160, false, true, true));
+	// δҪѹѹûбСݱΪԭʼ
+	CHECK(RoundTrip(64, 64, 256, false, false, false));
+	CHECK(RoundTrip(64, 64, 256, true, true, false));
+	CHECK(RoundTrip(1, 1, 4, false, true, false));
+}
+
+static void TestInvalidInput()
+{
+	std::vector<unsigned char> pixels = MakePixels(8, 8, 32, false);
+	std::vector<TextureFile::Frame> frames;
+	std::vector<unsigned char> file;
+
+	// ߴΪ 0пͳͼƬ֡޷
+	CHECK(!TextureFile::encode(0, 8, 32, &pixels[0], frames, false, file));
+	CHECK(!TextureFile::encode(8, 8, 28, &pixels[0], frames, false, file));
+	CHECK(!TextureFile::encode(8, 8, 32, nullptr, frames, false, file));
+	TextureFile::Frame outside = { 4, 4, 5, 1 };
+	frames.push_back(outside);
+	CHECK(!TextureFile::encode(8, 8, 32, &pixels[0], frames, false, file));
+}
+
+// ޸ļеһ 32 λֵӦʧ
+static bool RejectsPatched(std::vector<unsigned char> file, size_t offset, unsigned int value)
+{
+	file[offset] = (unsigned char)(value);
+	file[offset + 1] = (unsigned char)(value >> 8);
+	file[offset + 2] = (unsigned char)(value >> 16);
+	file[offset + 3] = (unsigned char)(value >> 24);
+
+	TextureFile::View view;
+	return !TextureFile::parse(&file[0], file.size(), view);
+}
+
+static void TestCorruptFiles()
+{
+	for (int compress = 0; compress <= 1; compress++)
+	{
+		std::vector<unsigned char> pixels = MakePixels(16, 16, 64, false);
+		std::vector<TextureFile::Frame> frames;
+		TextureFile::Frame frame = { 2, 2, 8, 8 };
+		frames.push_back(frame);
+
+		std::vector<unsigned char> file;
+		CHECK(TextureFile::encode(16, 16, 64, &pixels[0], frames, compress != 0, file));
+
+		TextureFile::View view;
+		CHECK(TextureFile::parse(&file[0], file.size(), view));
+
+		// ضϵļ
+		for (size_t size = 0; size < file.size(); size++)
+		{
+			if (TextureFile::parse(&file[0], size, view))
+			{
+				std::printf("truncated file of %u bytes accepted\n", (unsigned int)size);
+				CHECK(false);
+				break;
+			}
+		}
+
+		CHECK(RejectsPatched(file, 0, 0x54443246));		/* ļʶ */
+		CHECK(RejectsPatched(file, 4, 0x00000002));		/* 汾ţͬʱѹ */
+		CHECK(RejectsPatched(file, 8, 0));				/* Ϊ 0 */
+		CHECK(RejectsPatched(file, 8, 17));				/* ȳп */
+		CHECK(RejectsPatched(file, 12, 0));				/* ߶Ϊ 0 */
+		CHECK(RejectsPatched(file, 20, 0x10000000));	/* ֡ļ */
+		CHECK(RejectsPatched(file, 24, 16));			/* ֡ص */
+		CHECK(RejectsPatched(file, 28, 0xFFFFFFF0));	/* ݳļ */
+		CHECK(RejectsPatched(file, 32 + 8, 15));		/* ֡ͼƬ */
+		if (!compress)
+		{
+			CHECK(RejectsPatched(file, 28, (unsigned int)(file.size() - 49)));	/* ݴСߴ粻 */
+		}
+
+		// ʱСͬ
+		std::vector<unsigned char> decoded(TextureFile::getPixelSize(view) + 1);
+		CHECK(!TextureFile::decode(view, &decoded[0], decoded.size()));
+	}
+
+	// ѹݱضʱʧܣԽ
+	std::vector<unsigned char> pixels = MakePixels(32, 32, 128, false);
+	std::vector<unsigned char> file;
+	CHECK(TextureFile::encode(32, 32, 128, &pixels[0], std::vector<TextureFile::Frame>(), true, file));
+	TextureFile::View view;
+	CHECK(TextureFile::parse(&file[0], file.size(), view) && TextureFile::isCompressed(view));
+	std::vector<unsigned char> decoded(TextureFile::getPixelSize(view));
+	view.header.dataSize -= 1;
+	CHECK(!TextureFile::decode(view, &decoded[0], decoded.size()));
+}
+
+
+int main()
+{
+	TestRoundTrip();
+	TestInvalidInput();
+	TestCorruptFiles();
+	return CHECK_RESULT();
+}
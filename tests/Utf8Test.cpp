@@ -0,0 +1,253 @@
+#include "Utf8.h"
+#include "Check.h"
+#include <cstring>
+#include <string>
+#include <vector>
+
+// ļʹ wcslen ȿַ⺯Աͬʱ 16 λ wchar_t-fshort-wchar
+typedef std::vector<unsigned int> Units;
+
+static const unsigned int FFFD = 0xFFFD;
+
+
+// һַΪĲ
+static std::string ReferenceEncode(unsigned int code)
+{
+	std::string out;
+	if (code < 0x80)
+	{
+		out += static_cast<char>(code);
+	}
+	else if (code < 0x800)
+	{
+		out += static_cast<char>(0xC0 | (code >> 6));
+		out += static_cast<char>(0x80 | (code & 0x3F));
+	}
+	else if (code < 0x10000)
+	{
+		out += static_cast<char>(0xE0 | (code >> 12));
+		out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+		out += static_cast<char>(0x80 | (code & 0x3F));
+	}
+	else
+	{
+		out += static_cast<char>(0xF0 | (code >> 18));
+		out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+		out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+		out += static_cast<char>(0x80 | (code & 0x3F));
+	}
+	return out;
+}
+
+// һַӦĿַwchar_t Ϊ 16 λʱ BMP ַΪ
+static void AppendUnits(Units & units, unsigned int code)
+{
+	if (sizeof(wchar_t) == 2 && code >= 0x10000)
+	{
+		units.push_back(0xD800 + ((code - 0x10000) >> 10));
+		units.push_back(0xDC00 + ((code - 0x10000) & 0x3FF));
+	}
+	else
+	{
+		units.push_back(code);
+	}
+}
+
+static std::vector<wchar_t> ToWide(const Units & units)
+{
+	std::vector<wchar_t> wide;
+	for (size_t i = 0; i < units.size(); i++)
+	{
+		wide.push_back(static_cast<wchar_t>(units[i]));
+	}
+	return wide;
+}
+
+// 룬ûд decode ŵ srcSize  wchar_t ֮
+static Units Decode(const std::string & src)
+{
+	const wchar_t guard = static_cast<wchar_t>(0x5A5A);
+	std::vector<wchar_t> buffer(src.size() + 1, guard);
+	size_t count = Utf8::decode(src.data(), src.size(), buffer.data());
+	CHECK(count <= src.size());
+	CHECK(buffer[src.size()] == guard);
+
+	Units units;
+	for (size_t i = 0; i < count; i++)
+	{
+		unsigned int unit = static_cast<unsigned int>(buffer[i]);
+		units.push_back(sizeof(wchar_t) == 2 ? (unit & 0xFFFF) : unit);
+	}
+	return units;
+}
+
+// 룬 maxEncodedSize
+static std::string Encode(const Units & units)
+{
+	std::vector<wchar_t> wide = ToWide(units);
+	size_t maxSize = Utf8::maxEncodedSize(wide.size());
+	std::string buffer(maxSize + 1, '\x5A');
+	size_t count = Utf8::encode(wide.data(), wide.size(), &buffer[0]);
+	CHECK(count <= maxSize);
+	CHECK(buffer[maxSize] == '\x5A');
+	return buffer.substr(0, count);
+}
+
+// ЧеĽȷ isValid ܾ
+static bool DecodesInvalid(const std::string & src, const Units & expected)
+{
+	return Decode(src) == expected && !Utf8::isValid(src.data(), src.size());
+}
+
+
+// еЧַ롢󱣳ֲ
+static void TestRoundTripAllCodePoints()
+{
+	Units all;
+	std::string allBytes;
+	for (unsigned int code = 1; code <= 0x10FFFF; code++)
+	{
+		if (code >= 0xD800 && code <= 0xDFFF)
+			continue;
+
+		Units units;
+		AppendUnits(units, code);
+		std::string bytes = ReferenceEncode(code);
+		if (Encode(units) != bytes || Decode(bytes) != units || !Utf8::isValid(bytes.data(), bytes.size()))
+		{
+			std::printf("round trip failed at U+%04X\n", code);
+			CHECK(false);
+			return;
+		}
+		all.insert(all.end(), units.begin(), units.end());
+		allBytes += bytes;
+	}
+
+	// תʱ ASCII Ŀ·ַĴ
+	CHECK(Encode(all) == allBytes);
+	CHECK(Decode(allBytes) == all);
+	CHECK(Utf8::isValid(allBytes.data(), allBytes.size()));
+}
+
+static void TestKnownSequences()
+{
+	CHECK(Decode("") == Units());
+	CHECK(Decode("A") == Units(1, 'A'));
+	CHECK(Decode("\xC3\xA9") == Units(1, 0xE9));
+	CHECK(Decode("\xE4\xB8\xAD\xE6\x96\x87") == Units({ 0x4E2D, 0x6587 }));
+
+	Units emoji;
+	AppendUnits(emoji, 0x1F600);
+	CHECK(Decode("\xF0\x9F\x98\x80") == emoji);
+	CHECK(Encode(emoji) == "\xF0\x9F\x98\x80");
+	CHECK(emoji.size() == (sizeof(wchar_t) == 2 ? 2u : 1u));
+
+	Units last;
+	AppendUnits(last, 0x10FFFF);
+	CHECK(Decode("\xF4\x8F\xBF\xBF") == last);
+}
+
+// ЧаЧǰ׺滻Ϊ U+FFFD
+static void TestInvalidSequences()
+{
+	// ĺֽںͲֵֽܳ
+	CHECK(DecodesInvalid("\x80", Units({ FFFD })));
+	CHECK(DecodesInvalid("\xBF" "A", Units({ FFFD, 'A' })));
+	CHECK(DecodesInvalid("\xFE\xFF", Units({ FFFD, FFFD })));
+	CHECK(DecodesInvalid("\xF5\x80\x80\x80", Units({ FFFD, FFFD, FFFD, FFFD })));
+
+	// 
+	CHECK(DecodesInvalid("\xC0\xAF", Units({ FFFD, FFFD })));
+	CHECK(DecodesInvalid("\xC1\xBF", Units({ FFFD, FFFD })));
+	CHECK(DecodesInvalid("\xE0\x80\xAF", Units({ FFFD, FFFD, FFFD })));
+	CHECK(DecodesInvalid("\xE0\x9F\xBF", Units({ FFFD, FFFD, FFFD })));
+	CHECK(DecodesInvalid("\xF0\x80\x80\xAF", Units({ FFFD, FFFD, FFFD, FFFD })));
+	CHECK(DecodesInvalid("\xF0\x8F\xBF\xBF", Units({ FFFD, FFFD, FFFD, FFFD })));
+
+	// Ϊ UTF-8 Ĵ
+	CHECK(DecodesInvalid("\xED\xA0\x80", Units({ FFFD, FFFD, FFFD })));
+	CHECK(DecodesInvalid("\xED\xBF\xBF", Units({ FFFD, FFFD, FFFD })));
+	CHECK(DecodesInvalid("\xED\xA0\xBD\xED\xB8\x80", Units({ FFFD, FFFD, FFFD, FFFD, FFFD, FFFD })));
+
+	//  U+10FFFF
+	CHECK(DecodesInvalid("\xF4\x90\x80\x80", Units({ FFFD, FFFD, FFFD, FFFD })));
+
+	// ضϵֻ滻һΣַ֮ճ
+	CHECK(DecodesInvalid("\xE4\xB8", Units({ FFFD })));
+	CHECK(DecodesInvalid("\xE4\xB8" "A", Units({ FFFD, 'A' })));
+	CHECK(DecodesInvalid("\xF0\x9F\x98", Units({ FFFD })));
+	CHECK(DecodesInvalid("\xF0\x9F\x98\xE4\xB8\xAD", Units({ FFFD, 0x4E2D })));
+	CHECK(DecodesInvalid("\xC3", Units({ FFFD })));
+}
+
+// ɶԵĴͳΧĿַΪ U+FFFD
+static void TestInvalidWide()
+{
+	const std::string replacement = "\xEF\xBF\xBD";
+
+	CHECK(Encode(Units({ 0xD800 })) == replacement);
+	CHECK(Encode(Units({ 0xDC00, 'A' })) == replacement + "A");
+	CHECK(Encode(Units({ 'A', 0xDBFF })) == "A" + replacement);
+	CHECK(Encode(Units({ 0xDE00, 0xD83D })) == replacement + replacement);
+
+	if (sizeof(wchar_t) == 2)
+	{
+		// Ϊһַߴ治ǵʹʱ滻
+		CHECK(Encode(Units({ 0xD83D, 0xDE00 })) == "\xF0\x9F\x98\x80");
+		CHECK(Encode(Units({ 0xDBFF, 0xDFFF })) == "\xF4\x8F\xBF\xBF");
+		CHECK(Encode(Units({ 0xD83D, 'A', 0xDE00 })) == replacement + "A" + replacement);
+		CHECK(Encode(Units({ 0xD83D, 0xD83D, 0xDE00 })) == replacement + "\xF0\x9F\x98\x80");
+	}
+	else
+	{
+		// UTF-32 дܳɶ
+		CHECK(Encode(Units({ 0xD83D, 0xDE00 })) == replacement + replacement);
+		CHECK(Encode(Units({ 0x110000 })) == replacement);
+	}
+}
+
+// ڽϳ ASCII еĸλ÷ ASCII ַÿ 16 ֽڵĿ·ʣಿ
+static void TestAsciiRuns()
+{
+	for (size_t length = 0; length <= 80; length++)
+	{
+		for (size_t position = 0; position <= length; position++)
+		{
+			Units units;
+			std::string bytes;
+			for (size_t i = 0; i < length; i++)
+			{
+				unsigned int code = (i == position) ? 0x4E2D : static_cast<unsigned int>('a' + i % 26);
+				units.push_back(code);
+				bytes += ReferenceEncode(code);
+			}
+			CHECK(Encode(units) == bytes);
+			CHECK(Decode(bytes) == units);
+			CHECK(Utf8::isValid(bytes.data(), bytes.size()));
+
+			// ·֮Чֽܱͬ
+			std::string invalid = bytes;
+			invalid.insert(position, 1, '\x80');
+			CHECK(!Utf8::isValid(invalid.data(), invalid.size()));
+		}
+	}
+
+	// 0x7F  0x80 ֱλڿ·жϵ
+	std::string del(32, '\x7F');
+	CHECK(Utf8::isValid(del.data(), del.size()));
+	CHECK(Decode(del) == Units(32, 0x7F));
+	CHECK(Encode(Units(32, 0x7F)) == del);
+	CHECK(Encode(Units(32, 0x80)).size() == 64);
+	CHECK(Encode(Units(32, 0x100)).size() == 64);
+}
+
+
+int main()
+{
+	TestRoundTripAllCodePoints();
+	TestKnownSequences();
+	TestInvalidSequences();
+	TestInvalidWide();
+	TestAsciiRuns();
+	return CHECK_RESULT();
+}
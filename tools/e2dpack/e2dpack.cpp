@@ -0,0 +1,208 @@
+// e2dpackEasy2D Դ.e2dpߣ Windows  Linux ʹ
+//
+// ÷
+//   e2dpack pack [-lz4] Դ Ŀ¼     Ŀ¼µļļΪ·
+//   e2dpack list Դ                 гԴеļ
+//   e2dpack unpack Դ Ŀ¼          ԴеļĿ¼
+//
+//   -lz4   ʹ LZ4 ѹļѹûбСļ԰ԭ棩
+//
+// 루Ҫ C++17
+//   g++ -std=c++17 -O2 e2dpack.cpp ../../core/Tool/PackFile.cpp ../../core/Tool/Lz4.cpp -o e2dpack
+//   cl /std:c++17 /EHsc /O2 e2dpack.cpp ..\..\core\Tool\PackFile.cpp ..\..\core\Tool\Lz4.cpp
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "../../core/Tool/PackFile.h"
+
+namespace fs = std::filesystem;
+
+
+static bool ReadFile(const fs::path & path, std::vector<unsigned char> & data)
+{
+	std::ifstream in(path, std::ios::binary);
+	if (!in)
+		return false;
+
+	in.seekg(0, std::ios::end);
+	std::streamoff size = in.tellg();
+	in.seekg(0, std::ios::beg);
+	if (size < 0)
+		return false;
+
+	data.resize(size_t(size));
+	if (size > 0 && !in.read(reinterpret_cast<char *>(&data[0]), size))
+		return false;
+	return true;
+}
+
+static bool SaveFile(const fs::path & path, const unsigned char * data, size_t size)
+{
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	if (!out)
+		return false;
+	if (size > 0)
+		out.write(reinterpret_cast<const char *>(data), std::streamsize(size));
+	return bool(out.flush());
+}
+
+static int Usage()
+{
+	fprintf(stderr,
+		"usage: e2dpack pack [-lz4] <pack> <dir>\n"
+		"       e2dpack list <pack>\n"
+		"       e2dpack unpack <pack> <dir>\n");
+	return 1;
+}
+
+static int Pack(const fs::path & packPath, const fs::path & dir, bool compress)
+{
+	std::error_code ec;
+	if (!fs::is_directory(dir, ec))
+	{
+		fprintf(stderr, "e2dpack: %s is not a directory\n", dir.string().c_str());
+		return 1;
+	}
+
+	std::vector<std::vector<unsigned char> > contents;
+	std::vector<PackFile::Input> inputs;
+
+	for (fs::recursive_directory_iterator iter(dir, ec), end; !ec && iter != end; iter.increment(ec))
+	{
+		if (!iter->is_regular_file())
+			continue;
+
+		contents.push_back(std::vector<unsigned char>());
+		if (!ReadFile(iter->path(), contents.back()))
+		{
+			fprintf(stderr, "e2dpack: cannot read %s\n", iter->path().string().c_str());
+			return 1;
+		}
+
+		PackFile::Input input;
+		input.name = fs::relative(iter->path(), dir).generic_u8string();
+		input.compress = compress;
+		inputs.push_back(input);
+	}
+
+	if (ec)
+	{
+		fprintf(stderr, "e2dpack: %s\n", ec.message().c_str());
+		return 1;
+	}
+
+	for (size_t i = 0; i < inputs.size(); i++)
+	{
+		inputs[i].data = contents[i].empty() ? nullptr : &contents[i][0];
+		inputs[i].size = contents[i].size();
+	}
+
+	std::vector<unsigned char> pack;
+	if (!PackFile::build(inputs, pack))
+	{
+		fprintf(stderr, "e2dpack: duplicate or invalid file names\n");
+		return 1;
+	}
+
+	if (!SaveFile(packPath, &pack[0], pack.size()))
+	{
+		fprintf(stderr, "e2dpack: cannot write %s\n", packPath.string().c_str());
+		return 1;
+	}
+
+	printf("%s: %u files, %llu bytes\n", packPath.string().c_str(),
+		unsigned(inputs.size()), (unsigned long long)pack.size());
+	return 0;
+}
+
+static bool OpenPack(const fs::path & packPath, std::vector<unsigned char> & data, PackFile::View & view)
+{
+	if (!ReadFile(packPath, data) || data.empty() || !PackFile::parse(&data[0], data.size(), view))
+	{
+		fprintf(stderr, "e2dpack: %s is not a valid pack\n", packPath.string().c_str());
+		return false;
+	}
+	return true;
+}
+
+static int List(const fs::path & packPath)
+{
+	std::vector<unsigned char> data;
+	PackFile::View view;
+	if (!OpenPack(packPath, data, view))
+		return 1;
+
+	for (unsigned int i = 0; i < view.entryCount; i++)
+	{
+		PackFile::Entry entry;
+		PackFile::getEntry(view, i, entry);
+		printf("%12llu %12llu %s %.*s\n", entry.size, entry.storedSize,
+			PackFile::isCompressed(entry) ? "lz4" : "   ",
+			int(entry.nameLength), entry.name);
+	}
+	return 0;
+}
+
+static int Unpack(const fs::path & packPath, const fs::path & dir)
+{
+	std::vector<unsigned char> data;
+	PackFile::View view;
+	if (!OpenPack(packPath, data, view))
+		return 1;
+
+	for (unsigned int i = 0; i < view.entryCount; i++)
+	{
+		PackFile::Entry entry;
+		PackFile::getEntry(view, i, entry);
+
+		std::string name(entry.name, entry.nameLength);
+		fs::path path = dir / fs::u8path(name);
+		// ܾĿĿ¼֮
+		if (name.find("..") != std::string::npos || fs::u8path(name).is_absolute())
+		{
+			fprintf(stderr, "e2dpack: skipping unsafe name %s\n", name.c_str());
+			continue;
+		}
+
+		std::vector<unsigned char> content(size_t(entry.size));
+		if (!PackFile::extract(view, entry, content.empty() ? nullptr : &content[0], content.size()))
+		{
+			fprintf(stderr, "e2dpack: corrupt data for %s\n", name.c_str());
+			return 1;
+		}
+
+		std::error_code ec;
+		fs::create_directories(path.parent_path(), ec);
+		if (!SaveFile(path, content.empty() ? nullptr : &content[0], content.size()))
+		{
+			fprintf(stderr, "e2dpack: cannot write %s\n", path.string().c_str());
+			return 1;
+		}
+	}
+	return 0;
+}
+
+int main(int argc, char * argv[])
+{
+	if (argc >= 2 && strcmp(argv[1], "pack") == 0)
+	{
+		bool compress = argc >= 3 && strcmp(argv[2], "-lz4") == 0;
+		int first = compress ? 3 : 2;
+		if (argc != first + 2)
+			return Usage();
+		return Pack(argv[first], argv[first + 1], compress);
+	}
+	if (argc == 3 && strcmp(argv[1], "list") == 0)
+	{
+		return List(argv[2]);
+	}
+	if (argc == 4 && strcmp(argv[1], "unpack") == 0)
+	{
+		return Unpack(argv[2], argv[3]);
+	}
+	return Usage();
+}
@@ -0,0 +1,215 @@
+// e2dtex PNGJPEG ͼƬתΪ Easy2D Ԥļ.e2dt
+//
+// ÷
+//   e2dtex [-lz4] [-grid  ] [-frame x y  ]... ͼƬ ļ
+//
+//   -lz4     ʹ LZ4 ѹ
+//   -grid    ͼƬȷΪ  x  ֡У
+//   -frame   һ֡ظʹ
+//
+// 루VS Աʾ
+//   cl /EHsc /O2 e2dtex.cpp ..\..\core\Tool\TextureFile.cpp ..\..\core\Tool\Lz4.cpp
+
+#include <Windows.h>
+#include <wincodec.h>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "..\..\core\Tool\TextureFile.h"
+#pragma comment(lib, "windowscodecs.lib")
+#pragma comment(lib, "ole32.lib")
+
+
+template<class Interface>
+inline void SafeReleaseInterface(Interface **ppInterface)
+{
+	if (*ppInterface != nullptr)
+	{
+		(*ppInterface)->Release();
+		(*ppInterface) = nullptr;
+	}
+}
+
+// ʹ WIC ͼƬԤ Alpha  BGRA 
+static HRESULT DecodeImage(
+	LPCWSTR fileName,
+	UINT & width,
+	UINT & height,
+	std::vector<unsigned char> & pixels
+)
+{
+	IWICImagingFactory *pFactory = nullptr;
+	IWICBitmapDecoder *pDecoder = nullptr;
+	IWICBitmapFrameDecode *pSource = nullptr;
+	IWICFormatConverter *pConverter = nullptr;
+
+	HRESULT hr = CoCreateInstance(
+		CLSID_WICImagingFactory,
+		NULL,
+		CLSCTX_INPROC_SERVER,
+		IID_IWICImagingFactory,
+		reinterpret_cast<void**>(&pFactory)
+	);
+
+	if (SUCCEEDED(hr))
+	{
+		hr = pFactory->CreateDecoderFromFilename(
+			fileName,
+			NULL,
+			GENERIC_READ,
+			WICDecodeMetadataCacheOnLoad,
+			&pDecoder
+		);
+	}
+	if (SUCCEEDED(hr))
+	{
+		hr = pDecoder->GetFrame(0, &pSource);
+	}
+	if (SUCCEEDED(hr))
+	{
+		hr = pFactory->CreateFormatConverter(&pConverter);
+	}
+	if (SUCCEEDED(hr))
+	{
+		//  ETexture ʹͬظʽ
+		hr = pConverter->Initialize(
+			pSource,
+			GUID_WICPixelFormat32bppPBGRA,
+			WICBitmapDitherTypeNone,
+			NULL,
+			0.f,
+			WICBitmapPaletteTypeMedianCut
+		);
+	}
+	if (SUCCEEDED(hr))
+	{
+		hr = pConverter->GetSize(&width, &height);
+	}
+	if (SUCCEEDED(hr))
+	{
+		pixels.resize(size_t(width) * height * 4);
+		hr = pConverter->CopyPixels(NULL, width * 4, static_cast<UINT>(pixels.size()), &pixels[0]);
+	}
+
+	SafeReleaseInterface(&pConverter);
+	SafeReleaseInterface(&pSource);
+	SafeReleaseInterface(&pDecoder);
+	SafeReleaseInterface(&pFactory);
+
+	return hr;
+}
+
+static bool SaveFile(LPCWSTR fileName, const std::vector<unsigned char> & data)
+{
+	FILE * fp = nullptr;
+	if (_wfopen_s(&fp, fileName, L"wb") != 0 || !fp)
+		return false;
+
+	bool ok = fwrite(&data[0], 1, data.size(), fp) == data.size();
+	ok = (fclose(fp) == 0) && ok;
+	return ok;
+}
+
+static int Usage()
+{
+	fwprintf(stderr, L"usage: e2dtex [-lz4] [-grid cols rows] [-frame x y w h]... input output\n");
+	return 1;
+}
+
+int wmain(int argc, wchar_t * argv[])
+{
+	bool compress = false;
+	UINT gridCols = 0, gridRows = 0;
+	std::vector<TextureFile::Frame> frames;
+	LPCWSTR input = nullptr;
+	LPCWSTR output = nullptr;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (wcscmp(argv[i], L"-lz4") == 0)
+		{
+			compress = true;
+		}
+		else if (wcscmp(argv[i], L"-grid") == 0 && i + 2 < argc)
+		{
+			gridCols = wcstoul(argv[++i], nullptr, 10);
+			gridRows = wcstoul(argv[++i], nullptr, 10);
+			if (gridCols == 0 || gridRows == 0)
+				return Usage();
+		}
+		else if (wcscmp(argv[i], L"-frame") == 0 && i + 4 < argc)
+		{
+			TextureFile::Frame frame;
+			frame.x = wcstoul(argv[++i], nullptr, 10);
+			frame.y = wcstoul(argv[++i], nullptr, 10);
+			frame.width = wcstoul(argv[++i], nullptr, 10);
+			frame.height = wcstoul(argv[++i], nullptr, 10);
+			frames.push_back(frame);
+		}
+		else if (!input)
+		{
+			input = argv[i];
+		}
+		else if (!output)
+		{
+			output = argv[i];
+		}
+		else
+		{
+			return Usage();
+		}
+	}
+
+	if (!input || !output)
+		return Usage();
+
+	CoInitialize(NULL);
+
+	UINT width = 0, height = 0;
+	std::vector<unsigned char> pixels;
+	HRESULT hr = DecodeImage(input, width, height, pixels);
+
+	CoUninitialize();
+
+	if (FAILED(hr))
+	{
+		fwprintf(stderr, L"e2dtex: cannot decode %s (0x%08X)\n", input, static_cast<unsigned int>(hr));
+		return 1;
+	}
+
+	if (gridCols)
+	{
+		UINT frameWidth = width / gridCols;
+		UINT frameHeight = height / gridRows;
+		for (UINT row = 0; row < gridRows; row++)
+		{
+			for (UINT col = 0; col < gridCols; col++)
+			{
+				TextureFile::Frame frame = { col * frameWidth, row * frameHeight, frameWidth, frameHeight };
+				frames.push_back(frame);
+			}
+		}
+	}
+
+	std::vector<unsigned char> file;
+	if (!TextureFile::encode(width, height, width * 4, &pixels[0], frames, compress, file))
+	{
+		fwprintf(stderr, L"e2dtex: invalid image or frame out of bounds\n");
+		return 1;
+	}
+
+	if (!SaveFile(output, file))
+	{
+		fwprintf(stderr, L"e2dtex: cannot write %s\n", output);
+		return 1;
+	}
+
+	TextureFile::View view;
+	TextureFile::parse(&file[0], file.size(), view);
+	wprintf(L"%s: %ux%u, %u frames, %u bytes%s\n",
+		output, width, height,
+		static_cast<unsigned int>(frames.size()),
+		static_cast<unsigned int>(file.size()),
+		TextureFile::isCompressed(view) ? L", lz4" : L"");
+	return 0;
+}